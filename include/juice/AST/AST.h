@@ -12,13 +12,13 @@
 #ifndef JUICE_AST_AST_H
 #define JUICE_AST_AST_H
 
-#include <memory>
-#include <vector>
+#include <cstddef>
 
+#include "ASTContext.h"
 #include "juice/Basic/RawStreamHelpers.h"
 #include "juice/Basic/SourceLocation.h"
 #include "juice/Diagnostics/Diagnostics.h"
-#include "juice/Parser/LexerToken.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace juice {
     namespace sema {
@@ -42,22 +42,29 @@ namespace juice {
         public:
             virtual ~AST() = default;
 
-            virtual basic::SourceLocation getLocation() const = 0;
+            void * operator new(size_t size, ASTContext & context) { return context.allocateNode(size, alignof(AST)); }
+            void operator delete(void *, ASTContext &) {}
 
-            virtual void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const = 0;
+            void * operator new(size_t) = delete;
+            void operator delete(void *) {}
+
+            virtual basic::SourceLocation getLocation(const ASTContext & context) const = 0;
+
+            virtual void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                      unsigned int level) const = 0;
         };
 
 
         class ContainerAST: public AST {
         protected:
-            std::vector<std::unique_ptr<StatementAST>> _statements;
+            llvm::ArrayRef<StatementAST *> _statements;
 
         public:
             ContainerAST() = default;
 
-            basic::SourceLocation getLocation() const override;
+            basic::SourceLocation getLocation(const ASTContext & context) const override;
 
-            void appendStatement(std::unique_ptr<StatementAST> statement);
+            void setStatements(llvm::ArrayRef<StatementAST *> statements) { _statements = statements; }
         };
 
         class ModuleAST: public ContainerAST {
@@ -68,26 +75,28 @@ namespace juice {
 
             ~ModuleAST() override = default;
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
         };
 
         class BlockAST: public ContainerAST {
-            std::unique_ptr<parser::LexerToken> _start;
+            size_t _start;
 
             friend class sema::TypeCheckedBlockAST;
 
         public:
             BlockAST() = delete;
 
-            explicit BlockAST(std::unique_ptr<parser::LexerToken> start);
+            explicit BlockAST(size_t start);
 
             ~BlockAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_start->string.begin());
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return context.getLocation(_start);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
         };
 
 
@@ -97,12 +106,12 @@ namespace juice {
                 expression
             };
 
-            std::unique_ptr<parser::LexerToken> _keyword;
+            size_t _keyword;
 
             Kind _kind;
             union {
-                std::unique_ptr<BlockAST> _block;
-                std::unique_ptr<ExpressionAST> _expression;
+                BlockAST * _block;
+                ExpressionAST * _expression;
             };
 
             friend class sema::TypeCheckedControlFlowBodyAST;
@@ -110,19 +119,20 @@ namespace juice {
         public:
             ControlFlowBodyAST() = delete;
 
-            ControlFlowBodyAST(std::unique_ptr<parser::LexerToken> keyword, std::unique_ptr<BlockAST> block);
-            ControlFlowBodyAST(std::unique_ptr<parser::LexerToken> keyword, std::unique_ptr<ExpressionAST> expression);
+            ControlFlowBodyAST(size_t keyword, BlockAST * block);
+            ControlFlowBodyAST(size_t keyword, ExpressionAST * expression);
 
-            ~ControlFlowBodyAST() override;
+            ~ControlFlowBodyAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_keyword->string.begin());
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return context.getLocation(_keyword);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
-            const std::unique_ptr<parser::LexerToken> & getKeyword() const { return _keyword; }
+            size_t getKeyword() const { return _keyword; }
         };
     }
 }
@@ -0,0 +1,95 @@
+// include/juice/AST/ASTContext.h - ASTContext class, owns the tokens and AST nodes of a module
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_AST_ASTCONTEXT_H
+#define JUICE_AST_ASTCONTEXT_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "juice/Basic/SourceLocation.h"
+#include "juice/Parser/LexerToken.h"
+#include "juice/Parser/TokenBuffer.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+
+namespace juice {
+    namespace ast {
+        // Owns the tokens of a module together with all parsed and type-checked nodes, which refer to their tokens by
+        // index. Nodes are bump-allocated (see the placement operator new of ast::AST, ast::TypeRepr and
+        // sema::TypeCheckedAST) and never destroyed individually, so the whole tree is released at once together with
+        // the context. A node that owns heap memory nonetheless has to be registered with addDestruction.
+        class ASTContext {
+            parser::TokenBuffer _tokens;
+
+            llvm::BumpPtrAllocator _allocator;
+            size_t _nodeCount = 0;
+            std::vector<std::pair<void (*)(void *), void *>> _destructions;
+
+        public:
+            ASTContext() = delete;
+            ASTContext(const ASTContext &) = delete;
+            ASTContext & operator=(const ASTContext &) = delete;
+
+            explicit ASTContext(parser::TokenBuffer tokens);
+
+            ~ASTContext();
+
+
+            const parser::TokenBuffer & getTokens() const { return _tokens; }
+
+            parser::LexerToken getToken(size_t index) const { return _tokens.getToken(index); }
+            llvm::StringRef getString(size_t index) const { return _tokens.getString(index); }
+
+            basic::SourceLocation getLocation(size_t index) const {
+                return basic::SourceLocation(_tokens.getStart(index));
+            }
+
+
+            void * allocate(size_t size, size_t alignment) { return _allocator.Allocate(size, alignment); }
+
+            void * allocateNode(size_t size, size_t alignment) {
+                ++_nodeCount;
+                return allocate(size, alignment);
+            }
+
+            template <typename T>
+            llvm::ArrayRef<T> copy(llvm::ArrayRef<T> array) {
+                if (array.empty()) return {};
+
+                T * elements = static_cast<T *>(allocate(sizeof(T) * array.size(), alignof(T)));
+                std::uninitialized_copy(array.begin(), array.end(), elements);
+
+                return llvm::ArrayRef<T>(elements, array.size());
+            }
+
+            template <typename T>
+            llvm::ArrayRef<T> copy(const llvm::SmallVectorImpl<T> & vector) {
+                return copy(llvm::ArrayRef<T>(vector));
+            }
+
+            template <typename T>
+            void addDestruction(T * object) {
+                _destructions.emplace_back([](void * pointer) { static_cast<T *>(pointer)->~T(); }, object);
+            }
+
+            size_t getBytesAllocated() const { return _allocator.getBytesAllocated(); }
+            // The number of parsed and type-checked nodes allocated so far.
+            size_t getNodeCount() const { return _nodeCount; }
+        };
+    }
+}
+
+#endif //JUICE_AST_ASTCONTEXT_H
@@ -11,12 +11,12 @@
 #ifndef JUICE_AST_DECLARATIONAST_H
 #define JUICE_AST_DECLARATIONAST_H
 
-#include <memory>
+#include <cstddef>
 
+#include "ASTContext.h"
 #include "ExpressionAST.h"
 #include "StatementAST.h"
 #include "TypeRepr.h"
-#include "juice/Parser/LexerToken.h"
 
 namespace juice {
     namespace sema {
@@ -41,27 +41,27 @@ namespace juice {
         };
 
         class VariableDeclarationAST: public DeclarationAST {
-            std::unique_ptr<parser::LexerToken> _keyword, _name;
-            std::unique_ptr<TypeRepr> _typeAnnotation;
+            size_t _keyword, _name;
+            TypeRepr * _typeAnnotation;
             bool _isMutable;
-            std::unique_ptr<ExpressionAST> _initialization;
+            ExpressionAST * _initialization;
 
             friend class sema::TypeCheckedVariableDeclarationAST;
 
         public:
             VariableDeclarationAST() = delete;
 
-            VariableDeclarationAST(std::unique_ptr<parser::LexerToken> keyword,
-                                   std::unique_ptr<parser::LexerToken> name, std::unique_ptr<TypeRepr> typeAnnotation,
-                                   bool isMutable, std::unique_ptr<ExpressionAST> initialization);
+            VariableDeclarationAST(size_t keyword, size_t name, TypeRepr * typeAnnotation, bool isMutable,
+                                   ExpressionAST * initialization);
 
             ~VariableDeclarationAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_keyword->string.begin());
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return context.getLocation(_keyword);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const StatementAST * ast) {
@@ -12,13 +12,14 @@
 #ifndef JUICE_AST_EXPRESSIONAST_H
 #define JUICE_AST_EXPRESSIONAST_H
 
-#include <memory>
+#include <cstddef>
 #include <utility>
-#include <vector>
 
 #include "AST.h"
-#include "juice/Parser/LexerToken.h"
+#include "ASTContext.h"
 #include "juice/Diagnostics/Diagnostics.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace juice {
     namespace sema {
@@ -48,34 +49,34 @@ namespace juice {
             const Kind _kind;
 
         protected:
-            std::unique_ptr<parser::LexerToken> _token;
+            size_t _token;
 
         public:
             ExpressionAST() = delete;
 
-            ExpressionAST(Kind kind, std::unique_ptr<parser::LexerToken> token);
+            ExpressionAST(Kind kind, size_t token);
 
             ~ExpressionAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_token->string.begin());
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return context.getLocation(_token);
             }
 
             Kind getKind() const { return _kind; }
         };
 
         class BinaryOperatorExpressionAST: public ExpressionAST {
-            std::unique_ptr<ExpressionAST> _left, _right;
+            ExpressionAST * _left, * _right;
 
             friend class sema::TypeCheckedBinaryOperatorExpressionAST;
 
         public:
             BinaryOperatorExpressionAST() = delete;
 
-            BinaryOperatorExpressionAST(std::unique_ptr<parser::LexerToken> token, std::unique_ptr<ExpressionAST> left,
-                                        std::unique_ptr<ExpressionAST> right);
+            BinaryOperatorExpressionAST(size_t token, ExpressionAST * left, ExpressionAST * right);
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const ExpressionAST * ast) {
@@ -84,16 +85,17 @@ namespace juice {
         };
 
         class IntegerLiteralExpressionAST: public ExpressionAST {
-            int64_t _value;
+            llvm::APInt _value;
 
             friend class sema::TypeCheckedIntegerLiteralExpressionAST;
 
         public:
             IntegerLiteralExpressionAST() = delete;
 
-            IntegerLiteralExpressionAST(std::unique_ptr<parser::LexerToken> token, int64_t value);
+            IntegerLiteralExpressionAST(size_t token, llvm::APInt value);
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const ExpressionAST * ast) {
@@ -109,9 +111,10 @@ namespace juice {
         public:
             FloatingPointLiteralExpressionAST() = delete;
 
-            FloatingPointLiteralExpressionAST(std::unique_ptr<parser::LexerToken> token, double value);
+            FloatingPointLiteralExpressionAST(size_t token, double value);
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const ExpressionAST * ast) {
@@ -127,9 +130,10 @@ namespace juice {
         public:
             BooleanLiteralExpressionAST() = delete;
 
-            BooleanLiteralExpressionAST(std::unique_ptr<parser::LexerToken> token, bool value);
+            BooleanLiteralExpressionAST(size_t token, bool value);
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const ExpressionAST * ast) {
@@ -143,11 +147,12 @@ namespace juice {
         public:
             VariableExpressionAST() = delete;
 
-            explicit VariableExpressionAST(std::unique_ptr<parser::LexerToken> token);
+            explicit VariableExpressionAST(size_t token);
 
-            llvm::StringRef name() const { return _token->string; }
+            llvm::StringRef name(const ASTContext & context) const { return context.getString(_token); }
 
-            void diagnoseInto(diag::DiagnosticEngine &diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const ExpressionAST * ast) {
@@ -156,16 +161,17 @@ namespace juice {
         };
 
         class GroupingExpressionAST: public ExpressionAST {
-            std::unique_ptr<ExpressionAST> _expression;
+            ExpressionAST * _expression;
 
             friend class sema::TypeCheckedGroupingExpressionAST;
 
         public:
             GroupingExpressionAST() = delete;
 
-            GroupingExpressionAST(std::unique_ptr<parser::LexerToken> token, std::unique_ptr<ExpressionAST> expression);
+            GroupingExpressionAST(size_t token, ExpressionAST * expression);
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const ExpressionAST * ast) {
@@ -175,14 +181,13 @@ namespace juice {
 
         class IfExpressionAST: public ExpressionAST {
         public:
-            typedef std::vector<std::pair<std::unique_ptr<ExpressionAST>,
-                                          std::unique_ptr<ControlFlowBodyAST>>> ElifVector;
+            typedef std::pair<ExpressionAST *, ControlFlowBodyAST *> ElifConditionAndBody;
 
         private:
-            std::unique_ptr<ExpressionAST> _ifCondition;
-            std::unique_ptr<ControlFlowBodyAST> _ifBody;
-            ElifVector _elifConditionsAndBodies;
-            std::unique_ptr<ControlFlowBodyAST> _elseBody;
+            ExpressionAST * _ifCondition;
+            ControlFlowBodyAST * _ifBody;
+            llvm::ArrayRef<ElifConditionAndBody> _elifConditionsAndBodies;
+            ControlFlowBodyAST * _elseBody;
             bool _isStatement;
 
             friend class IfStatementAST;
@@ -191,15 +196,16 @@ namespace juice {
         public:
             IfExpressionAST() = delete;
 
-            IfExpressionAST(std::unique_ptr<ExpressionAST> ifCondition, std::unique_ptr<ControlFlowBodyAST> ifBody,
-                            ElifVector && elifConditionsAndBodies, std::unique_ptr<ControlFlowBodyAST> elseBody,
+            IfExpressionAST(ExpressionAST * ifCondition, ControlFlowBodyAST * ifBody,
+                            llvm::ArrayRef<ElifConditionAndBody> elifConditionsAndBodies, ControlFlowBodyAST * elseBody,
                             bool isStatement);
 
-            basic::SourceLocation getLocation() const override {
-                return _ifBody->getLocation();
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return _ifBody->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const ExpressionAST * ast) {
@@ -12,9 +12,8 @@
 #ifndef JUICE_AST_STATEMENTAST_H
 #define JUICE_AST_STATEMENTAST_H
 
-#include <memory>
-
 #include "AST.h"
+#include "ASTContext.h"
 #include "ExpressionAST.h"
 
 namespace juice {
@@ -53,22 +52,23 @@ namespace juice {
         };
 
         class BlockStatementAST: public StatementAST {
-            std::unique_ptr<BlockAST> _block;
+            BlockAST * _block;
 
             friend class sema::TypeCheckedBlockStatementAST;
 
         public:
             BlockStatementAST() = delete;
 
-            explicit BlockStatementAST(std::unique_ptr<BlockAST> block);
+            explicit BlockStatementAST(BlockAST * block);
 
             ~BlockStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _block->getLocation();
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return _block->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const StatementAST * ast) {
@@ -77,22 +77,23 @@ namespace juice {
         };
 
         class ExpressionStatementAST: public StatementAST {
-            std::unique_ptr<ExpressionAST> _expression;
+            ExpressionAST * _expression;
 
             friend class sema::TypeCheckedExpressionStatementAST;
 
         public:
             ExpressionStatementAST() = delete;
 
-            explicit ExpressionStatementAST(std::unique_ptr<ExpressionAST> expression);
+            explicit ExpressionStatementAST(ExpressionAST * expression);
 
             ~ExpressionStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _expression->getLocation();
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return _expression->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const StatementAST * ast) {
@@ -101,22 +102,23 @@ namespace juice {
         };
 
         class IfStatementAST: public StatementAST {
-            std::unique_ptr<IfExpressionAST> _ifExpression;
+            IfExpressionAST * _ifExpression;
 
             friend class sema::TypeCheckedIfStatementAST;
 
         public:
             IfStatementAST() = delete;
 
-            explicit IfStatementAST(std::unique_ptr<IfExpressionAST> ifExpression);
+            explicit IfStatementAST(IfExpressionAST * ifExpression);
 
             ~IfStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _ifExpression->getLocation();
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return _ifExpression->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const StatementAST * ast) {
@@ -125,23 +127,24 @@ namespace juice {
         };
 
         class WhileStatementAST: public StatementAST {
-            std::unique_ptr<ExpressionAST> _condition;
-            std::unique_ptr<ControlFlowBodyAST> _body;
+            ExpressionAST * _condition;
+            ControlFlowBodyAST * _body;
 
             friend class sema::TypeCheckedWhileStatementAST;
 
         public:
             WhileStatementAST() = delete;
 
-            WhileStatementAST(std::unique_ptr<ExpressionAST> condition, std::unique_ptr<ControlFlowBodyAST> body);
+            WhileStatementAST(ExpressionAST * condition, ControlFlowBodyAST * body);
 
             ~WhileStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _body->getLocation();
+            basic::SourceLocation getLocation(const ASTContext & context) const override {
+                return _body->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
 
             static bool classof(const StatementAST * ast) {
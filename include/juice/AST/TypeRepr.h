@@ -12,9 +12,9 @@
 #ifndef JUICE_AST_TYPEREPR_H
 #define JUICE_AST_TYPEREPR_H
 
-#include <memory>
+#include <cstddef>
 
-#include "juice/Parser/LexerToken.h"
+#include "ASTContext.h"
 #include "juice/Sema/Type.h"
 #include "juice/Sema/TypeChecker.h"
 #include "llvm/ADT/StringRef.h"
@@ -42,27 +42,36 @@ namespace juice {
 
             virtual ~TypeRepr() = default;
 
+            void * operator new(size_t size, ASTContext & context) {
+                return context.allocateNode(size, alignof(TypeRepr));
+            }
+            void operator delete(void *, ASTContext &) {}
+
+            void * operator new(size_t) = delete;
+            void operator delete(void *) {}
+
 
             virtual llvm::Expected<sema::Type> resolve(const sema::TypeChecker::State & state) const = 0;
 
+            virtual llvm::StringRef getSpelling(const ASTContext & context) const = 0;
+
 
             Kind getKind() const { return _kind; }
         };
 
         class IdentifierTypeRepr: public TypeRepr {
-            std::unique_ptr<parser::LexerToken> _token;
+            size_t _token;
 
         public:
-            explicit IdentifierTypeRepr(std::unique_ptr<parser::LexerToken> token);
+            explicit IdentifierTypeRepr(size_t token);
 
             IdentifierTypeRepr(const IdentifierTypeRepr &) = delete;
             void operator=(const IdentifierTypeRepr &) = delete;
 
 
-            llvm::Expected<sema::Type> resolve(const sema::TypeChecker::State &state) const override;
-
+            llvm::Expected<sema::Type> resolve(const sema::TypeChecker::State & state) const override;
 
-            llvm::StringRef name() const { return _token->string; }
+            llvm::StringRef getSpelling(const ASTContext & context) const override { return context.getString(_token); }
 
 
             static bool classof(const TypeRepr * type) {
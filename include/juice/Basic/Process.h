@@ -12,6 +12,7 @@
 #ifndef JUICE_BASIC_PROCESS_H
 #define JUICE_BASIC_PROCESS_H
 
+#include <cstddef>
 #include <string>
 
 #include "llvm/ADT/StringRef.h"
@@ -19,6 +20,9 @@
 namespace juice {
     namespace basic {
         std::string getMainExecutablePath(const char * firstArgument);
+
+        // Returns the maximum resident set size of the process so far in bytes, or 0 if it is unknown.
+        size_t getPeakMemoryUsage();
     }
 }
 
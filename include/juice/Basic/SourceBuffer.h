@@ -12,9 +12,11 @@
 #ifndef JUICE_BASIC_SOURCEBUFFER_H
 #define JUICE_BASIC_SOURCEBUFFER_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -27,14 +29,23 @@ namespace juice {
             llvm::StringRef _filename;
             bool _deleteBuffer;
 
+            // The offsets of the first characters of all lines. Built when the buffer is created, so that lookups
+            // never modify the buffer and may happen on several threads at once.
+            std::vector<uint32_t> _lineStarts;
+
+            size_t getLineIndex(SourceLocation location) const;
+
+            // Like llvm::SourceMgr, only line feeds start a new line, but columns are counted from a carriage return
+            // as well.
+            const char * getColumnStart(size_t lineIndex, SourceLocation location) const;
+
         public:
             SourceBuffer() = delete;
             SourceBuffer(const SourceBuffer &) = delete;
 
             SourceBuffer & operator=(const SourceBuffer &) = delete;
 
-            SourceBuffer(const char * start, const char * end, llvm::StringRef filename, bool deleteBuffer):
-                    _start(start), _end(end), _filename(filename), _deleteBuffer(deleteBuffer) {}
+            SourceBuffer(const char * start, const char * end, llvm::StringRef filename, bool deleteBuffer);
 
             ~SourceBuffer();
 
@@ -45,6 +56,13 @@ namespace juice {
             llvm::StringRef getString() const { return {getStart(), getSize()}; }
 
             llvm::StringRef getFilename() const { return _filename; }
+
+            // Both the line and the column start at 1, like in llvm::SourceMgr. Finds the line by a binary search
+            // in the line table instead of scanning the buffer.
+            std::pair<unsigned int, unsigned int> getLineAndColumn(SourceLocation location) const;
+
+            // The line containing `location`, without its line break, as llvm::SourceMgr prints it.
+            llvm::StringRef getLine(SourceLocation location) const;
         };
     }
 }
@@ -20,6 +20,7 @@
 #include "juice/Basic/SourceBuffer.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/SourceMgr.h"
 
 namespace juice {
@@ -40,6 +41,8 @@ namespace juice {
             SourceManager & operator=(const SourceManager &) = delete;
 
             static std::unique_ptr<SourceManager> mainFile(llvm::StringRef filename);
+            // Copies `contents` into a buffer that is reported as `name` in diagnostics, e.g. a line of REPL input.
+            static std::unique_ptr<SourceManager> mainString(llvm::StringRef contents, llvm::StringRef name);
 
             llvm::SourceMgr & getLLVMSourceMgr() {
                 return _sourceMgr;
@@ -53,15 +56,18 @@ namespace juice {
                 return _mainBuffer;
             }
 
+            // The main buffer is the only buffer, so locations are looked up in its line table instead of the one that
+            // llvm::SourceMgr would build by scanning the buffer again.
             unsigned int getLineNumber(SourceLocation location) const {
-                return _sourceMgr.FindLineNumber(location.llvm());
+                return _mainBuffer->getLineAndColumn(location).first;
             }
 
             std::pair<unsigned int, unsigned int> getLineAndColumn(SourceLocation location) const {
-                return _sourceMgr.getLineAndColumn(location.llvm());
+                return _mainBuffer->getLineAndColumn(location);
             }
 
-            void printDiagnostic(llvm::Twine message, diag::DiagnosticKind kind, SourceLocation location);
+            void printDiagnostic(llvm::raw_ostream & os, llvm::Twine message, diag::DiagnosticKind kind,
+                                 SourceLocation location);
         };
     }
 }
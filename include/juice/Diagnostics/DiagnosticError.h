@@ -14,10 +14,11 @@
 
 #include <memory>
 #include <utility>
-#include <vector>
 
 #include "Diagnostics.h"
 #include "juice/Basic/SourceLocation.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Error.h"
 
 namespace juice {
@@ -25,22 +26,20 @@ namespace juice {
         class DiagnosticError: public llvm::ErrorInfo<DiagnosticError> {
             basic::SourceLocation _location;
             diag::DiagnosticID _diagnosticID;
-            std::vector<DiagnosticArg> _args;
+            llvm::SmallVector<DiagnosticArg, 4> _args;
 
         public:
             static const char ID;
 
             DiagnosticError() = delete;
 
-            DiagnosticError(basic::SourceLocation location, DiagnosticID diagnosticID, std::vector<DiagnosticArg> args);
+            DiagnosticError(basic::SourceLocation location, DiagnosticID diagnosticID, llvm::ArrayRef<DiagnosticArg> args);
 
             template<typename... Args>
             static std::unique_ptr<DiagnosticError>
             create(basic::SourceLocation location, DiagnosticID diagnosticID, Args... args) {
-                std::vector<DiagnosticArg> vector;
-                DiagnosticArg::getAllInto(vector, args...);
-
-                return std::make_unique<DiagnosticError>(location, diagnosticID, std::move(vector));
+                return std::unique_ptr<DiagnosticError>(
+                    new DiagnosticError(location, diagnosticID, {DiagnosticArg(args)...}));
             }
 
 
@@ -49,7 +48,7 @@ namespace juice {
 
             basic::SourceLocation getLocation() const { return _location; }
             diag::DiagnosticID getDiagnosticID() const { return _diagnosticID; }
-            const std::vector<DiagnosticArg> & getArgs() const { return _args; }
+            llvm::ArrayRef<DiagnosticArg> getArgs() const { return _args; }
 
             void log(llvm::raw_ostream & os) const override {
                 os << "DiagnosticError";
@@ -62,29 +61,29 @@ namespace juice {
 
         class StaticDiagnosticError: public llvm::ErrorInfo<StaticDiagnosticError> {
             diag::DiagnosticID _diagnosticID;
-            std::vector<DiagnosticArg> _args;
+            llvm::SmallVector<DiagnosticArg, 4> _args;
 
         public:
             static const char ID;
 
             StaticDiagnosticError() = delete;
 
-            StaticDiagnosticError(DiagnosticID diagnosticID, std::vector<DiagnosticArg> args);
+            StaticDiagnosticError(DiagnosticID diagnosticID, llvm::ArrayRef<DiagnosticArg> args);
 
             template<typename... Args>
             static std::unique_ptr<StaticDiagnosticError> create(DiagnosticID diagnosticID, Args... args) {
-                std::vector<DiagnosticArg> vector;
-                DiagnosticArg::getAllInto(vector, args...);
-
-                return std::make_unique<StaticDiagnosticError>(diagnosticID, std::move(vector));
+                return std::unique_ptr<StaticDiagnosticError>(
+                    new StaticDiagnosticError(diagnosticID, {DiagnosticArg(args)...}));
             }
 
 
             void diagnose() const;
 
+            void diagnose(DiagnosticSink & sink) const;
+
 
             diag::DiagnosticID getDiagnosticID() const { return _diagnosticID; }
-            const std::vector<DiagnosticArg> & getArgs() const { return _args; }
+            llvm::ArrayRef<DiagnosticArg> getArgs() const { return _args; }
 
             void log(llvm::raw_ostream & os) const override {
                 os << "StaticDiagnosticError";
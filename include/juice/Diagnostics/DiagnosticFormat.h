@@ -0,0 +1,208 @@
+// include/juice/Diagnostics/DiagnosticFormat.h - Compiles diagnostic texts into format segments at compile time
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_DIAG_DIAGNOSTICFORMAT_H
+#define JUICE_DIAG_DIAGNOSTICFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace juice {
+    namespace diag {
+        // One step of formatting a diagnostic text. The segments of a text are formatted in order, except for the
+        // bodies of %select and %if, which directly follow their segment and are skipped using its length.
+        struct FormatSegment {
+            enum class Kind: uint8_t {
+                // Prints `length` characters of the text, starting at `offset`.
+                text,
+                // %0: Prints the argument.
+                argument,
+                // %indent0: Prints four spaces for every level given by the integer argument.
+                indent,
+                // %s0: Prints an 's', unless the integer argument is 1.
+                plural,
+                // %select{a|b}0: Followed by `length` segments, which are an alternative segment and its body for
+                // every choice. Only the body of the choice given by the integer argument is formatted.
+                select,
+                // Followed by `length` segments, which are the body of a %select choice.
+                alternative,
+                // %if{a}0: Followed by `length` segments, which are only formatted if the boolean argument is true.
+                condition,
+                // %reset: Resets the color of the text to bold.
+                reset
+            };
+
+            Kind kind = Kind::text;
+            uint8_t argIndex = 0;
+            uint16_t offset = 0;
+            uint16_t length = 0;
+        };
+
+
+        // Not constexpr, so that using it while compiling a diagnostic text makes the build fail.
+        inline void invalidDiagnosticText(const char * /* reason */) {}
+
+        // Compiles a diagnostic text into format segments, so that formatting a diagnostic doesn't have to parse its
+        // text again. It is only meant to be used in constant expressions, where a malformed text is a compile error.
+        class DiagnosticFormatCompiler {
+            const char * _text;
+            FormatSegment * _segments;
+
+            size_t _position = 0;
+            size_t _count = 0;
+
+        public:
+            // If `segments` is nullptr, the segments are only counted.
+            constexpr DiagnosticFormatCompiler(const char * text, FormatSegment * segments):
+                _text(text), _segments(segments) {}
+
+            // Returns the number of segments of the text.
+            constexpr size_t compile() {
+                compileUntil('\0', '\0');
+
+                return _count;
+            }
+
+        private:
+            static constexpr bool isAlpha(char c) {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            }
+
+            static constexpr bool isDigit(char c) {
+                return c >= '0' && c <= '9';
+            }
+
+            constexpr bool isModifier(size_t start, const char * name) const {
+                size_t i = 0;
+                for (; name[i] != '\0'; ++i) {
+                    if (start + i >= _position || _text[start + i] != name[i]) return false;
+                }
+
+                return start + i == _position;
+            }
+
+            constexpr size_t add(FormatSegment::Kind kind, size_t offset = 0, size_t length = 0) {
+                if (offset > UINT16_MAX || length > UINT16_MAX) invalidDiagnosticText("text is too long");
+
+                if (_segments) {
+                    _segments[_count].kind = kind;
+                    _segments[_count].offset = (uint16_t)offset;
+                    _segments[_count].length = (uint16_t)length;
+                }
+
+                return _count++;
+            }
+
+            // Sets the length of the segment at `index` to the number of segments that were added after it.
+            constexpr void endBody(size_t index) {
+                if (_count - index - 1 > UINT16_MAX) invalidDiagnosticText("modifier body is too long");
+
+                if (_segments) _segments[index].length = (uint16_t)(_count - index - 1);
+            }
+
+            constexpr void addText(size_t start, size_t end) {
+                if (end > start) add(FormatSegment::Kind::text, start, end - start);
+            }
+
+            constexpr void consume(char c) {
+                if (_text[_position] != c) invalidDiagnosticText("unexpected character in modifier");
+
+                ++_position;
+            }
+
+            constexpr void compileArgIndex(size_t index) {
+                if (!isDigit(_text[_position])) invalidDiagnosticText("missing argument index");
+
+                size_t argIndex = 0;
+                while (isDigit(_text[_position])) {
+                    argIndex = argIndex * 10 + (_text[_position] - '0');
+                    ++_position;
+                }
+
+                if (argIndex > UINT8_MAX) invalidDiagnosticText("argument index is too large");
+
+                if (_segments) _segments[index].argIndex = (uint8_t)argIndex;
+            }
+
+            // Compiles the text up to the end or one of the delimiters, which is not consumed.
+            constexpr void compileUntil(char delimiter, char otherDelimiter) {
+                size_t textStart = _position;
+
+                while (_text[_position] != '\0' && _text[_position] != delimiter
+                       && _text[_position] != otherDelimiter) {
+                    if (_text[_position] != '%') {
+                        ++_position;
+                        continue;
+                    }
+
+                    addText(textStart, _position);
+                    ++_position;
+
+                    // The second percent sign of "%%" is the start of the next text.
+                    if (_text[_position] == '%') {
+                        textStart = _position;
+                        ++_position;
+                        continue;
+                    }
+
+                    compileModifier();
+                    textStart = _position;
+                }
+
+                addText(textStart, _position);
+            }
+
+            constexpr void compileModifier() {
+                size_t start = _position;
+                while (isAlpha(_text[_position])) ++_position;
+
+                if (isModifier(start, "reset")) {
+                    add(FormatSegment::Kind::reset);
+                } else if (isModifier(start, "select")) {
+                    size_t index = add(FormatSegment::Kind::select);
+
+                    consume('{');
+                    while (true) {
+                        size_t alternative = add(FormatSegment::Kind::alternative);
+                        compileUntil('|', '}');
+                        endBody(alternative);
+
+                        if (_text[_position] != '|') break;
+                        ++_position;
+                    }
+                    consume('}');
+
+                    endBody(index);
+                    compileArgIndex(index);
+                } else if (isModifier(start, "if")) {
+                    size_t index = add(FormatSegment::Kind::condition);
+
+                    consume('{');
+                    compileUntil('}', '}');
+                    consume('}');
+
+                    endBody(index);
+                    compileArgIndex(index);
+                } else if (isModifier(start, "indent")) {
+                    compileArgIndex(add(FormatSegment::Kind::indent));
+                } else if (isModifier(start, "s")) {
+                    compileArgIndex(add(FormatSegment::Kind::plural));
+                } else if (isModifier(start, "")) {
+                    compileArgIndex(add(FormatSegment::Kind::argument));
+                } else {
+                    invalidDiagnosticText("unknown modifier");
+                }
+            }
+        };
+    }
+}
+
+#endif //JUICE_DIAG_DIAGNOSTICFORMAT_H
@@ -0,0 +1,179 @@
+// include/juice/Diagnostics/DiagnosticSink.h - Destinations of the diagnostics emitted by a DiagnosticEngine
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_DIAG_DIAGNOSTICSINK_H
+#define JUICE_DIAG_DIAGNOSTICSINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Diagnostics.h"
+#include "juice/Basic/SourceLocation.h"
+#include "juice/Basic/SourceManager.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace juice {
+    namespace diag {
+        enum class DiagnosticOutputFormat: uint8_t {
+            // Messages with the source line, as written by the ConsoleDiagnosticSink.
+            text,
+            // One JSON object per line for every error and warning.
+            json,
+            // A SARIF 2.1.0 log, for code scanning tools.
+            sarif
+        };
+
+
+        // A diagnostic as it is passed to a DiagnosticSink. The arguments and the text are only valid until
+        // DiagnosticSink::consume returns.
+        struct DiagnosticInfo {
+            DiagnosticID id;
+            DiagnosticKind kind;
+            basic::SourceLocation location;
+            llvm::ArrayRef<DiagnosticArg> args;
+            // The formatted text, which doesn't contain the source location, but the trailing newline, if the
+            // diagnostic has one.
+            llvm::StringRef text;
+            // nullptr for diagnostics that aren't about the source file, e.g. if it can't be read, which never have a
+            // location.
+            basic::SourceManager * sourceManager;
+        };
+
+
+        // Receives the diagnostics of a DiagnosticEngine once they have been formatted.
+        class DiagnosticSink {
+        public:
+            // Output diagnostics like AST dumps are always written as text to `outputOS`, only errors and warnings
+            // are written in `format`.
+            static std::unique_ptr<DiagnosticSink> create(DiagnosticOutputFormat format, llvm::raw_ostream & outputOS);
+
+            virtual ~DiagnosticSink() = default;
+
+            // Whether the texts of diagnostics of `kind` should contain color escape sequences.
+            virtual bool hasColors(DiagnosticKind kind) const = 0;
+
+            virtual void consume(const DiagnosticInfo & diagnostic) = 0;
+
+            // Writes out all diagnostics that are still buffered.
+            virtual void flush() {}
+
+            // Changes the stream output diagnostics are written to, e.g. once the output file has been opened.
+            virtual void setOutputStream(llvm::raw_ostream & outputOS) {}
+        };
+
+
+        // Writes errors and warnings to stderr and output diagnostics like AST dumps to an output stream. Consecutive
+        // messages to the same stream are collected and written at once, when a message goes to the other stream,
+        // the buffer is full or the sink is flushed, so that large dumps don't cost a system call per diagnostic.
+        class ConsoleDiagnosticSink: public DiagnosticSink {
+            llvm::raw_ostream * _outputOS;
+
+            bool _errorColors;
+            bool _outputColors;
+
+            std::string _buffer;
+            // The stream the buffered messages go to, nullptr if the buffer is empty.
+            llvm::raw_ostream * _bufferOS = nullptr;
+
+        public:
+            static constexpr size_t bufferSize = 64 * 1024;
+
+            ConsoleDiagnosticSink() = delete;
+            ConsoleDiagnosticSink(const ConsoleDiagnosticSink &) = delete;
+            ConsoleDiagnosticSink & operator=(const ConsoleDiagnosticSink &) = delete;
+
+            explicit ConsoleDiagnosticSink(llvm::raw_ostream & outputOS);
+
+            ~ConsoleDiagnosticSink() override;
+
+            bool hasColors(DiagnosticKind kind) const override;
+
+            void consume(const DiagnosticInfo & diagnostic) override;
+
+            void flush() override;
+
+            void setOutputStream(llvm::raw_ostream & outputOS) override;
+
+        protected:
+            // Returns the buffer to append a message to `os` to, after writing out the messages to the other stream.
+            std::string & getBuffer(llvm::raw_ostream & os);
+
+            void flushIfFull() {
+                if (_buffer.size() >= bufferSize) flush();
+            }
+        };
+
+
+        // Writes every error and warning to stderr as soon as it is diagnosed, as a JSON object on its own line, so
+        // that tools can process them while the compilation is still running. Output diagnostics are written as
+        // text, like by the ConsoleDiagnosticSink.
+        class JSONDiagnosticSink: public ConsoleDiagnosticSink {
+        public:
+            using ConsoleDiagnosticSink::ConsoleDiagnosticSink;
+
+            bool hasColors(DiagnosticKind kind) const override;
+
+            void consume(const DiagnosticInfo & diagnostic) override;
+        };
+
+
+        // Writes errors and warnings to stderr as a SARIF 2.1.0 log with a single run. Every result is written as
+        // soon as it is diagnosed, the log is completed when the sink is destroyed.
+        class SARIFDiagnosticSink: public ConsoleDiagnosticSink {
+            bool _hasStarted = false;
+            bool _hasResults = false;
+
+        public:
+            using ConsoleDiagnosticSink::ConsoleDiagnosticSink;
+
+            ~SARIFDiagnosticSink() override;
+
+            bool hasColors(DiagnosticKind kind) const override;
+
+            void consume(const DiagnosticInfo & diagnostic) override;
+
+        private:
+            void writeStart(llvm::raw_ostream & os);
+        };
+
+
+        // Keeps all diagnostics in memory instead of printing them, e.g. for tools that embed the compiler.
+        class MemoryDiagnosticSink: public DiagnosticSink {
+        public:
+            struct Diagnostic {
+                DiagnosticID id;
+                DiagnosticKind kind;
+                basic::SourceLocation location;
+                // The formatted text, without the source location.
+                std::string text;
+            };
+
+        private:
+            std::vector<Diagnostic> _diagnostics;
+
+        public:
+            bool hasColors(DiagnosticKind) const override { return false; }
+
+            void consume(const DiagnosticInfo & diagnostic) override;
+
+            const std::vector<Diagnostic> & getDiagnostics() const { return _diagnostics; }
+
+            void clear() { _diagnostics.clear(); }
+        };
+    }
+}
+
+#endif //JUICE_DIAG_DIAGNOSTICSINK_H
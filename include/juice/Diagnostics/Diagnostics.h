@@ -23,17 +23,12 @@
 #include "juice/Basic/SourceLocation.h"
 #include "juice/Basic/SourceManager.h"
 #include "juice/Sema/Type.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/SourceMgr.h"
 
 namespace juice {
-    namespace ast {
-        class TypeRepr;
-
-        llvm::raw_ostream & operator<<(llvm::raw_ostream & os, const TypeRepr * typeRepr);
-    }
-
     namespace parser {
         struct LexerToken;
 
@@ -48,12 +43,14 @@ namespace juice {
             const LexerToken * getToken() const { return _token; }
         };
 
-        std::unique_ptr<LexerTokenStream> operator<<(llvm::raw_ostream & os, const LexerToken * token);
-        llvm::raw_ostream & operator<<(std::unique_ptr<LexerTokenStream> tokenStream,
-                                  const basic::SourceManager * sourceManager);
+        LexerTokenStream operator<<(llvm::raw_ostream & os, const LexerToken * token);
+        llvm::raw_ostream & operator<<(LexerTokenStream tokenStream, const basic::SourceManager * sourceManager);
     }
 
     namespace diag {
+        class DiagnosticSink;
+        struct FormatSegment;
+
         enum class DiagnosticID: uint32_t {
             #define DIAG(KIND, ID, Text, Newline) ID,
             #include "Diagnostics.def"
@@ -103,7 +100,6 @@ namespace juice {
                 color,
                 type,
                 types,
-                typeRepr,
                 errorCode
             };
 
@@ -118,7 +114,6 @@ namespace juice {
                 const basic::Color _color;
                 sema::Type _type;
                 const std::vector<sema::Type> * _types;
-                const ast::TypeRepr * _typeRepr;
                 std::error_code _errorCode;
             };
 
@@ -144,26 +139,12 @@ namespace juice {
             explicit DiagnosticArg(const basic::Color color): _kind(Kind::color), _color(color) {}
             explicit DiagnosticArg(sema::Type type): _kind(Kind::type), _type(type) {}
             explicit DiagnosticArg(const std::vector<sema::Type> * types): _kind(Kind::types), _types(types) {}
-            explicit DiagnosticArg(const ast::TypeRepr * typeRepr): _kind(Kind::typeRepr), _typeRepr(typeRepr) {}
             explicit DiagnosticArg(std::error_code errorCode): _kind(Kind::errorCode), _errorCode(errorCode) {}
             // NOLINTEND(cppcoreguidelines-pro-type-member-init)
 
             explicit DiagnosticArg(const std::string & string) = delete;
 
 
-            static void getAllInto(std::vector<DiagnosticArg> & vector) {}
-
-            template<typename T>
-            static void getAllInto(std::vector<DiagnosticArg> & vector, T first) {
-                vector.push_back(DiagnosticArg(first));
-            }
-
-            template<typename T, typename... Args>
-            static void getAllInto(std::vector<DiagnosticArg> & vector, T first, Args... args) {
-                vector.push_back(DiagnosticArg(first));
-                getAllInto(vector, args...);
-            }
-
             Kind getKind() const { return _kind; }
 
             u_int64_t getAsInteger() const { return _integer; }
@@ -174,63 +155,83 @@ namespace juice {
             basic::Color getAsColor() const { return _color; }
             sema::Type getAsType() const { return _type; }
             const std::vector<sema::Type> & getAsTypes() const { return *_types; }
-            const ast::TypeRepr * getAsTypeRepr() const { return _typeRepr; }
             std::error_code getAsErrorCode() const { return _errorCode; }
         };
 
         class DiagnosticEngine {
             std::unique_ptr<basic::SourceManager> _sourceManager;
 
-            llvm::raw_ostream & _outputOS;
+            std::shared_ptr<DiagnosticSink> _sink;
+
+            // Reused for every diagnostic, so that formatting doesn't allocate once it is large enough.
+            std::string _text;
 
             bool _hadError = false;
 
         public:
+            // The sink may be shared with the code that creates the engine, so that it can use it for static
+            // diagnostics, too.
+            DiagnosticEngine(std::unique_ptr<basic::SourceManager> sourceManager, std::shared_ptr<DiagnosticSink> sink);
+
+            // Prints errors and warnings to stderr and output diagnostics to `outputOS`, using a ConsoleDiagnosticSink.
             DiagnosticEngine(std::unique_ptr<basic::SourceManager> sourceManager, llvm::raw_ostream & outputOS);
 
+            ~DiagnosticEngine();
+
             bool hadError() const { return _hadError; }
             std::shared_ptr<basic::SourceBuffer> getBuffer() const { return _sourceManager->getMainBuffer(); }
 
+            DiagnosticSink & getSink() const { return *_sink; }
+
+            // Writes out the diagnostics that the sink has buffered, e.g. at the end of a compiler phase.
+            void flush();
+
+            // The arguments are only stored in a temporary array on the stack, which lives until the diagnostic has
+            // been formatted.
             template<typename... Args>
             void diagnose(basic::SourceLocation location, DiagnosticID id, Args... args) {
-                std::vector<DiagnosticArg> vector;
-                DiagnosticArg::getAllInto(vector, args...);
-
-                diagnose(location, id, vector);
+                diagnose(location, id, {DiagnosticArg(args)...});
             }
 
-            void diagnose(basic::SourceLocation location, DiagnosticID id, const std::vector<DiagnosticArg> & args);
+            void diagnose(basic::SourceLocation location, DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args);
 
+            // Static diagnostics aren't about a source file and don't have a location. These print them as text.
             template<typename... Args>
             static void diagnose(DiagnosticID id, Args... args) {
-                std::vector<DiagnosticArg> vector;
-                DiagnosticArg::getAllInto(vector, args...);
+                diagnose(id, {DiagnosticArg(args)...});
+            }
+
+            static void diagnose(DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args);
 
-                diagnose(id, vector);
+            template<typename... Args>
+            static void diagnose(DiagnosticSink & sink, DiagnosticID id, Args... args) {
+                diagnose(sink, id, {DiagnosticArg(args)...});
             }
 
-            static void diagnose(DiagnosticID id, const std::vector<DiagnosticArg> & args);
+            static void diagnose(DiagnosticSink & sink, DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args);
 
-        private:
-            static llvm::StringRef
-            skipToDelimiter(llvm::StringRef & text, char delimiter, bool * foundDelimiter = nullptr);
+            // Lexer tokens are only printed with their location if `sourceManager` is not nullptr.
+            static void formatArgInto(llvm::raw_ostream & out, const DiagnosticArg & arg,
+                                      const basic::SourceManager * sourceManager);
 
-            static void formatSelectionArgInto(llvm::raw_ostream & out, llvm::StringRef modifierArguments,
-                                               const std::vector<DiagnosticArg> & args, unsigned int selectedIndex);
+        private:
+            // Formats the text passed to the sink, which doesn't contain the source location.
+            static void formatMessageInto(std::string & text, DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args,
+                                          bool coloredOutput, DiagnosticEngine * diagnostics);
 
-            static void
-            formatDiagnosticArgInto(llvm::raw_ostream & out, llvm::StringRef modifier, llvm::StringRef modifierArguments,
-                                    const std::vector<DiagnosticArg> & args, unsigned int argIndex,
-                                    DiagnosticEngine * diagnostics = nullptr);
+            static void formatSegmentsInto(llvm::raw_ostream & out, const char * text, const FormatSegment * begin,
+                                           const FormatSegment * end, llvm::ArrayRef<DiagnosticArg> args,
+                                           DiagnosticEngine * diagnostics);
 
-            static void
-            formatDiagnosticTextInto(llvm::raw_ostream & out, llvm::StringRef text, const std::vector<DiagnosticArg> & args,
-                                     DiagnosticEngine * diagnostics = nullptr);
+            static void formatDiagnosticInto(llvm::raw_ostream & out, DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args,
+                                             DiagnosticEngine * diagnostics = nullptr);
 
         public:
             static constexpr DiagnosticKind diagnosticKindFor(DiagnosticID id);
             static constexpr const char * diagnosticStringFor(DiagnosticID id);
             static constexpr bool diagnosticNewlineFor(DiagnosticID id);
+            // The identifier of the diagnostic in Diagnostics.def, e.g. for machine-readable output.
+            static const char * diagnosticNameFor(DiagnosticID id);
         };
     }
 }
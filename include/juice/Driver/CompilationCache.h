@@ -0,0 +1,65 @@
+// include/juice/Driver/CompilationCache.h - Persistent on-disk cache of compiled object files
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_DRIVER_COMPILATIONCACHE_H
+#define JUICE_DRIVER_COMPILATIONCACHE_H
+
+#include <memory>
+#include <string>
+
+#include "Frontend.h"
+#include "juice/IRGen/CodeGenOptions.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace juice {
+    namespace driver {
+        // Stores the outputs of the frontend in a directory, keyed by a hash of the source file's contents, the
+        // compiler's version and build, and all options that influence the generated code. Unlike modification times,
+        // the key doesn't change when a file is touched or checked out again, so such files don't have to be
+        // recompiled. Entries that haven't been used in a while are removed when new ones are stored.
+        //
+        // All operations are safe to call from several threads at once. Failures are never reported, they just
+        // result in a cache miss or an entry that isn't stored.
+        class CompilationCache {
+            std::string _directory;
+
+            explicit CompilationCache(std::string directory);
+
+        public:
+            CompilationCache() = delete;
+
+            // Creates a cache in `directory`, or in the user's cache directory if it is empty. Returns nullptr if
+            // the directory can't be created.
+            static std::shared_ptr<const CompilationCache> create(llvm::StringRef directory);
+
+            // Returns the key for compiling the file at `inputPath` with the compiler at `executablePath`, or an empty
+            // Optional if the file can't be read.
+            static llvm::Optional<std::string> computeKey(llvm::StringRef executablePath, llvm::StringRef inputPath,
+                                                          Frontend::Action action,
+                                                          const irgen::CodeGenOptions & options);
+
+            // Copies the entry for `key` to `outputPath`, returns whether there was one.
+            bool retrieve(llvm::StringRef key, llvm::StringRef outputPath) const;
+
+            // Adds the file at `outputPath` as the entry for `key`, and prunes old entries if the cache has grown too
+            // large.
+            void store(llvm::StringRef key, llvm::StringRef outputPath) const;
+
+            llvm::StringRef getDirectory() const { return _directory; }
+
+        private:
+            std::string getEntryPath(llvm::StringRef key) const;
+        };
+    }
+}
+
+#endif //JUICE_DRIVER_COMPILATIONCACHE_H
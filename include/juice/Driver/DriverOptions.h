@@ -0,0 +1,26 @@
+// include/juice/Driver/DriverOptions.h - Command line option definitions shared between Driver subclasses
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_DRIVER_DRIVEROPTIONS_H
+#define JUICE_DRIVER_DRIVEROPTIONS_H
+
+#include "llvm/Support/CommandLine.h"
+
+namespace juice {
+    namespace driver {
+        namespace options {
+            llvm::cl::desc optimizationLevelDescription();
+            llvm::cl::ValuesClass optimizationLevelValues();
+        }
+    }
+}
+
+#endif //JUICE_DRIVER_DRIVEROPTIONS_H
@@ -16,8 +16,11 @@
 #include <string>
 #include <system_error>
 
+#include "CompilationCache.h"
 #include "DriverAction.h"
+#include "Frontend.h"
 #include "juice/Diagnostics/Diagnostics.h"
+#include "juice/IRGen/CodeGenOptions.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -33,9 +36,14 @@ namespace juice {
             enum class Kind {
                 input,
                 compilation,
-                linking
+                linking,
+                batch
             };
 
+            // The minimum duration in microseconds of the events recorded by the time trace profiler. Zero records
+            // every pass, even the short ones.
+            static constexpr unsigned int traceGranularity = 0;
+
         private:
             const Kind _kind;
 
@@ -45,12 +53,14 @@ namespace juice {
             std::string _outputPath;
             bool _outputIsTemporary;
 
+            unsigned int _jobs;
+
         public:
             DriverTask() = delete;
 
             DriverTask(Kind kind, std::string executablePath, llvm::SmallVector<std::string, 16> arguments,
                        llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs, std::string outputPath,
-                       bool outputIsTemporary);
+                       bool outputIsTemporary, unsigned int jobs = 1);
 
             virtual ~DriverTask() = default;
 
@@ -66,7 +76,12 @@ namespace juice {
             const std::string & getOutputPath() const { return _outputPath; }
             llvm::StringRef getOutputPathRef() const { return _outputPath; }
 
-        private:
+        protected:
+            // Runs the task itself, after its inputs are up-to-date. By default, this executes the task's command line.
+            virtual llvm::Error run();
+
+            // Executes the inputs on up to `jobs` threads (0 meaning one per hardware thread) and waits for all of
+            // them, even if some fail. All errors are returned together.
             llvm::Expected<bool> executeInputs(llvm::sys::TimePoint<> timePoint);
 
         public:
@@ -88,23 +103,41 @@ namespace juice {
         };
 
         class CompilationTask: public DriverTask {
+            Frontend::Action _frontendAction;
+            irgen::CodeGenOptions _options;
+            bool _inProcess;
+            std::shared_ptr<const CompilationCache> _cache;
+
             CompilationTask(std::string executablePath, llvm::SmallVector<std::string, 16> arguments,
                             llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs,
-                            std::string outputPath, bool outputIsTemporary);
+                            std::string outputPath, bool outputIsTemporary, Frontend::Action frontendAction,
+                            irgen::CodeGenOptions options, bool inProcess,
+                            std::shared_ptr<const CompilationCache> cache);
 
         public:
             CompilationTask() = delete;
 
+            // If `cache` is not null, object files are looked up in and added to it. Other outputs are never cached.
             static llvm::Expected<std::unique_ptr<CompilationTask>>
-            create(const char * firstArg, DriverAction action, std::unique_ptr<InputTask> input);
+            create(const char * firstArg, DriverAction action, const irgen::CodeGenOptions & options,
+                   bool inProcess, std::shared_ptr<const CompilationCache> cache, std::unique_ptr<InputTask> input);
             static std::unique_ptr<CompilationTask>
-            create(const char * firstArg, DriverAction action, std::unique_ptr<InputTask> input, std::string outputPath,
-                   bool outputIsTemporary = false);
+            create(const char * firstArg, DriverAction action, const irgen::CodeGenOptions & options,
+                   bool inProcess, std::shared_ptr<const CompilationCache> cache, std::unique_ptr<InputTask> input,
+                   std::string outputPath, bool outputIsTemporary = false);
 
 
             llvm::Error createExecutionError(int exitCode) override;
 
+        protected:
+            // Copies the object file from the cache if it has an entry for the input. Otherwise, runs the frontend in
+            // this process, unless the task was created to spawn `juice frontend` instead, and caches its output.
+            llvm::Error run() override;
 
+        private:
+            llvm::Error runFrontend();
+
+        public:
             static bool classof(const DriverTask * task) {
                 return task->getKind() == Kind::compilation;
             }
@@ -113,19 +146,39 @@ namespace juice {
         class LinkingTask: public DriverTask {
             LinkingTask(std::string executablePath, llvm::SmallVector<std::string, 16> arguments,
                         llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs,
-                        std::string outputPath);
+                        std::string outputPath, unsigned int jobs);
 
         public:
             LinkingTask() = delete;
 
             static llvm::Expected<std::unique_ptr<LinkingTask>>
-            create(llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs, std::string outputPath);
+            create(llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs, std::string outputPath,
+                   unsigned int jobs = 1);
 
 
             static bool classof(const DriverTask * task) {
                 return task->getKind() == Kind::linking;
             }
         };
+
+        // Executes independent tasks that don't produce a combined output, e.g. the compilations of several input
+        // files to separate object files.
+        class BatchTask: public DriverTask {
+            BatchTask(llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs, unsigned int jobs);
+
+        public:
+            BatchTask() = delete;
+
+            static std::unique_ptr<BatchTask>
+            create(llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs, unsigned int jobs = 1);
+
+            llvm::Expected<bool> executeIfNecessary(llvm::sys::TimePoint<> timePoint) override;
+
+
+            static bool classof(const DriverTask * task) {
+                return task->getKind() == Kind::batch;
+            }
+        };
     }
 }
 
@@ -0,0 +1,106 @@
+// include/juice/Driver/Frontend.h - Frontend class, runs the compiler pipeline on a single source file
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_DRIVER_FRONTEND_H
+#define JUICE_DRIVER_FRONTEND_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "FrontendStatistics.h"
+#include "juice/Diagnostics/DiagnosticSink.h"
+#include "juice/Diagnostics/Diagnostics.h"
+#include "juice/IRGen/CodeGenOptions.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Timer.h"
+
+namespace juice {
+    namespace irgen {
+        class IRGen;
+    }
+
+    namespace driver {
+        // Parses, type-checks and compiles one source file in the current process. Used by the frontend subcommand
+        // as well as directly by the main driver, which then doesn't need to spawn a new process for every file.
+        class Frontend {
+            typedef FrontendStatistics::Phase Phase;
+
+        public:
+            enum class Action: uint8_t {
+                dumpParse,
+                dumpAST,
+                emitIR,
+                emitObject,
+                // Executes `main` in the current process instead of writing any output.
+                run
+            };
+
+        private:
+            Action _action;
+            std::string _inputFile;
+            std::string _outputFile;
+            irgen::CodeGenOptions _options;
+            diag::DiagnosticOutputFormat _diagnosticOutputFormat = diag::DiagnosticOutputFormat::text;
+
+            std::unique_ptr<llvm::raw_pwrite_stream> _outputOS;
+
+            // Both are destroyed before the output stream, which buffered output diagnostics may still be written to.
+            std::shared_ptr<diag::DiagnosticSink> _diagnosticSink;
+            std::shared_ptr<diag::DiagnosticEngine> _diagnostics;
+
+            std::unique_ptr<FrontendStatistics> _statistics;
+
+        public:
+            Frontend() = delete;
+            Frontend(const Frontend &) = delete;
+            Frontend & operator=(const Frontend &) = delete;
+
+            Frontend(Action action, std::string inputFile, std::string outputFile, irgen::CodeGenOptions options);
+
+            // Makes execute record the time and memory used by each phase, which can then be printed from the
+            // returned object.
+            FrontendStatistics & enableStatistics();
+
+            // Has to be called before execute.
+            void setDiagnosticOutputFormat(diag::DiagnosticOutputFormat format) { _diagnosticOutputFormat = format; }
+
+            // The sink that receives all diagnostics in the selected format, including static ones that are
+            // diagnosed before the source file has been read. It is created on first use and lives as long as the
+            // frontend, so that e.g. a SARIF log is only completed once the driver is done with it.
+            diag::DiagnosticSink & getDiagnosticSink();
+
+            // Returns the exit code of the compilation, or of the program when running it. All errors have already
+            // been diagnosed.
+            int execute();
+
+        private:
+            llvm::Expected<llvm::raw_pwrite_stream &> getOutputOS();
+
+            // Also flushes the diagnostics at the end of the phase, outside of the time it is reported to take.
+            template <typename Function>
+            auto timePhase(Phase phase, Function function) -> decltype(function()) {
+                auto flushDiagnostics = llvm::make_scope_exit([this] { _diagnostics->flush(); });
+
+                llvm::TimeRegion timeRegion(_statistics ? &_statistics->getTimer(phase) : nullptr);
+                llvm::TimeTraceScope traceScope(FrontendStatistics::getDescription(phase));
+                return function();
+            }
+
+            int run(irgen::IRGen & codegen);
+        };
+    }
+}
+
+#endif //JUICE_DRIVER_FRONTEND_H
@@ -14,39 +14,38 @@
 
 #include "Driver.h"
 
+#include <string>
+
+#include "Frontend.h"
+#include "juice/Diagnostics/DiagnosticSink.h"
+#include "juice/IRGen/CodeGenOptions.h"
 #include "llvm/Support/CommandLine.h"
-#include "llvm/Support/Error.h"
-#include "llvm/Support/raw_ostream.h"
 
 namespace juice {
     namespace driver {
         extern llvm::cl::SubCommand frontendSubcommand;
 
         class FrontendDriver: public Driver {
-            enum class Action: uint8_t {
-                dumpParse,
-                dumpAST,
-                emitIR,
-                emitObject
-            };
+            typedef Frontend::Action Action;
 
             static llvm::cl::opt<std::string> inputFile;
             static llvm::cl::opt<std::string> outputFile;
 
             static llvm::cl::opt<Action> action;
 
+            static llvm::cl::opt<irgen::OptimizationLevel> optimizationLevel;
+            static llvm::cl::opt<std::string> targetCPU;
+            static llvm::cl::opt<std::string> targetFeatures;
+
+            static llvm::cl::opt<diag::DiagnosticOutputFormat> diagnosticsFormat;
 
-            llvm::raw_pwrite_stream * _outputOS = nullptr;
+            static llvm::cl::opt<bool> timeReport;
+            static llvm::cl::opt<std::string> timeReportFile;
 
         public:
             FrontendDriver() = default;
 
-            ~FrontendDriver() override;
-
             int execute() override;
-
-        private:
-            llvm::Expected<llvm::raw_pwrite_stream &> getOutputOS();
         };
     }
 }
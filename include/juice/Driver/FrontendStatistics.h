@@ -0,0 +1,81 @@
+// include/juice/Driver/FrontendStatistics.h - Time and memory report of the frontend phases
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_DRIVER_FRONTENDSTATISTICS_H
+#define JUICE_DRIVER_FRONTENDSTATISTICS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/Timer.h"
+
+namespace juice {
+    namespace driver {
+        // Collects the time and heap memory used by each phase of a Frontend run, together with the time of every
+        // LLVM pass and the size of the input. Creating an instance also enables the timers of LLVM's legacy pass
+        // manager, which is used for emitting object files.
+        class FrontendStatistics {
+        public:
+            enum class Phase: uint8_t {
+                lex,
+                parse,
+                typeCheck,
+                generateIR,
+                optimize,
+                emit
+            };
+
+            static constexpr size_t phaseCount = static_cast<size_t>(Phase::emit) + 1;
+
+        private:
+            llvm::TimerGroup _timerGroup;
+            std::array<llvm::Timer, phaseCount> _timers;
+
+            llvm::TimePassesHandler _passTimer;
+
+            size_t _tokenCount = 0;
+            size_t _parsedNodeCount = 0;
+            size_t _typeCheckedNodeCount = 0;
+            size_t _astBytes = 0;
+
+        public:
+            FrontendStatistics(const FrontendStatistics &) = delete;
+            FrontendStatistics & operator=(const FrontendStatistics &) = delete;
+
+            FrontendStatistics();
+
+            // Resets all timers of the process, which LLVM would otherwise print on its own when they are destroyed.
+            ~FrontendStatistics();
+
+            llvm::Timer & getTimer(Phase phase) { return _timers[static_cast<size_t>(phase)]; }
+            llvm::TimePassesHandler & getPassTimer() { return _passTimer; }
+
+            void setTokenCount(size_t tokenCount) { _tokenCount = tokenCount; }
+            void setParsedNodeCount(size_t nodeCount) { _parsedNodeCount = nodeCount; }
+            size_t getParsedNodeCount() const { return _parsedNodeCount; }
+            void setTypeCheckedNodeCount(size_t nodeCount) { _typeCheckedNodeCount = nodeCount; }
+            void setASTBytes(size_t bytes) { _astBytes = bytes; }
+
+            // Both print functions report all timers of the process, including LLVM's pass timers.
+            void print(llvm::raw_ostream & os);
+            // Prints a flat JSON object in the format of LLVM's -stats-json, e.g. "time.frontend.parse.wall".
+            void printJSON(llvm::raw_ostream & os);
+
+            static const char * getName(Phase phase);
+            static const char * getDescription(Phase phase);
+        };
+    }
+}
+
+#endif //JUICE_DRIVER_FRONTENDSTATISTICS_H
@@ -17,15 +17,17 @@
 #include <memory>
 #include <string>
 
+#include "CompilationCache.h"
 #include "DriverAction.h"
 #include "DriverTask.h"
+#include "juice/IRGen/CodeGenOptions.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 
 namespace juice {
     namespace driver {
         class MainDriver: public Driver {
-            static llvm::cl::opt<std::string> inputFilename;
+            static llvm::cl::list<std::string> inputFilenames;
             static llvm::cl::opt<std::string> outputFilename;
             __attribute__((unused)) static llvm::cl::alias outputFilenameAlias;
 
@@ -33,6 +35,22 @@ namespace juice {
 
             static DriverAction getAction() { return action.getValue(); }
 
+            static llvm::cl::opt<irgen::OptimizationLevel> optimizationLevel;
+            static llvm::cl::opt<std::string> targetArchitecture;
+            static llvm::cl::opt<std::string> targetCPU;
+            static llvm::cl::opt<std::string> targetFeatures;
+
+            static llvm::cl::opt<bool> spawnFrontend;
+            static llvm::cl::opt<unsigned int> jobs;
+
+            static llvm::cl::opt<bool> disableCache;
+            static llvm::cl::opt<std::string> cacheDirectory;
+
+            static llvm::cl::opt<std::string> traceFilename;
+
+            static irgen::CodeGenOptions getCodeGenOptions();
+            static std::shared_ptr<const CompilationCache> getCompilationCache();
+
 
 
             const char * _firstArg;
@@ -46,6 +64,9 @@ namespace juice {
 
         private:
             llvm::Expected<std::unique_ptr<DriverTask>> parseOptions();
+
+            int executeTask();
+            bool writeTrace();
         };
     }
 }
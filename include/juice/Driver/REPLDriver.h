@@ -14,13 +14,41 @@
 
 #include "Driver.h"
 
+#include <memory>
+#include <vector>
+
+#include "juice/AST/ASTContext.h"
+#include "juice/Diagnostics/Diagnostics.h"
+#include "juice/IRGen/JIT.h"
+#include "juice/Sema/TypeChecker.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+
 namespace juice {
     namespace driver {
+        extern llvm::cl::SubCommand replSubcommand;
+
+        // Reads one line of input at a time, and type-checks and JIT-compiles it against the declarations of all
+        // earlier lines, whose variables stay alive in the JIT.
         class REPLDriver: public Driver {
+            // The declarations in the type checker's state refer to the source buffers and tokens of the lines that
+            // declared them, so these have to be kept around.
+            struct Line {
+                std::shared_ptr<diag::DiagnosticEngine> diagnostics;
+                std::unique_ptr<ast::ASTContext> context;
+            };
+
+            std::vector<Line> _lines;
+            std::unique_ptr<sema::TypeChecker::State> _state;
+            std::unique_ptr<irgen::JIT> _jit;
+
         public:
             REPLDriver() = default;
 
             int execute() override;
+
+        private:
+            void evaluate(llvm::StringRef input, unsigned int lineNumber);
         };
     }
 }
@@ -0,0 +1,41 @@
+// include/juice/Driver/RunDriver.h - Driver subclass that executes a source file without linking it
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_DRIVER_RUNDRIVER_H
+#define JUICE_DRIVER_RUNDRIVER_H
+
+#include "Driver.h"
+
+#include <string>
+
+#include "juice/IRGen/CodeGenOptions.h"
+#include "llvm/Support/CommandLine.h"
+
+namespace juice {
+    namespace driver {
+        extern llvm::cl::SubCommand runSubcommand;
+
+        // Compiles a source file in memory and executes its `main` function in the JIT. No object file is written
+        // and no linker is invoked, which makes running a program about as fast as type-checking it.
+        class RunDriver: public Driver {
+            static llvm::cl::opt<std::string> inputFilename;
+
+            static llvm::cl::opt<irgen::OptimizationLevel> optimizationLevel;
+
+        public:
+            RunDriver() = default;
+
+            int execute() override;
+        };
+    }
+}
+
+#endif //JUICE_DRIVER_RUNDRIVER_H
@@ -0,0 +1,58 @@
+// include/juice/IRGen/CodeGenOptions.h - options controlling optimization and code generation
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_IRGEN_CODEGENOPTIONS_H
+#define JUICE_IRGEN_CODEGENOPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Support/ErrorHandling.h"
+
+namespace juice {
+    namespace irgen {
+        enum class OptimizationLevel: uint8_t {
+            O0,
+            O1,
+            O2,
+            O3,
+            Os
+        };
+
+        struct CodeGenOptions {
+            OptimizationLevel optimizationLevel = OptimizationLevel::O0;
+
+            // The CPU to generate code for, "native" for the host CPU, or empty for a generic CPU of the target.
+            std::string cpu;
+            // Comma-separated list of target features, each prefixed by '+' to enable or '-' to disable it.
+            std::string features;
+
+            llvm::CodeGenOpt::Level getCodeGenLevel() const {
+                switch (optimizationLevel) {
+                    case OptimizationLevel::O0:
+                        return llvm::CodeGenOpt::None;
+                    case OptimizationLevel::O1:
+                        return llvm::CodeGenOpt::Less;
+                    case OptimizationLevel::O2:
+                    case OptimizationLevel::Os:
+                        return llvm::CodeGenOpt::Default;
+                    case OptimizationLevel::O3:
+                        return llvm::CodeGenOpt::Aggressive;
+                }
+
+                llvm_unreachable("All optimization levels should be handled here");
+            }
+        };
+    }
+}
+
+#endif //JUICE_IRGEN_CODEGENOPTIONS_H
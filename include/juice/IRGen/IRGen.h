@@ -13,18 +13,24 @@
 #define JUICE_IRGEN_IRGEN_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "CodeGenOptions.h"
+#include "juice/AST/ASTContext.h"
 #include "juice/Diagnostics/Diagnostics.h"
 #include "juice/Sema/TypeChecker.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/PassTimingInfo.h"
 #include "llvm/IR/Type.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
 
 namespace juice {
     namespace sema {
@@ -50,74 +56,117 @@ namespace juice {
 
     namespace irgen {
         class IRGen {
-            std::unique_ptr<sema::TypeCheckedModuleAST> _ast;
+            const ast::ASTContext & _astContext;
+            const sema::TypeCheckedModuleAST & _ast;
 
             std::shared_ptr<diag::DiagnosticEngine> _diagnostics;
 
-            llvm::LLVMContext _context;
+            CodeGenOptions _options;
+
+            std::string _targetCPU;
+            std::string _targetFeatures;
+            bool _hasValidTargetOptions;
+
+            std::unique_ptr<llvm::LLVMContext> _ownedContext;
+            llvm::LLVMContext & _context;
             llvm::IRBuilder<> _builder;
             std::unique_ptr<llvm::Module> _module;
 
-            std::vector<llvm::AllocaInst *> _allocas;
+            // The storage of every variable, indexed by its declaration index.
+            std::vector<llvm::Value *> _variables;
+
+            // If set, variables declared at the top level of the module are stored in global variables instead
+            // of allocas, so that code generated later, possibly into a different module, can refer to them.
+            bool _hasPersistentVariables = false;
+            unsigned int _blockDepth = 0;
+
+            std::unique_ptr<llvm::TargetMachine> _targetMachine;
 
         public:
             IRGen() = delete;
+            IRGen(const IRGen &) = delete;
+            IRGen & operator=(const IRGen &) = delete;
+
+            // Only reads the type-checked AST, so several IRGen instances can be created from the same
+            // type-checking result, e.g. to emit both textual IR and an object file.
+            IRGen(const ast::ASTContext & astContext, const sema::TypeChecker::Result & typeCheckResult,
+                  std::shared_ptr<diag::DiagnosticEngine> diagnostics, const CodeGenOptions & options = {});
 
-            IRGen(sema::TypeChecker::Result typeCheckResult, std::shared_ptr<diag::DiagnosticEngine> diagnostics);
+            // Hands the target machine back to the TargetMachineCache.
+            ~IRGen();
 
+            // Generates `main`, which prints the value of the module.
             bool generate();
+            // Generates `functionName`, which prints the value of the module if it yields one. Top-level variables
+            // persist after the function returns, and modules generated for later REPL input can use them.
+            bool generateIncremental(llvm::StringRef functionName);
+
+            // Records the time spent in every pass in `passTimer`, if given.
+            bool optimize(llvm::TimePassesHandler * passTimer = nullptr);
             void dumpProgram(llvm::raw_ostream & os);
 
             bool emitObject(llvm::raw_pwrite_stream & os);
 
+            // Hands the module over together with its context, e.g. to the JIT. Nothing else may be called afterwards.
+            llvm::orc::ThreadSafeModule takeModule();
+
         private:
+            // Diagnoses an unknown target CPU or feature.
+            bool checkTargetOptions();
+            llvm::TargetMachine * getTargetMachine();
+
+            bool generateFunction(llvm::StringRef name);
+
+            llvm::Value * getVariable(size_t index, llvm::Type * type, llvm::StringRef name);
+            static std::string getPersistentVariableName(size_t index, llvm::StringRef name);
+
             llvm::Value * generateModule();
 
-            llvm::Value * generateBlock(std::unique_ptr<sema::TypeCheckedBlockAST> block);
+            llvm::Value * generateBlock(const sema::TypeCheckedBlockAST & block);
 
-            llvm::Value * generateControlFlowBody(std::unique_ptr<sema::TypeCheckedControlFlowBodyAST> body);
+            llvm::Value * generateControlFlowBody(const sema::TypeCheckedControlFlowBodyAST & body);
 
 
-            void generateDeclaration(std::unique_ptr<sema::TypeCheckedDeclarationAST> declaration);
+            void generateDeclaration(const sema::TypeCheckedDeclarationAST & declaration);
 
-            void generateVariableDeclaration(std::unique_ptr<sema::TypeCheckedVariableDeclarationAST> declaration);
+            void generateVariableDeclaration(const sema::TypeCheckedVariableDeclarationAST & declaration);
 
 
-            llvm::Value * generateExpression(std::unique_ptr<sema::TypeCheckedExpressionAST> expression);
+            llvm::Value * generateExpression(const sema::TypeCheckedExpressionAST & expression);
 
             llvm::Value *
-            generateBinaryOperatorExpression(std::unique_ptr<sema::TypeCheckedBinaryOperatorExpressionAST> expression);
+            generateBinaryOperatorExpression(const sema::TypeCheckedBinaryOperatorExpressionAST & expression);
 
             llvm::Value *
-            generateIntegerLiteralExpression(std::unique_ptr<sema::TypeCheckedIntegerLiteralExpressionAST> expression);
+            generateIntegerLiteralExpression(const sema::TypeCheckedIntegerLiteralExpressionAST & expression);
 
             llvm::Value * generateFloatingPointLiteralExpression(
-                std::unique_ptr<sema::TypeCheckedFloatingPointLiteralExpressionAST> expression);
+                const sema::TypeCheckedFloatingPointLiteralExpressionAST & expression);
 
             llvm::Value *
-            generateBooleanLiteralExpression(std::unique_ptr<sema::TypeCheckedBooleanLiteralExpressionAST> expression);
+            generateBooleanLiteralExpression(const sema::TypeCheckedBooleanLiteralExpressionAST & expression);
 
             llvm::Value *
-            generateVariableExpression(std::unique_ptr<sema::TypeCheckedVariableExpressionAST> expression);
+            generateVariableExpression(const sema::TypeCheckedVariableExpressionAST & expression);
 
             llvm::Value *
-            generateGroupingExpression(std::unique_ptr<sema::TypeCheckedGroupingExpressionAST> expression);
+            generateGroupingExpression(const sema::TypeCheckedGroupingExpressionAST & expression);
 
-            llvm::Value * generateIfExpression(std::unique_ptr<sema::TypeCheckedIfExpressionAST> expression);
+            llvm::Value * generateIfExpression(const sema::TypeCheckedIfExpressionAST & expression);
 
 
-            void generateStatement(std::unique_ptr<sema::TypeCheckedStatementAST> statement);
+            void generateStatement(const sema::TypeCheckedStatementAST & statement);
 
-            llvm::Value * generateYieldingStatement(std::unique_ptr<sema::TypeCheckedStatementAST> statement);
+            llvm::Value * generateYieldingStatement(const sema::TypeCheckedStatementAST & statement);
 
-            llvm::Value * generateBlockStatement(std::unique_ptr<sema::TypeCheckedBlockStatementAST> statement);
+            llvm::Value * generateBlockStatement(const sema::TypeCheckedBlockStatementAST & statement);
 
             llvm::Value *
-            generateExpressionStatement(std::unique_ptr<sema::TypeCheckedExpressionStatementAST> statement);
+            generateExpressionStatement(const sema::TypeCheckedExpressionStatementAST & statement);
 
-            void generateIfStatement(std::unique_ptr<sema::TypeCheckedIfStatementAST> statement);
+            void generateIfStatement(const sema::TypeCheckedIfStatementAST & statement);
 
-            void generateWhileStatement(std::unique_ptr<sema::TypeCheckedWhileStatementAST> statement);
+            void generateWhileStatement(const sema::TypeCheckedWhileStatementAST & statement);
 
 
             llvm::Function *
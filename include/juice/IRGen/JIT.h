@@ -0,0 +1,53 @@
+// include/juice/IRGen/JIT.h - JIT compiler that executes generated modules in the current process
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_IRGEN_JIT_H
+#define JUICE_IRGEN_JIT_H
+
+#include <memory>
+
+#include "CodeGenOptions.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+
+namespace juice {
+    namespace irgen {
+        // Compiles modules for the host and links them against each other and against the symbols of the current
+        // process, e.g. printf. Errors are diagnosed directly, like in IRGen.
+        class JIT {
+            std::unique_ptr<llvm::orc::LLJIT> _jit;
+
+            explicit JIT(std::unique_ptr<llvm::orc::LLJIT> jit);
+
+        public:
+            typedef int (* Function)();
+
+            JIT() = delete;
+            JIT(const JIT &) = delete;
+            JIT & operator=(const JIT &) = delete;
+
+            // Returns nullptr if the JIT can't be created for the host.
+            static std::unique_ptr<JIT> create(const CodeGenOptions & options = {});
+
+            // Adds the module with its own resource tracker, which removeModule takes to remove it again. Returns
+            // nullptr if the module can't be added.
+            llvm::orc::ResourceTrackerSP addModule(llvm::orc::ThreadSafeModule module);
+            bool removeModule(llvm::orc::ResourceTrackerSP module);
+
+            // Compiles the function if necessary, returns nullptr if it can't be found.
+            Function lookup(llvm::StringRef name);
+        };
+    }
+}
+
+#endif //JUICE_IRGEN_JIT_H
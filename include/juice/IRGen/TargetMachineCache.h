@@ -0,0 +1,58 @@
+// include/juice/IRGen/TargetMachineCache.h - Process-wide target initialization and reuse of target machines
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_IRGEN_TARGETMACHINECACHE_H
+#define JUICE_IRGEN_TARGETMACHINECACHE_H
+
+#include <memory>
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/Target/TargetMachine.h"
+
+namespace juice {
+    namespace irgen {
+        // Initializes LLVM's targets lazily, the native one on first use and all others only if a triple for a
+        // different target is requested, and keeps target machines around after a compilation is done, so that the
+        // next compilation with the same configuration doesn't have to create one again.
+        //
+        // A target machine can't be used by several threads at once, so each one is lent to a single user until it
+        // is handed back. All functions are safe to call from several threads at once.
+        class TargetMachineCache {
+        public:
+            TargetMachineCache() = delete;
+
+            static void initializeNativeTarget();
+
+            // Looks up the target for the given triple, initializing all targets if it isn't the native one. Returns
+            // nullptr and sets `errorString` if the target can't be found.
+            static const llvm::Target * lookupTarget(llvm::StringRef triple, std::string & errorString);
+
+            // Returns an idle target machine for the given configuration, or creates a new one. Returns nullptr and
+            // sets `errorString` if the target can't be found.
+            static std::unique_ptr<llvm::TargetMachine> acquire(llvm::StringRef triple, llvm::StringRef cpu,
+                                                                llvm::StringRef features,
+                                                                llvm::CodeGenOpt::Level level,
+                                                                std::string & errorString);
+
+            // Makes a target machine returned by acquire available for reuse.
+            static void release(std::unique_ptr<llvm::TargetMachine> targetMachine);
+
+        private:
+            static std::string getKey(llvm::StringRef triple, llvm::StringRef cpu, llvm::StringRef features,
+                                      llvm::CodeGenOpt::Level level);
+        };
+    }
+}
+
+#endif //JUICE_IRGEN_TARGETMACHINECACHE_H
@@ -0,0 +1,32 @@
+// include/juice/Parser/CharacterScanner.h - Vectorized scanning of character runs for the Lexer
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_PARSER_CHARACTERSCANNER_H
+#define JUICE_PARSER_CHARACTERSCANNER_H
+
+namespace juice {
+    namespace parser {
+        // Each of these returns a pointer to the first character in [current, end) that does not belong to the
+        // respective run, or end if the run extends to the end of the buffer. They use AVX2 or SSE2 when the compiler
+        // targets them, and fall back to scalar loops otherwise.
+
+        const char * scanHorizontalWhitespace(const char * current, const char * end);
+        const char * scanIdentifierChars(const char * current, const char * end);
+        const char * scanDigits(const char * current, const char * end);
+        const char * scanToNewline(const char * current, const char * end);
+
+        // Makes the functions above use only their scalar loops while disabled, e.g. to compare the vectorized ones
+        // against them. This must not be changed while anything is being lexed.
+        void setVectorizedScanning(bool enabled);
+    }
+}
+
+#endif //JUICE_PARSER_CHARACTERSCANNER_H
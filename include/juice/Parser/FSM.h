@@ -1,4 +1,4 @@
-// include/juice/Parser/FSM.h - finite state machine classes for lexing string and number literals
+// include/juice/Parser/FSM.h - Finite state machines used by the Lexer
 //
 // This source file is part of the juice open source project
 //
@@ -13,54 +13,106 @@
 #define JUICE_PARSER_FSM_H
 
 #include <cstddef>
+#include <cstdint>
 
 namespace juice {
     namespace parser {
         class FSM {
         public:
-            struct StateReturn;
+            static constexpr uint8_t noNextState = 0xFF;
 
-            typedef StateReturn (*State)(const char *);
-
-            struct StateReturn {
+            struct Transition {
                 bool error;
-                State next;
+                uint8_t next;
+            };
+
+            struct CharacterClasses {
+                uint8_t classes[256];
             };
 
+            template <typename State>
             struct Return {
                 const char * error;
                 size_t length;
                 State state;
             };
 
-            static Return run(const char * start, const char * end, State initialState);
-
-            static StateReturn noNextState(const char *);
+        protected:
+            // Drives a transition table, indexed by [state][character class], over the characters in [start, end),
+            // followed by a virtual newline if the buffer doesn't end with one. Machine has to provide State,
+            // classCount, characterClasses, transitions and a classify function, that may refine the class of a
+            // character by looking at the following one.
+            template <typename Machine>
+            static Return<typename Machine::State> run(const char * start, const char * end,
+                                                       typename Machine::State initialState);
         };
 
         class NumberFSM: public FSM {
+            friend class FSM;
+
+            enum CharacterClass: uint8_t {
+                other,
+                digit,
+                dot,
+                dotDot,
+                exponent,
+                sign,
+
+                classCount
+            };
+
+            static const CharacterClasses characterClasses;
+            static const Transition transitions[][classCount];
+
+            static constexpr CharacterClasses createCharacterClasses();
+
+            static uint8_t classify(char c, const char * current);
+
         public:
-            static Return run(const char * start, const char * end);
-
-            static StateReturn begin(const char * current);
-            static StateReturn integer(const char * current);
-            static StateReturn beginDecimal(const char * current);
-            static StateReturn decimal(const char * current);
-            static StateReturn beginExponent(const char * current);
-            static StateReturn beginSignedExponent(const char * current);
-            static StateReturn decimalWithExponent(const char * current);
+            enum State: uint8_t {
+                begin,
+                integer,
+                beginDecimal,
+                decimal,
+                beginExponent,
+                beginSignedExponent,
+                decimalWithExponent
+            };
+
+            static Return<State> run(const char * start, const char * end);
         };
 
         class StringFSM: public FSM {
+            friend class FSM;
+
+            enum CharacterClass: uint8_t {
+                other,
+                quote,
+                backslash,
+                newline,
+                escapable,
+
+                classCount
+            };
+
+            static const CharacterClasses characterClasses;
+            static const Transition transitions[][classCount];
+
+            static constexpr CharacterClasses createCharacterClasses();
+
+            static uint8_t classify(char c, const char * current);
+
         public:
-            static Return run(const char * start, const char * end);
-
-            static StateReturn begin(const char * current);
-            static StateReturn string(const char * current);
-            static StateReturn escape(const char * current);
-            static StateReturn invalidEscape(const char * current);
-            static StateReturn end(const char *);
-            static StateReturn invalidEscapeEnd(const char * current);
+            enum State: uint8_t {
+                begin,
+                string,
+                escape,
+                invalidEscape,
+                end,
+                invalidEscapeEnd
+            };
+
+            static Return<State> run(const char * start, const char * end);
         };
     }
 }
@@ -16,8 +16,10 @@
 #include <memory>
 
 #include "LexerToken.h"
+#include "TokenBuffer.h"
 #include "juice/Basic/SourceBuffer.h"
 #include "juice/Diagnostics/Diagnostics.h"
+#include "llvm/ADT/StringRef.h"
 
 namespace juice {
     namespace parser {
@@ -27,6 +29,9 @@ namespace juice {
             const char * _start;
             const char * _current;
 
+            diag::DiagnosticID _errorID;
+            const char * _errorPosition;
+
             char peek();
             char peekNext();
             bool isAtEnd();
@@ -35,19 +40,18 @@ namespace juice {
             void advanceBy(size_t amount);
             bool match(char expected);
 
-            std::unique_ptr<LexerToken> makeToken(LexerToken::Type type);
-            std::unique_ptr<LexerToken> errorToken(diag::DiagnosticID id, bool atEnd = false);
-            std::unique_ptr<LexerToken> errorToken(diag::DiagnosticID id, const char * position);
+            LexerToken::Type makeToken(LexerToken::Type type);
+            LexerToken::Type errorToken(diag::DiagnosticID id, bool atEnd = false);
+            LexerToken::Type errorToken(diag::DiagnosticID id, const char * position);
 
             void skipLineComment();
             bool skipBlockComment();
 
-            LexerToken::Type checkKeyword(int startCount, int length, const char * rest, LexerToken::Type type);
-            LexerToken::Type identifierType();
+            LexerToken::Type stringLiteral();
+            LexerToken::Type identifier();
+            LexerToken::Type numberLiteral();
 
-            std::unique_ptr<LexerToken> stringLiteral();
-            std::unique_ptr<LexerToken> identifier();
-            std::unique_ptr<LexerToken> numberLiteral();
+            LexerToken::Type scanToken();
 
         public:
             Lexer() = delete;
@@ -56,7 +60,12 @@ namespace juice {
 
             explicit Lexer(std::shared_ptr<basic::SourceBuffer> sourceBuffer);
 
+            TokenBuffer tokenize();
+
             std::unique_ptr<LexerToken> nextToken();
+
+            // Returns the type of the keyword `string` is spelled like, or LexerToken::Type::identifier.
+            static LexerToken::Type identifierType(llvm::StringRef string);
         };
     }
 }
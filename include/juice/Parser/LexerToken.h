@@ -78,42 +78,8 @@ namespace juice {
 
 
             //Keywords
-                //Declaration keywords
-                keywordBinary,
-                keywordClass,
-                keywordCompound,
-                keywordFailable,
-                keywordFunc,
-                keywordInit,
-                keywordLet,
-                keywordOverride,
-                keywordPrivate,
-                keywordUnary,
-                keywordVar,
-
-                //Statement keywords
-                keywordBreak,
-                keywordCase,
-                keywordContinue,
-                keywordDo,
-                keywordElif,
-                keywordElse,
-                keywordFor,
-                keywordIf,
-                keywordIn,
-                keywordReturn,
-                keywordSwitch,
-                keywordWhile,
-
-                //Expression keywords
-                keywordAs,
-                keywordFalse,
-                keywordIs,
-                keywordNil,
-                keywordPrint,
-                keywordSelf,
-                keywordSuper,
-                keywordTrue,
+                #define KEYWORD(Name, Spelling, DumpName) keyword##Name,
+                #include "Keywords.def"
 
 
                 //Identifiers and literals
@@ -0,0 +1,32 @@
+// include/juice/Parser/LiteralDecoder.h - Decoding of integer and floating-point literal tokens
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_PARSER_LITERALDECODER_H
+#define JUICE_PARSER_LITERALDECODER_H
+
+#include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace juice {
+    namespace parser {
+        // Decodes the digits of an integer literal token into an unsigned APInt. Literals that fit into 64 bits are
+        // decoded without allocating and yield a 64 bit wide result; larger ones get exactly as many bits as they need.
+        llvm::APInt decodeIntegerLiteral(llvm::StringRef string);
+
+        // Decodes a floating-point literal token, correctly rounded to nearest (ties to even) in the given
+        // semantics. Values too large for the semantics decode to infinity.
+        llvm::APFloat decodeFloatingPointLiteral(llvm::StringRef string,
+                                                 const llvm::fltSemantics & semantics = llvm::APFloat::IEEEdouble());
+    }
+}
+
+#endif //JUICE_PARSER_LITERALDECODER_H
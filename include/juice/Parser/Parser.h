@@ -13,7 +13,7 @@
 #define JUICE_PARSER_PARSER_H
 
 #include <array>
-#include <deque>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <tuple>
@@ -21,7 +21,9 @@
 
 #include "Lexer.h"
 #include "LexerToken.h"
+#include "TokenBuffer.h"
 #include "juice/AST/AST.h"
+#include "juice/AST/ASTContext.h"
 #include "juice/AST/DeclarationAST.h"
 #include "juice/AST/ExpressionAST.h"
 #include "juice/AST/StatementAST.h"
@@ -49,27 +51,26 @@ namespace juice {
             };
 
 
+            ast::ASTContext & _context;
             std::shared_ptr<diag::DiagnosticEngine> _diagnostics;
-            std::unique_ptr<Lexer> _lexer;
+            const TokenBuffer & _tokens;
 
-            std::unique_ptr<LexerToken> _previousToken;
-            std::unique_ptr<LexerToken> _currentToken;
-            std::unique_ptr<LexerToken> _matchedToken;
-
-            std::deque<std::unique_ptr<LexerToken>> _lookaheadTokens;
+            size_t _currentToken;
+            size_t _matchedToken;
+            size_t _lookaheadToken;
 
             bool _inBlock;
             bool _wasNewline;
+            bool _hasPendingLexerError;
 
             template <typename... Args>
             llvm::Error createError(diag::DiagnosticID diagnosticID, Args &&... args);
 
             bool isAtEnd();
 
-            const std::unique_ptr<LexerToken> & getPreviousToken();
-            const std::unique_ptr<LexerToken> & getPreviousLookaheadToken();
-            const std::unique_ptr<LexerToken> & getCurrentLookaheadToken();
-            std::unique_ptr<LexerToken> moveFirstLookaheadToken();
+            size_t getPreviousToken();
+            size_t getPreviousLookaheadToken();
+            size_t getCurrentLookaheadToken();
 
             bool check(LexerToken::Type type);
 
@@ -83,7 +84,7 @@ namespace juice {
 
             llvm::Error advanceOne();
             llvm::Error skipNewlines();
-            llvm::Expected<std::unique_ptr<LexerToken>> advance();
+            llvm::Expected<size_t> advance();
 
             llvm::Expected<bool> match(LexerToken::Type type);
 
@@ -111,7 +112,7 @@ namespace juice {
 
             llvm::Error advanceLookaheadOne();
             llvm::Error lookaheadSkipNewlines();
-            llvm::Expected<const std::unique_ptr<LexerToken> &> advanceLookahead();
+            llvm::Expected<size_t> advanceLookahead();
 
             llvm::Expected<bool> matchLookahead(LexerToken::Type type);
 
@@ -123,50 +124,55 @@ namespace juice {
 
 
 
-            llvm::Expected<std::unique_ptr<ast::BlockAST>> parseBlock(llvm::StringRef name);
+            llvm::Expected<ast::BlockAST *> parseBlock(llvm::StringRef name);
+
+            llvm::Expected<ast::ControlFlowBodyAST *> parseControlFlowBody(size_t keyword);
 
-            llvm::Expected<std::unique_ptr<ast::ControlFlowBodyAST>>
-            parseControlFlowBody(std::unique_ptr<LexerToken> keyword);
 
+            llvm::Expected<ast::IfExpressionAST *> parseIfExpression(bool isStatement);
+            llvm::Expected<ast::ExpressionAST *> parseGroupedExpression();
 
-            llvm::Expected<std::unique_ptr<ast::IfExpressionAST>> parseIfExpression(bool isStatement);
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseGroupedExpression();
+            llvm::Expected<ast::ExpressionAST *> parsePrimaryExpression();
+            llvm::Expected<ast::ExpressionAST *> parseMultiplicationPrecedenceExpression();
+            llvm::Expected<ast::ExpressionAST *> parseAdditionPrecedenceExpression();
+            llvm::Expected<ast::ExpressionAST *> parseComparisonPrecedenceExpression();
+            llvm::Expected<ast::ExpressionAST *> parseEqualityPrecedenceExpression();
+            llvm::Expected<ast::ExpressionAST *> parseLogicalAndPrecedenceExpression();
+            llvm::Expected<ast::ExpressionAST *> parseLogicalOrPrecedenceExpression();
+            llvm::Expected<ast::ExpressionAST *> parseAssignmentPrecedenceExpression();
+            llvm::Expected<ast::ExpressionAST *> parseExpression();
 
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parsePrimaryExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseMultiplicationPrecedenceExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseAdditionPrecedenceExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseComparisonPrecedenceExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseEqualityPrecedenceExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseLogicalAndPrecedenceExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseLogicalOrPrecedenceExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseAssignmentPrecedenceExpression();
-            llvm::Expected<std::unique_ptr<ast::ExpressionAST>> parseExpression();
 
+            llvm::Expected<ast::ExpressionStatementAST *> parseExpressionStatement();
+            llvm::Expected<ast::WhileStatementAST *> parseWhileStatement();
+            llvm::Expected<ast::IfStatementAST *> parseIfStatement();
+            llvm::Expected<ast::BlockStatementAST *> parseBlockStatement();
 
-            llvm::Expected<std::unique_ptr<ast::ExpressionStatementAST>> parseExpressionStatement();
-            llvm::Expected<std::unique_ptr<ast::WhileStatementAST>> parseWhileStatement();
-            llvm::Expected<std::unique_ptr<ast::IfStatementAST>> parseIfStatement();
-            llvm::Expected<std::unique_ptr<ast::BlockStatementAST>> parseBlockStatement();
+            llvm::Expected<ast::TypeRepr *> parseIdentifierType();
+            llvm::Expected<ast::TypeRepr *> parseType();
+            llvm::Expected<ast::TypeRepr *> parseTypeAnnotation();
 
-            llvm::Expected<std::unique_ptr<ast::TypeRepr>> parseIdentifierType();
-            llvm::Expected<std::unique_ptr<ast::TypeRepr>> parseType();
-            llvm::Expected<std::unique_ptr<ast::TypeRepr>> parseTypeAnnotation();
+            llvm::Expected<ast::VariableDeclarationAST *> parseVariableDeclaration();
 
-            llvm::Expected<std::unique_ptr<ast::VariableDeclarationAST>> parseVariableDeclaration();
+            llvm::Expected<ast::StatementAST *> parseStatement();
 
-            llvm::Expected<std::unique_ptr<ast::StatementAST>> parseStatement();
+            void diagnoseError(llvm::Error error);
+            void skipNewlinesAndErrors();
+            void synchronize(const std::function<bool(Parser *)> & endCondition, size_t statementStart);
 
-            llvm::Error parseContainer(ast::ContainerAST & container,
-                                       const std::function<bool(Parser *)> & endCondition = &Parser::isAtEnd);
+            void parseContainer(ast::ContainerAST & container,
+                                const std::function<bool(Parser *)> & endCondition = &Parser::isAtEnd);
 
         public:
             Parser() = delete;
             Parser(const Parser &) = delete;
             Parser & operator=(const Parser &) = delete;
 
-            explicit Parser(std::shared_ptr<diag::DiagnosticEngine> diagnostics);
+            Parser(ast::ASTContext & context, std::shared_ptr<diag::DiagnosticEngine> diagnostics);
 
-            std::unique_ptr<ast::ModuleAST> parseModule();
+            // Never returns nullptr. Statements with syntax errors are diagnosed and left out of the module, so whether
+            // it can be compiled has to be checked with the DiagnosticEngine.
+            ast::ModuleAST * parseModule();
         };
     }
 }
@@ -0,0 +1,92 @@
+// include/juice/Parser/TokenBuffer.h - TokenBuffer class, contiguous storage for lexed tokens
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_PARSER_TOKENBUFFER_H
+#define JUICE_PARSER_TOKENBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "LexerToken.h"
+#include "juice/Basic/SourceBuffer.h"
+#include "juice/Diagnostics/Diagnostics.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace juice {
+    namespace parser {
+        // Plain value representation of a token: its type and its position relative to the start of the source
+        // buffer. Error information is not stored inline, but in the side table of the owning TokenBuffer.
+        struct BufferedToken {
+            LexerToken::Type type;
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        static_assert(std::is_pod<BufferedToken>::value, "BufferedToken has to stay a POD type");
+
+
+        class TokenBuffer {
+        public:
+            struct Error {
+                size_t tokenIndex;
+                diag::DiagnosticID id;
+                uint32_t errorOffset;
+            };
+
+        private:
+            std::shared_ptr<basic::SourceBuffer> _sourceBuffer;
+
+            std::vector<BufferedToken> _tokens;
+            std::vector<Error> _errors;
+
+            uint32_t getOffset(const char * position) const;
+
+        public:
+            TokenBuffer() = delete;
+            TokenBuffer(const TokenBuffer &) = delete;
+            TokenBuffer & operator=(const TokenBuffer &) = delete;
+
+            TokenBuffer(TokenBuffer &&) = default;
+            TokenBuffer & operator=(TokenBuffer &&) = default;
+
+            explicit TokenBuffer(std::shared_ptr<basic::SourceBuffer> sourceBuffer);
+
+            void reserve(size_t capacity) { _tokens.reserve(capacity); }
+
+            void append(LexerToken::Type type, const char * start, const char * end);
+            void appendError(const char * start, const char * end, diag::DiagnosticID id,
+                             const char * errorPosition);
+
+            size_t size() const { return _tokens.size(); }
+
+            const BufferedToken & operator[](size_t index) const { return _tokens[index]; }
+
+            LexerToken::Type getType(size_t index) const { return _tokens[index].type; }
+
+            const char * getStart(size_t index) const { return _sourceBuffer->getStart() + _tokens[index].offset; }
+
+            llvm::StringRef getString(size_t index) const {
+                return llvm::StringRef(getStart(index), _tokens[index].length);
+            }
+
+            LexerToken getToken(size_t index) const { return LexerToken(getType(index), getString(index)); }
+
+            const Error * getError(size_t index) const;
+
+            void diagnoseInto(size_t index, diag::DiagnosticEngine & diagnostics) const;
+        };
+    }
+}
+
+#endif //JUICE_PARSER_TOKENBUFFER_H
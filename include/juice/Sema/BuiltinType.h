@@ -14,6 +14,8 @@
 
 #include "Type.h"
 
+#include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/APInt.h"
 #include "llvm/Support/ErrorHandling.h"
 
 namespace juice {
@@ -116,8 +118,9 @@ namespace juice {
             Width getWidth() const { return _width; }
             unsigned int getBitWidth() const { return (unsigned int)_width; }
 
-            int64_t getMinimumValue() const;
-            int64_t getMaximumValue() const;
+            // Whether the non-negative literal value fits into this type. Bool holds 0 and 1, all other widths are
+            // signed.
+            bool canRepresentLiteral(const llvm::APInt & value) const;
 
             bool equals(const TypeBase * other) const override;
 
@@ -169,6 +172,8 @@ namespace juice {
 
             FPKind getFPKind() const { return _fpKind; }
 
+            const llvm::fltSemantics & getSemantics() const;
+
             unsigned int getBitWidth() const {
                 switch (_fpKind) {
                     case FPKind::ieee16:  return 16;
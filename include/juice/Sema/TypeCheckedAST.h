@@ -12,17 +12,17 @@
 #ifndef JUICE_SEMA_TYPECHECKEDAST_H
 #define JUICE_SEMA_TYPECHECKEDAST_H
 
-#include <memory>
-#include <vector>
+#include <cstddef>
 
 #include "Type.h"
 #include "TypeChecker.h"
 #include "TypeHint.h"
 #include "juice/AST/AST.h"
+#include "juice/AST/ASTContext.h"
 #include "juice/Basic/RawStreamHelpers.h"
 #include "juice/Basic/SourceLocation.h"
 #include "juice/Diagnostics/Diagnostics.h"
-#include "juice/Parser/LexerToken.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace juice {
     namespace irgen {
@@ -80,9 +80,18 @@ namespace juice {
 
             virtual ~TypeCheckedAST() = default;
 
-            virtual basic::SourceLocation getLocation() const = 0;
+            void * operator new(size_t size, ast::ASTContext & context) {
+                return context.allocateNode(size, alignof(TypeCheckedAST));
+            }
+            void operator delete(void *, ast::ASTContext &) {}
+
+            void * operator new(size_t) = delete;
+            void operator delete(void *) {}
 
-            virtual void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const = 0;
+            virtual basic::SourceLocation getLocation(const ast::ASTContext & context) const = 0;
+
+            virtual void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                      unsigned int level) const = 0;
 
             Kind getKind() const { return _kind; }
             Type getType() const { return _type; }
@@ -92,19 +101,19 @@ namespace juice {
             friend class irgen::IRGen;
 
         public:
-            typedef std::vector<std::unique_ptr<TypeCheckedStatementAST>> StatementVector;
+            typedef llvm::ArrayRef<TypeCheckedStatementAST *> StatementArray;
 
         protected:
-            StatementVector _statements;
+            StatementArray _statements;
 
-            TypeCheckedContainerAST(Kind kind, Type type, StatementVector && statements);
+            TypeCheckedContainerAST(Kind kind, Type type, StatementArray statements);
 
         public:
             TypeCheckedContainerAST() = delete;
 
             ~TypeCheckedContainerAST() override = default;
 
-            basic::SourceLocation getLocation() const override;
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override;
 
             static bool classof(const TypeCheckedAST * type) {
                 return type->getKind() >= Kind::container
@@ -113,7 +122,7 @@ namespace juice {
         };
 
         class TypeCheckedModuleAST: public TypeCheckedContainerAST {
-            TypeCheckedModuleAST(Type type, StatementVector && statements);
+            TypeCheckedModuleAST(Type type, StatementArray statements);
 
             friend class irgen::IRGen;
 
@@ -122,10 +131,11 @@ namespace juice {
 
             ~TypeCheckedModuleAST() override = default;
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedModuleAST>
-            createByTypeChecking(std::unique_ptr<ast::ModuleAST> ast, const TypeHint & hint, TypeChecker::State & state,
+            static TypeCheckedModuleAST *
+            createByTypeChecking(ast::ModuleAST * ast, const TypeHint & hint, TypeChecker::State & state,
                                  diag::DiagnosticEngine & diagnostics);
 
 
@@ -135,10 +145,9 @@ namespace juice {
         };
 
         class TypeCheckedBlockAST: public TypeCheckedContainerAST {
-            std::unique_ptr<parser::LexerToken> _start;
+            size_t _start;
 
-            TypeCheckedBlockAST(Type type, StatementVector && statements,
-                                std::unique_ptr<parser::LexerToken> start);
+            TypeCheckedBlockAST(Type type, StatementArray statements, size_t start);
 
             friend class irgen::IRGen;
 
@@ -147,14 +156,15 @@ namespace juice {
 
             ~TypeCheckedBlockAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_start->string.begin());
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return context.getLocation(_start);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedBlockAST>
-            createByTypeChecking(std::unique_ptr<ast::BlockAST> ast, const TypeHint & hint, TypeChecker::State & state,
+            static TypeCheckedBlockAST *
+            createByTypeChecking(ast::BlockAST * ast, const TypeHint & hint, TypeChecker::State & state,
                                  diag::DiagnosticEngine & diagnostics);
 
 
@@ -170,38 +180,37 @@ namespace juice {
                 expression
             };
 
-            std::unique_ptr<parser::LexerToken> _keyword;
+            size_t _keyword;
 
             BodyKind _bodyKind;
             union {
-                std::unique_ptr<TypeCheckedBlockAST> _block;
-                std::unique_ptr<TypeCheckedExpressionAST> _expression;
+                TypeCheckedBlockAST * _block;
+                TypeCheckedExpressionAST * _expression;
             };
 
-            TypeCheckedControlFlowBodyAST(Type type, std::unique_ptr<parser::LexerToken> keyword,
-                                          std::unique_ptr<TypeCheckedBlockAST> block);
-            TypeCheckedControlFlowBodyAST(Type type, std::unique_ptr<parser::LexerToken> keyword,
-                                          std::unique_ptr<TypeCheckedExpressionAST> expression);
+            TypeCheckedControlFlowBodyAST(Type type, size_t keyword, TypeCheckedBlockAST * block);
+            TypeCheckedControlFlowBodyAST(Type type, size_t keyword, TypeCheckedExpressionAST * expression);
 
             friend class irgen::IRGen;
 
         public:
             TypeCheckedControlFlowBodyAST() = delete;
 
-            ~TypeCheckedControlFlowBodyAST() override;
+            ~TypeCheckedControlFlowBodyAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_keyword->string.begin());
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return context.getLocation(_keyword);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedControlFlowBodyAST>
-            createByTypeChecking(std::unique_ptr<ast::ControlFlowBodyAST> ast, const TypeHint & hint,
-                                 TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
+            static TypeCheckedControlFlowBodyAST *
+            createByTypeChecking(ast::ControlFlowBodyAST * ast, const TypeHint & hint, TypeChecker::State & state,
+                                 diag::DiagnosticEngine & diagnostics);
 
 
-            const std::unique_ptr<parser::LexerToken> & getKeyword() const { return _keyword; }
+            size_t getKeyword() const { return _keyword; }
 
 
             static bool classof(const TypeCheckedAST * type) {
@@ -12,13 +12,13 @@
 #ifndef JUICE_SEMA_TYPECHECKEDDECLARATIONAST_H
 #define JUICE_SEMA_TYPECHECKEDDECLARATIONAST_H
 
-#include <memory>
+#include <cstddef>
 
 #include "TypeCheckedExpressionAST.h"
 #include "TypeCheckedStatementAST.h"
 #include "TypeChecker.h"
+#include "juice/AST/ASTContext.h"
 #include "juice/AST/DeclarationAST.h"
-#include "juice/Parser/LexerToken.h"
 
 namespace juice {
     namespace sema {
@@ -33,8 +33,8 @@ namespace juice {
 
             ~TypeCheckedDeclarationAST() override = default;
 
-            static std::unique_ptr<TypeCheckedDeclarationAST>
-            createByTypeChecking(std::unique_ptr<ast::DeclarationAST> ast, const TypeHint & hint,
+            static TypeCheckedDeclarationAST *
+            createByTypeChecking(ast::DeclarationAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -45,15 +45,13 @@ namespace juice {
         };
 
         class TypeCheckedVariableDeclarationAST: public TypeCheckedDeclarationAST {
-            std::unique_ptr<parser::LexerToken> _keyword, _name;
-            std::unique_ptr<TypeCheckedExpressionAST> _initialization;
+            size_t _keyword, _name;
+            TypeCheckedExpressionAST * _initialization;
             Type _variableType;
             size_t _index;
             bool _isMutable;
 
-            TypeCheckedVariableDeclarationAST(std::unique_ptr<parser::LexerToken> keyword,
-                                              std::unique_ptr<parser::LexerToken> name,
-                                              std::unique_ptr<TypeCheckedExpressionAST> initialization,
+            TypeCheckedVariableDeclarationAST(size_t keyword, size_t name, TypeCheckedExpressionAST * initialization,
                                               Type variableType, size_t index, bool isMutable);
 
             friend class irgen::IRGen;
@@ -63,14 +61,15 @@ namespace juice {
 
             ~TypeCheckedVariableDeclarationAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_keyword->string.begin());
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return context.getLocation(_keyword);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedVariableDeclarationAST>
-            createByTypeChecking(std::unique_ptr<ast::VariableDeclarationAST> ast, const TypeHint & hint,
+            static TypeCheckedVariableDeclarationAST *
+            createByTypeChecking(ast::VariableDeclarationAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -12,16 +12,17 @@
 #ifndef JUICE_SEMA_TYPECHECKEDEXPRESSIONAST_H
 #define JUICE_SEMA_TYPECHECKEDEXPRESSIONAST_H
 
-#include <memory>
+#include <cstddef>
 #include <utility>
-#include <vector>
 
 #include "TypeCheckedAST.h"
 #include "TypeChecker.h"
 #include "VariableDeclaration.h"
+#include "juice/AST/ASTContext.h"
 #include "juice/AST/ExpressionAST.h"
 #include "juice/Basic/SourceLocation.h"
-#include "juice/Parser/LexerToken.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 
 namespace juice {
@@ -30,9 +31,9 @@ namespace juice {
             friend class irgen::IRGen;
 
         protected:
-            std::unique_ptr<parser::LexerToken> _token;
+            size_t _token;
 
-            TypeCheckedExpressionAST(Kind kind, Type type, std::unique_ptr<parser::LexerToken> token);
+            TypeCheckedExpressionAST(Kind kind, Type type, size_t token);
 
             static void checkLValue(const TypeHint & hint, basic::SourceLocation location,
                                     diag::DiagnosticEngine & diagnostics, llvm::StringRef name);
@@ -44,12 +45,12 @@ namespace juice {
 
             ~TypeCheckedExpressionAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return basic::SourceLocation(_token->string.begin());
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return context.getLocation(_token);
             }
 
-            static std::unique_ptr<TypeCheckedExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::ExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedExpressionAST *
+            createByTypeChecking(ast::ExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -60,21 +61,21 @@ namespace juice {
         };
 
         class TypeCheckedBinaryOperatorExpressionAST: public TypeCheckedExpressionAST {
-            std::unique_ptr<TypeCheckedExpressionAST> _left, _right;
+            TypeCheckedExpressionAST * _left, * _right;
 
-            TypeCheckedBinaryOperatorExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token,
-                                                   std::unique_ptr<TypeCheckedExpressionAST> left,
-                                                   std::unique_ptr<TypeCheckedExpressionAST> right);
+            TypeCheckedBinaryOperatorExpressionAST(Type type, size_t token, TypeCheckedExpressionAST * left,
+                                                   TypeCheckedExpressionAST * right);
 
             friend class irgen::IRGen;
 
         public:
             TypeCheckedBinaryOperatorExpressionAST() = delete;
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedBinaryOperatorExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::BinaryOperatorExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedBinaryOperatorExpressionAST *
+            createByTypeChecking(ast::BinaryOperatorExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -84,19 +85,20 @@ namespace juice {
         };
 
         class TypeCheckedIntegerLiteralExpressionAST: public TypeCheckedExpressionAST {
-            int64_t _value;
+            llvm::APInt _value;
 
-            TypeCheckedIntegerLiteralExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token, int64_t value);
+            TypeCheckedIntegerLiteralExpressionAST(Type type, size_t token, llvm::APInt value);
 
             friend class irgen::IRGen;
 
         public:
             TypeCheckedIntegerLiteralExpressionAST() = delete;
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedIntegerLiteralExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::IntegerLiteralExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedIntegerLiteralExpressionAST *
+            createByTypeChecking(ast::IntegerLiteralExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -108,18 +110,18 @@ namespace juice {
         class TypeCheckedFloatingPointLiteralExpressionAST: public TypeCheckedExpressionAST {
             double _value;
 
-            TypeCheckedFloatingPointLiteralExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token,
-                                                         double value);
+            TypeCheckedFloatingPointLiteralExpressionAST(Type type, size_t token, double value);
 
             friend class irgen::IRGen;
 
         public:
             TypeCheckedFloatingPointLiteralExpressionAST() = delete;
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedFloatingPointLiteralExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::FloatingPointLiteralExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedFloatingPointLiteralExpressionAST *
+            createByTypeChecking(ast::FloatingPointLiteralExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -131,17 +133,18 @@ namespace juice {
         class TypeCheckedBooleanLiteralExpressionAST: public TypeCheckedExpressionAST {
             bool _value;
 
-            TypeCheckedBooleanLiteralExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token, bool value);
+            TypeCheckedBooleanLiteralExpressionAST(Type type, size_t token, bool value);
 
             friend class irgen::IRGen;
 
         public:
             TypeCheckedBooleanLiteralExpressionAST() = delete;
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedBooleanLiteralExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::BooleanLiteralExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedBooleanLiteralExpressionAST *
+            createByTypeChecking(ast::BooleanLiteralExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -154,20 +157,20 @@ namespace juice {
             size_t _index;
             bool _isMutable;
 
-            TypeCheckedVariableExpressionAST(std::unique_ptr<parser::LexerToken> token,
-                                             VariableDeclaration declaration);
+            TypeCheckedVariableExpressionAST(size_t token, VariableDeclaration declaration);
 
             friend class irgen::IRGen;
 
         public:
             TypeCheckedVariableExpressionAST() = delete;
 
-            llvm::StringRef name() const { return _token->string; }
+            llvm::StringRef name(const ast::ASTContext & context) const { return context.getString(_token); }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedVariableExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::VariableExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedVariableExpressionAST *
+            createByTypeChecking(ast::VariableExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -177,20 +180,20 @@ namespace juice {
         };
 
         class TypeCheckedGroupingExpressionAST: public TypeCheckedExpressionAST {
-            std::unique_ptr<TypeCheckedExpressionAST> _expression;
+            TypeCheckedExpressionAST * _expression;
 
-            TypeCheckedGroupingExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token,
-                                             std::unique_ptr<TypeCheckedExpressionAST> expression);
+            TypeCheckedGroupingExpressionAST(Type type, size_t token, TypeCheckedExpressionAST * expression);
 
             friend class irgen::IRGen;
 
         public:
             TypeCheckedGroupingExpressionAST() = delete;
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedGroupingExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::GroupingExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedGroupingExpressionAST *
+            createByTypeChecking(ast::GroupingExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -201,20 +204,19 @@ namespace juice {
 
         class TypeCheckedIfExpressionAST: public TypeCheckedExpressionAST {
         public:
-            typedef std::vector<std::pair<std::unique_ptr<TypeCheckedExpressionAST>,
-                                          std::unique_ptr<TypeCheckedControlFlowBodyAST>>> ElifVector;
+            typedef std::pair<TypeCheckedExpressionAST *, TypeCheckedControlFlowBodyAST *> ElifConditionAndBody;
 
         private:
-            std::unique_ptr<TypeCheckedExpressionAST> _ifCondition;
-            std::unique_ptr<TypeCheckedControlFlowBodyAST> _ifBody;
-            ElifVector _elifConditionsAndBodies;
-            std::unique_ptr<TypeCheckedControlFlowBodyAST> _elseBody;
+            TypeCheckedExpressionAST * _ifCondition;
+            TypeCheckedControlFlowBodyAST * _ifBody;
+            llvm::ArrayRef<ElifConditionAndBody> _elifConditionsAndBodies;
+            TypeCheckedControlFlowBodyAST * _elseBody;
             bool _isStatement;
 
-            TypeCheckedIfExpressionAST(Type type, std::unique_ptr<TypeCheckedExpressionAST> ifCondition,
-                                       std::unique_ptr<TypeCheckedControlFlowBodyAST> ifBody,
-                                       ElifVector && elifConditionsAndBodies,
-                                       std::unique_ptr<TypeCheckedControlFlowBodyAST> elseBody, bool isStatement);
+            TypeCheckedIfExpressionAST(Type type, TypeCheckedExpressionAST * ifCondition,
+                                       TypeCheckedControlFlowBodyAST * ifBody,
+                                       llvm::ArrayRef<ElifConditionAndBody> elifConditionsAndBodies,
+                                       TypeCheckedControlFlowBodyAST * elseBody, bool isStatement);
 
             friend class TypeCheckedIfStatementAST;
             friend class irgen::IRGen;
@@ -222,14 +224,15 @@ namespace juice {
         public:
             TypeCheckedIfExpressionAST() = delete;
 
-            basic::SourceLocation getLocation() const override {
-                return _ifBody->getLocation();
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return _ifBody->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedIfExpressionAST>
-            createByTypeChecking(std::unique_ptr<ast::IfExpressionAST> ast, const TypeHint & hint,
+            static TypeCheckedIfExpressionAST *
+            createByTypeChecking(ast::IfExpressionAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
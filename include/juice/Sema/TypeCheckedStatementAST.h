@@ -12,8 +12,6 @@
 #ifndef JUICE_SEMA_TYPECHECKEDSTATEMENTAST_H
 #define JUICE_SEMA_TYPECHECKEDSTATEMENTAST_H
 
-#include <memory>
-
 #include "TypeCheckedAST.h"
 #include "TypeCheckedExpressionAST.h"
 #include "TypeChecker.h"
@@ -32,8 +30,8 @@ namespace juice {
 
             ~TypeCheckedStatementAST() override = default;
 
-            static std::unique_ptr<TypeCheckedStatementAST>
-            createByTypeChecking(std::unique_ptr<ast::StatementAST> ast, const TypeHint & hint,
+            static TypeCheckedStatementAST *
+            createByTypeChecking(ast::StatementAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -44,9 +42,9 @@ namespace juice {
         };
 
         class TypeCheckedBlockStatementAST: public TypeCheckedStatementAST {
-            std::unique_ptr<TypeCheckedBlockAST> _block;
+            TypeCheckedBlockAST * _block;
 
-            TypeCheckedBlockStatementAST(Type type, std::unique_ptr<TypeCheckedBlockAST> block);
+            TypeCheckedBlockStatementAST(Type type, TypeCheckedBlockAST * block);
 
             friend class irgen::IRGen;
 
@@ -55,14 +53,15 @@ namespace juice {
 
             ~TypeCheckedBlockStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _block->getLocation();
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return _block->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedBlockStatementAST>
-            createByTypeChecking(std::unique_ptr<ast::BlockStatementAST> ast, const TypeHint & hint,
+            static TypeCheckedBlockStatementAST *
+            createByTypeChecking(ast::BlockStatementAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -72,9 +71,9 @@ namespace juice {
         };
 
         class TypeCheckedExpressionStatementAST: public TypeCheckedStatementAST {
-            std::unique_ptr<TypeCheckedExpressionAST> _expression;
+            TypeCheckedExpressionAST * _expression;
 
-            TypeCheckedExpressionStatementAST(Type type, std::unique_ptr<TypeCheckedExpressionAST> expression);
+            TypeCheckedExpressionStatementAST(Type type, TypeCheckedExpressionAST * expression);
 
             friend class irgen::IRGen;
 
@@ -83,14 +82,15 @@ namespace juice {
 
             ~TypeCheckedExpressionStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _expression->getLocation();
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return _expression->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedExpressionStatementAST>
-            createByTypeChecking(std::unique_ptr<ast::ExpressionStatementAST> ast, const TypeHint & hint,
+            static TypeCheckedExpressionStatementAST *
+            createByTypeChecking(ast::ExpressionStatementAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -100,9 +100,9 @@ namespace juice {
         };
 
         class TypeCheckedIfStatementAST: public TypeCheckedStatementAST {
-            std::unique_ptr<TypeCheckedIfExpressionAST> _ifExpression;
+            TypeCheckedIfExpressionAST * _ifExpression;
 
-            TypeCheckedIfStatementAST(Type type, std::unique_ptr<TypeCheckedIfExpressionAST> ifExpression);
+            TypeCheckedIfStatementAST(Type type, TypeCheckedIfExpressionAST * ifExpression);
 
             friend class irgen::IRGen;
 
@@ -111,14 +111,15 @@ namespace juice {
 
             ~TypeCheckedIfStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _ifExpression->getLocation();
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return _ifExpression->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedIfStatementAST>
-            createByTypeChecking(std::unique_ptr<ast::IfStatementAST> ast, const TypeHint & hint,
+            static TypeCheckedIfStatementAST *
+            createByTypeChecking(ast::IfStatementAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -128,11 +129,11 @@ namespace juice {
         };
 
         class TypeCheckedWhileStatementAST: public TypeCheckedStatementAST {
-            std::unique_ptr<TypeCheckedExpressionAST> _condition;
-            std::unique_ptr<TypeCheckedControlFlowBodyAST> _body;
+            TypeCheckedExpressionAST * _condition;
+            TypeCheckedControlFlowBodyAST * _body;
 
-            TypeCheckedWhileStatementAST(Type type, std::unique_ptr<TypeCheckedExpressionAST> condition,
-                                         std::unique_ptr<TypeCheckedControlFlowBodyAST> body);
+            TypeCheckedWhileStatementAST(Type type, TypeCheckedExpressionAST * condition,
+                                         TypeCheckedControlFlowBodyAST * body);
 
             friend class irgen::IRGen;
 
@@ -141,14 +142,15 @@ namespace juice {
 
             ~TypeCheckedWhileStatementAST() override = default;
 
-            basic::SourceLocation getLocation() const override {
-                return _body->getLocation();
+            basic::SourceLocation getLocation(const ast::ASTContext & context) const override {
+                return _body->getLocation(context);
             }
 
-            void diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const override;
+            void diagnoseInto(const ast::ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                              unsigned int level) const override;
 
-            static std::unique_ptr<TypeCheckedWhileStatementAST>
-            createByTypeChecking(std::unique_ptr<ast::WhileStatementAST> ast, const TypeHint & hint,
+            static TypeCheckedWhileStatementAST *
+            createByTypeChecking(ast::WhileStatementAST * ast, const TypeHint & hint,
                                  TypeChecker::State & state, diag::DiagnosticEngine & diagnostics);
 
 
@@ -12,60 +12,65 @@
 #ifndef JUICE_SEMA_TYPECHECKER_H
 #define JUICE_SEMA_TYPECHECKER_H
 
+#include <cstddef>
 #include <memory>
 #include <vector>
-#include <utility>
 
 #include "Type.h"
 #include "VariableDeclaration.h"
 #include "juice/AST/AST.h"
+#include "juice/AST/ASTContext.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
-#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 
 namespace juice {
     namespace sema {
         class TypeCheckedModuleAST;
+        class TypeHint;
 
         class TypeChecker {
         public:
             class State {
-                typedef std::vector<VariableDeclaration> VariableDeclarationVector;
-
+                // Neither variables nor types may shadow a declaration of an enclosing scope, so every name
+                // that is visible is declared exactly once, and one hash map per kind of declaration suffices.
+                // A scope only records how many names had been declared when it was entered; ending it removes
+                // the names declared since, in reverse order.
                 struct Scope {
-                    llvm::StringMap<Type> typeDeclarations;
+                    size_t typeDeclarationCount;
+                    size_t variableDeclarationCount;
+                };
 
-                    VariableDeclarationVector & variableDeclarations;
-                    size_t currentVariableIndex;
+                ast::ASTContext * _context;
 
-                    std::unique_ptr<Scope> parent;
+                llvm::DenseMap<llvm::StringRef, Type> _typeDeclarations;
+                llvm::DenseMap<llvm::StringRef, VariableDeclaration> _variableDeclarations;
 
-                    Scope() = delete;
+                std::vector<llvm::StringRef> _typeDeclarationNames;
+                std::vector<llvm::StringRef> _variableDeclarationNames;
 
-                    Scope(VariableDeclarationVector & variableDeclarations, size_t currentVariableIndex,
-                          std::unique_ptr<Scope> parent):
-                        variableDeclarations(variableDeclarations), currentVariableIndex(currentVariableIndex),
-                        parent(std::move(parent)) {}
+                std::vector<Scope> _scopes;
 
-                    bool hasTypeDeclaration(llvm::StringRef name) const;
-                    llvm::Optional<Type> getTypeDeclaration(llvm::StringRef name) const;
-                    bool addTypeDeclaration(llvm::StringRef name, Type type);
+                size_t _allocaVectorSize;
 
-                    bool hasVariableDeclaration(llvm::StringRef name) const;
-                    llvm::Optional<VariableDeclaration> getVariableDeclaration(llvm::StringRef name) const;
-                    llvm::Optional<size_t> addVariableDeclaration(llvm::StringRef name, Type type, bool isMutable);
-                };
+            public:
+                State() = delete;
 
-                VariableDeclarationVector _variableDeclarations;
-                std::unique_ptr<Scope> _currentScope;
+                explicit State(ast::ASTContext & context);
 
-            public:
-                State();
+                ast::ASTContext & getContext() { return *_context; }
+                const ast::ASTContext & getContext() const { return *_context; }
+
+                // Lets the declarations outlive their module, so that a later module can refer to them. The
+                // declarations' names must stay valid until the state is destroyed.
+                void setContext(ast::ASTContext & context) { _context = &context; }
 
                 void newScope();
                 void endScope();
+                // Ends the innermost scope, but keeps its declarations visible in the enclosing one.
+                void commitScope();
 
-                size_t getAllocaVectorSize() const { return _variableDeclarations.size(); }
+                size_t getAllocaVectorSize() const { return _allocaVectorSize; }
 
                 bool hasTypeDeclaration(llvm::StringRef name) const;
                 llvm::Optional<Type> getTypeDeclaration(llvm::StringRef name) const;
@@ -77,25 +82,30 @@ namespace juice {
             };
 
             struct Result {
-                std::unique_ptr<TypeCheckedModuleAST> ast;
+                TypeCheckedModuleAST * ast;
                 size_t allocaVectorSize;
 
                 Result() = delete;
 
-                Result(std::unique_ptr<TypeCheckedModuleAST> ast, size_t allocaVectorSize);
+                Result(TypeCheckedModuleAST * ast, size_t allocaVectorSize);
             };
 
         private:
-            std::unique_ptr<ast::ModuleAST> _ast;
+            ast::ASTContext & _context;
+            ast::ModuleAST * _ast;
 
             std::shared_ptr<diag::DiagnosticEngine> _diagnostics;
 
         public:
-            TypeChecker(std::unique_ptr<ast::ModuleAST> ast, std::shared_ptr<diag::DiagnosticEngine> diagnostics);
+            TypeChecker(ast::ASTContext & context, ast::ModuleAST * ast,
+                        std::shared_ptr<diag::DiagnosticEngine> diagnostics);
 
             Result typeCheck();
 
-        private:
+            // Type-checks the module against `state`, which may already contain the declarations of earlier
+            // modules, e.g. previous REPL input. The module's own declarations are added to it.
+            Result typeCheck(State & state, const TypeHint & hint);
+
             static void declareBuiltinTypes(State & state);
         };
     }
@@ -10,76 +10,62 @@
 
 #include "juice/AST/AST.h"
 
-#include <utility>
-
 #include "juice/AST/StatementAST.h"
 
 namespace juice {
     namespace ast {
-        basic::SourceLocation ContainerAST::getLocation() const {
-            if (!_statements.empty()) return _statements.front()->getLocation();
+        basic::SourceLocation ContainerAST::getLocation(const ASTContext & context) const {
+            if (!_statements.empty()) return _statements.front()->getLocation(context);
             return {};
         }
 
-        void ContainerAST::appendStatement(std::unique_ptr<StatementAST> statement) {
-            _statements.push_back(std::move(statement));
-        }
-
-        void ModuleAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            for (const auto & statement: _statements) { statement->diagnoseInto(diagnostics, level); }
+        void ModuleAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                     unsigned int level) const {
+            for (const auto * statement: _statements) { statement->diagnoseInto(context, diagnostics, level); }
         }
 
-        BlockAST::BlockAST(std::unique_ptr<parser::LexerToken> start): ContainerAST(), _start(std::move(start)) {}
+        BlockAST::BlockAST(size_t start): ContainerAST(), _start(start) {}
 
-        void BlockAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+        void BlockAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                    unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
 
             if (_statements.empty()) {
                 diagnostics.diagnose(location, diag::DiagnosticID::block_ast_empty, getColor(level));
             } else {
                 diagnostics.diagnose(location, diag::DiagnosticID::block_ast_0, getColor(level), level);
 
-                for (const auto & statement: _statements) {
+                for (const auto * statement: _statements) {
                     diagnostics.diagnose(location, diag::DiagnosticID::block_ast_1, level + 1);
 
-                    statement->diagnoseInto(diagnostics, level + 1);
+                    statement->diagnoseInto(context, diagnostics, level + 1);
                 }
 
                 diagnostics.diagnose(location, diag::DiagnosticID::block_ast_2, getColor(level), level);
             }
         }
 
-        ControlFlowBodyAST::ControlFlowBodyAST(std::unique_ptr<parser::LexerToken> keyword, std::unique_ptr<BlockAST> block):
-            _keyword(std::move(keyword)), _kind(Kind::block) {
-            new (&_block) std::unique_ptr<BlockAST>(std::move(block));
-        }
+        ControlFlowBodyAST::ControlFlowBodyAST(size_t keyword, BlockAST * block):
+            _keyword(keyword), _kind(Kind::block), _block(block) {}
 
-        ControlFlowBodyAST::ControlFlowBodyAST(std::unique_ptr<parser::LexerToken> keyword,
-                                               std::unique_ptr<ExpressionAST> expression):
-            _keyword(std::move(keyword)), _kind(Kind::expression) {
-            new (&_expression) std::unique_ptr<ExpressionAST>(std::move(expression));
-        }
-
-        ControlFlowBodyAST::~ControlFlowBodyAST() {
-            switch (_kind) {
-                case Kind::block: _block.~unique_ptr<BlockAST>(); break;
-                case Kind::expression: _expression.~unique_ptr<ExpressionAST>(); break;
-            }
-        }
+        ControlFlowBodyAST::ControlFlowBodyAST(size_t keyword, ExpressionAST * expression):
+            _keyword(keyword), _kind(Kind::expression), _expression(expression) {}
 
-        void ControlFlowBodyAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+        void ControlFlowBodyAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                              unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken keyword = context.getToken(_keyword);
 
             switch (_kind) {
                 case Kind::block:
                     diagnostics.diagnose(location, diag::DiagnosticID::if_body_ast_block, getColor(level), level,
-                                         _keyword.get());
-                    _block->diagnoseInto(diagnostics, level + 1);
+                                         &keyword);
+                    _block->diagnoseInto(context, diagnostics, level + 1);
                     break;
                 case Kind::expression:
                     diagnostics.diagnose(location, diag::DiagnosticID::if_body_ast_expression, getColor(level), level,
-                                         _keyword.get());
-                    _expression->diagnoseInto(diagnostics, level + 1);
+                                         &keyword);
+                    _expression->diagnoseInto(context, diagnostics, level + 1);
                     break;
             }
 
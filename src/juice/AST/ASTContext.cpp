@@ -0,0 +1,26 @@
+// src/juice/AST/ASTContext.cpp - ASTContext class, owns the tokens and AST nodes of a module
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/AST/ASTContext.h"
+
+#include <utility>
+
+namespace juice {
+    namespace ast {
+        ASTContext::ASTContext(parser::TokenBuffer tokens): _tokens(std::move(tokens)) {}
+
+        ASTContext::~ASTContext() {
+            for (const auto & destruction: _destructions) {
+                destruction.first(destruction.second);
+            }
+        }
+    }
+}
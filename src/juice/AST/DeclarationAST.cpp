@@ -10,24 +10,22 @@
 
 #include "juice/AST/DeclarationAST.h"
 
-#include <utility>
-
 namespace juice {
     namespace ast {
-        VariableDeclarationAST::VariableDeclarationAST(std::unique_ptr<parser::LexerToken> keyword,
-                                                       std::unique_ptr<parser::LexerToken> name,
-                                                       std::unique_ptr<TypeRepr> typeAnnotation, bool isMutable,
-                                                       std::unique_ptr<ExpressionAST> initialization):
-                DeclarationAST(Kind::variableDeclaration), _keyword(std::move(keyword)), _name(std::move(name)),
-                _typeAnnotation(std::move(typeAnnotation)), _isMutable(isMutable),
-                _initialization(std::move(initialization)) {}
+        VariableDeclarationAST::VariableDeclarationAST(size_t keyword, size_t name, TypeRepr * typeAnnotation,
+                                                       bool isMutable, ExpressionAST * initialization):
+                DeclarationAST(Kind::variableDeclaration), _keyword(keyword), _name(name),
+                _typeAnnotation(typeAnnotation), _isMutable(isMutable), _initialization(initialization) {}
 
-        void VariableDeclarationAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+        void VariableDeclarationAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                                  unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken name = context.getToken(_name);
+            llvm::StringRef typeAnnotation = _typeAnnotation ? _typeAnnotation->getSpelling(context) : "--";
 
             diagnostics.diagnose(location, diag::DiagnosticID::variable_declaration_ast, getColor(level), level,
-                                 _name.get(), _typeAnnotation.get(), _isMutable);
-            _initialization->diagnoseInto(diagnostics, level + 1);
+                                 &name, typeAnnotation, _isMutable);
+            _initialization->diagnoseInto(context, diagnostics, level + 1);
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
         }
     }
@@ -13,108 +13,121 @@
 
 #include <utility>
 
+#include "llvm/ADT/SmallString.h"
+
 namespace juice {
     namespace ast {
-        ExpressionAST::ExpressionAST(Kind kind, std::unique_ptr<juice::parser::LexerToken> token):
-            _kind(kind), _token(std::move(token)) {}
+        ExpressionAST::ExpressionAST(Kind kind, size_t token): _kind(kind), _token(token) {}
 
-        BinaryOperatorExpressionAST::BinaryOperatorExpressionAST(std::unique_ptr<parser::LexerToken> token,
-                                                                 std::unique_ptr<ExpressionAST> left,
-                                                                 std::unique_ptr<ExpressionAST> right):
-            ExpressionAST(Kind::binaryOperator, std::move(token)), _left(std::move(left)), _right(std::move(right)) {}
+        BinaryOperatorExpressionAST::BinaryOperatorExpressionAST(size_t token, ExpressionAST * left,
+                                                                 ExpressionAST * right):
+            ExpressionAST(Kind::binaryOperator, token), _left(left), _right(right) {}
 
-        void BinaryOperatorExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+        void BinaryOperatorExpressionAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                                       unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken token = context.getToken(_token);
 
             diagnostics.diagnose(location, diag::DiagnosticID::binary_operator_expression_ast_0, getColor(level),
-                                 level, _token.get());
-            _left->diagnoseInto(diagnostics, level + 1);
+                                 level, &token);
+            _left->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics
                 .diagnose(location, diag::DiagnosticID::binary_operator_expression_ast_1, getColor(level), level);
-            _right->diagnoseInto(diagnostics, level + 1);
+            _right->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
         }
 
-        IntegerLiteralExpressionAST::IntegerLiteralExpressionAST(std::unique_ptr<parser::LexerToken> token,
-                                                                 int64_t value):
-            ExpressionAST(Kind::integerLiteral, std::move(token)), _value(value) {}
+        IntegerLiteralExpressionAST::IntegerLiteralExpressionAST(size_t token, llvm::APInt value):
+            ExpressionAST(Kind::integerLiteral, token), _value(std::move(value)) {}
+
+        void IntegerLiteralExpressionAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                                       unsigned int level) const {
+            parser::LexerToken token = context.getToken(_token);
+
+            llvm::SmallString<40> value;
+            _value.toStringUnsigned(value);
 
-        void IntegerLiteralExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::integer_literal_expression_ast, getColor(level),
-                                 level, _token.get(), _value);
+            diagnostics.diagnose(getLocation(context), diag::DiagnosticID::integer_literal_expression_ast,
+                                 getColor(level), level, &token, value.str());
         }
 
-        FloatingPointLiteralExpressionAST::FloatingPointLiteralExpressionAST(std::unique_ptr<parser::LexerToken> token,
-                                                                             double value):
-            ExpressionAST(Kind::floatingPointLiteral, std::move(token)), _value(value) {}
+        FloatingPointLiteralExpressionAST::FloatingPointLiteralExpressionAST(size_t token, double value):
+            ExpressionAST(Kind::floatingPointLiteral, token), _value(value) {}
 
-        void FloatingPointLiteralExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics,
+        void FloatingPointLiteralExpressionAST::diagnoseInto(const ASTContext & context,
+                                                             diag::DiagnosticEngine & diagnostics,
                                                              unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::floating_point_literal_expression_ast,
-                                 getColor(level), level, _token.get(), _value);
+            parser::LexerToken token = context.getToken(_token);
+
+            diagnostics.diagnose(getLocation(context), diag::DiagnosticID::floating_point_literal_expression_ast,
+                                 getColor(level), level, &token, _value);
         }
 
-        BooleanLiteralExpressionAST::BooleanLiteralExpressionAST(std::unique_ptr<parser::LexerToken> token, bool value):
-            ExpressionAST(Kind::booleanLiteral, std::move(token)), _value(value) {}
+        BooleanLiteralExpressionAST::BooleanLiteralExpressionAST(size_t token, bool value):
+            ExpressionAST(Kind::booleanLiteral, token), _value(value) {}
+
+        void BooleanLiteralExpressionAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                                       unsigned int level) const {
+            parser::LexerToken token = context.getToken(_token);
 
-        void BooleanLiteralExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::boolean_literal_expression_ast, getColor(level),
-                                 level, _token.get(), _value);
+            diagnostics.diagnose(getLocation(context), diag::DiagnosticID::boolean_literal_expression_ast,
+                                 getColor(level), level, &token, _value);
         }
 
-        VariableExpressionAST::VariableExpressionAST(std::unique_ptr<parser::LexerToken> token):
-                ExpressionAST(Kind::variable, std::move(token)) {}
+        VariableExpressionAST::VariableExpressionAST(size_t token): ExpressionAST(Kind::variable, token) {}
+
+        void VariableExpressionAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                                 unsigned int level) const {
+            parser::LexerToken token = context.getToken(_token);
 
-        void VariableExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::variable_expression_ast, getColor(level),
-                                 _token.get());
+            diagnostics.diagnose(getLocation(context), diag::DiagnosticID::variable_expression_ast, getColor(level),
+                                 &token);
         }
 
-        GroupingExpressionAST::GroupingExpressionAST(std::unique_ptr<parser::LexerToken> token,
-                                                     std::unique_ptr<ExpressionAST> expression):
-                ExpressionAST(Kind::grouping, std::move(token)), _expression(std::move(expression)) {}
+        GroupingExpressionAST::GroupingExpressionAST(size_t token, ExpressionAST * expression):
+            ExpressionAST(Kind::grouping, token), _expression(expression) {}
 
-        void GroupingExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            _expression->diagnoseInto(diagnostics, level);
+        void GroupingExpressionAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                                 unsigned int level) const {
+            _expression->diagnoseInto(context, diagnostics, level);
         }
 
-        IfExpressionAST::IfExpressionAST(std::unique_ptr<ExpressionAST> ifCondition,
-                                         std::unique_ptr<ControlFlowBodyAST> ifBody,
-                                         std::vector<std::pair<std::unique_ptr<ExpressionAST>,
-                                                               std::unique_ptr<ControlFlowBodyAST>>> && elifConditionsAndBodies,
-                                         std::unique_ptr<ControlFlowBodyAST> elseBody, bool isStatement):
-            ExpressionAST(Kind::_if, nullptr), _ifCondition(std::move(ifCondition)), _ifBody(std::move(ifBody)),
-            _elifConditionsAndBodies(std::move(elifConditionsAndBodies)), _elseBody(std::move(elseBody)),
-            _isStatement(isStatement) {}
+        IfExpressionAST::IfExpressionAST(ExpressionAST * ifCondition, ControlFlowBodyAST * ifBody,
+                                         llvm::ArrayRef<ElifConditionAndBody> elifConditionsAndBodies,
+                                         ControlFlowBodyAST * elseBody, bool isStatement):
+            ExpressionAST(Kind::_if, ifBody->getKeyword()), _ifCondition(ifCondition), _ifBody(ifBody),
+            _elifConditionsAndBodies(elifConditionsAndBodies), _elseBody(elseBody), _isStatement(isStatement) {}
 
-        void IfExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+        void IfExpressionAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                           unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken keyword = context.getToken(_ifBody->getKeyword());
 
             if (_isStatement) diagnostics.diagnose(location, diag::DiagnosticID::if_statement_ast_0, getColor(level),
-                                                   level, _ifBody->getKeyword().get());
+                                                   level, &keyword);
             else diagnostics.diagnose(location, diag::DiagnosticID::if_expression_ast_0, getColor(level), level,
-                                 _ifBody->getKeyword().get());
-            _ifCondition->diagnoseInto(diagnostics, level + 1);
+                                      &keyword);
+            _ifCondition->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::if_ast_1, getColor(level), level);
-            _ifBody->diagnoseInto(diagnostics, level + 1);
+            _ifBody->diagnoseInto(context, diagnostics, level + 1);
 
             for (const auto & conditionAndBody: _elifConditionsAndBodies) {
-                const auto & condition = std::get<0>(conditionAndBody);
-                const auto & body = std::get<1>(conditionAndBody);
+                const auto * condition = std::get<0>(conditionAndBody);
+                const auto * body = std::get<1>(conditionAndBody);
 
                 diagnostics.diagnose(location, diag::DiagnosticID::if_ast_2, getColor(level), level);
-                condition->diagnoseInto(diagnostics, level + 1);
+                condition->diagnoseInto(context, diagnostics, level + 1);
 
                 diagnostics.diagnose(location, diag::DiagnosticID::if_ast_3, getColor(level), level);
-                body->diagnoseInto(diagnostics, level + 1);
+                body->diagnoseInto(context, diagnostics, level + 1);
             }
 
             if (!_isStatement || _elseBody) {
                 diagnostics.diagnose(location, diag::DiagnosticID::if_ast_4, getColor(level), level);
-                _elseBody->diagnoseInto(diagnostics, level + 1);
+                _elseBody->diagnoseInto(context, diagnostics, level + 1);
             }
 
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
@@ -10,44 +10,45 @@
 
 #include "juice/AST/StatementAST.h"
 
-#include <utility>
-
 namespace juice {
     namespace ast {
-        BlockStatementAST::BlockStatementAST(std::unique_ptr<BlockAST> block):
-            StatementAST(Kind::block), _block(std::move(block)) {}
+        BlockStatementAST::BlockStatementAST(BlockAST * block): StatementAST(Kind::block), _block(block) {}
 
-        void BlockStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            _block->diagnoseInto(diagnostics, level);
+        void BlockStatementAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                             unsigned int level) const {
+            _block->diagnoseInto(context, diagnostics, level);
         }
 
-        ExpressionStatementAST::ExpressionStatementAST(std::unique_ptr<ExpressionAST> expression):
-            StatementAST(Kind::expression), _expression(std::move(expression)) {}
+        ExpressionStatementAST::ExpressionStatementAST(ExpressionAST * expression):
+            StatementAST(Kind::expression), _expression(expression) {}
 
-        void ExpressionStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            _expression->diagnoseInto(diagnostics, level);
+        void ExpressionStatementAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                                  unsigned int level) const {
+            _expression->diagnoseInto(context, diagnostics, level);
         }
 
-        IfStatementAST::IfStatementAST(std::unique_ptr<IfExpressionAST> ifExpression):
-            StatementAST(Kind::_if), _ifExpression(std::move(ifExpression)) {}
+        IfStatementAST::IfStatementAST(IfExpressionAST * ifExpression):
+            StatementAST(Kind::_if), _ifExpression(ifExpression) {}
 
-        void IfStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            _ifExpression->diagnoseInto(diagnostics, level);
+        void IfStatementAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                          unsigned int level) const {
+            _ifExpression->diagnoseInto(context, diagnostics, level);
         }
 
-        WhileStatementAST::WhileStatementAST(std::unique_ptr<ExpressionAST> condition,
-                                             std::unique_ptr<ControlFlowBodyAST> body):
-            StatementAST(Kind::_while), _condition(std::move(condition)), _body(std::move(body)) {}
+        WhileStatementAST::WhileStatementAST(ExpressionAST * condition, ControlFlowBodyAST * body):
+            StatementAST(Kind::_while), _condition(condition), _body(body) {}
 
-        void WhileStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+        void WhileStatementAST::diagnoseInto(const ASTContext & context, diag::DiagnosticEngine & diagnostics,
+                                             unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken keyword = context.getToken(_body->getKeyword());
 
             diagnostics.diagnose(location, diag::DiagnosticID::while_statement_ast_0, getColor(level), level,
-                                 _body->getKeyword().get());
-            _condition->diagnoseInto(diagnostics, level + 1);
+                                 &keyword);
+            _condition->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::while_statement_ast_1, getColor(level), level);
-            _body->diagnoseInto(diagnostics, level + 1);
+            _body->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
         }
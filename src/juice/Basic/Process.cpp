@@ -11,13 +11,34 @@
 
 #include "juice/Basic/Process.h"
 
+#include "juice/Platform/Macros.h"
 #include "llvm/Support/FileSystem.h"
 
+#if OS_MAC || OS_LINUX
+    #include <sys/resource.h>
+#endif
+
 namespace juice {
     namespace basic {
         std::string getMainExecutablePath(const char * firstArgument) {
             void * address = (void *)(intptr_t)getMainExecutablePath;
             return llvm::sys::fs::getMainExecutable(firstArgument, address);
         }
+
+        size_t getPeakMemoryUsage() {
+        #if OS_MAC || OS_LINUX
+            struct rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+            #if OS_MAC
+                return usage.ru_maxrss;
+            #else
+                // Linux reports kilobytes instead of bytes.
+                return usage.ru_maxrss * 1024;
+            #endif
+        #else
+            return 0;
+        #endif
+        }
     }
 }
@@ -11,12 +11,56 @@
 
 #include "juice/Basic/SourceBuffer.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 namespace juice {
     namespace basic {
+        SourceBuffer::SourceBuffer(const char * start, const char * end, llvm::StringRef filename, bool deleteBuffer):
+                _start(start), _end(end), _filename(filename), _deleteBuffer(deleteBuffer), _lineStarts{0} {
+            const char * current = _start;
+            while (auto newline = (const char *)std::memchr(current, '\n', _end - current)) {
+                current = newline + 1;
+                _lineStarts.push_back(current - _start);
+            }
+        }
+
         SourceBuffer::~SourceBuffer() {
             if (_deleteBuffer) delete[] _start;
         }
+
+        size_t SourceBuffer::getLineIndex(SourceLocation location) const {
+            auto offset = (uint32_t)(location.getPointer() - _start);
+
+            // The last line that starts at or before the offset.
+            return std::upper_bound(_lineStarts.begin(), _lineStarts.end(), offset) - _lineStarts.begin() - 1;
+        }
+
+        const char * SourceBuffer::getColumnStart(size_t lineIndex, SourceLocation location) const {
+            const char * lineStart = _start + _lineStarts[lineIndex];
+
+            size_t carriageReturn = llvm::StringRef(lineStart, location.getPointer() - lineStart).rfind('\r');
+            if (carriageReturn == llvm::StringRef::npos) return lineStart;
+
+            return lineStart + carriageReturn + 1;
+        }
+
+        std::pair<unsigned int, unsigned int> SourceBuffer::getLineAndColumn(SourceLocation location) const {
+            size_t index = getLineIndex(location);
+
+            return {index + 1, location.getPointer() - getColumnStart(index, location) + 1};
+        }
+
+        llvm::StringRef SourceBuffer::getLine(SourceLocation location) const {
+            size_t index = getLineIndex(location);
+
+            const char * lineStart = getColumnStart(index, location);
+            const char * lineEnd = index + 1 < _lineStarts.size() ? _start + _lineStarts[index + 1] : _end;
+
+            // The line ends at the first line break after the location, which may be a lone carriage return.
+            llvm::StringRef line(lineStart, lineEnd - lineStart);
+            return line.take_front(line.find_first_of("\r\n", location.getPointer() - lineStart));
+        }
     }
 }
@@ -10,6 +10,7 @@
 
 #include "juice/Basic/SourceManager.h"
 
+#include <tuple>
 #include <utility>
 
 #include "juice/Basic/RawStreamHelpers.h"
@@ -37,10 +38,36 @@ namespace juice {
             return manager;
         }
 
-        void SourceManager::printDiagnostic(llvm::Twine message, diag::DiagnosticKind kind, SourceLocation location) {
-            llvm::raw_ostream & os = llvm::errs();
+        std::unique_ptr<SourceManager> SourceManager::mainString(llvm::StringRef contents, llvm::StringRef name) {
+            std::unique_ptr<SourceManager> manager(new SourceManager);
+            llvm::SourceMgr & mgr = manager->_sourceMgr;
+
+            unsigned int index = mgr.AddNewSourceBuffer(llvm::MemoryBuffer::getMemBufferCopy(contents, name),
+                                                        llvm::SMLoc());
+            const llvm::MemoryBuffer * buffer = mgr.getMemoryBuffer(index);
+
+            manager->_mainBuffer = std::make_shared<SourceBuffer>(buffer->getBufferStart(), buffer->getBufferEnd(),
+                                                                  buffer->getBufferIdentifier(), false);
+
+            return manager;
+        }
+
+        void SourceManager::printDiagnostic(llvm::raw_ostream & os, llvm::Twine message, diag::DiagnosticKind kind,
+                                            SourceLocation location) {
+            llvm::SMDiagnostic diagnostic;
+
+            if (location.isValid()) {
+                unsigned int line, column;
+                std::tie(line, column) = getLineAndColumn(location);
+
+                llvm::StringRef filename = _sourceMgr.getMemoryBuffer(_sourceMgr.getMainFileID())->getBufferIdentifier();
 
-            llvm::SMDiagnostic diagnostic = _sourceMgr.GetMessage(location.llvm(), kind.llvm(), message);
+                // The same diagnostic that llvm::SourceMgr::GetMessage creates, whose column starts at 0.
+                diagnostic = llvm::SMDiagnostic(_sourceMgr, location.llvm(), filename, line, column - 1, kind.llvm(),
+                                                message.str(), _mainBuffer->getLine(location), llvm::None);
+            } else {
+                diagnostic = _sourceMgr.GetMessage(location.llvm(), kind.llvm(), message);
+            }
 
             os << Color::bold << Color::yellow << "juice: " << Color::reset;
 
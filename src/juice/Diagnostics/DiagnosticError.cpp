@@ -18,20 +18,24 @@ namespace juice {
         const char DiagnosticError::ID = 0;
 
         DiagnosticError::DiagnosticError(basic::SourceLocation location, DiagnosticID diagnosticID,
-                                         std::vector<DiagnosticArg> args):
-            _location(location), _diagnosticID(diagnosticID), _args(std::move(args)) {}
+                                         llvm::ArrayRef<DiagnosticArg> args):
+            _location(location), _diagnosticID(diagnosticID), _args(args.begin(), args.end()) {}
 
         void DiagnosticError::diagnoseInto(diag::DiagnosticEngine & diagnostics) const {
-            diagnostics.diagnose(_location, _diagnosticID, _args);
+            diagnostics.diagnose(_location, _diagnosticID, getArgs());
         }
 
         const char StaticDiagnosticError::ID = 0;
 
-        StaticDiagnosticError::StaticDiagnosticError(DiagnosticID diagnosticID, std::vector<DiagnosticArg> args):
-            _diagnosticID(diagnosticID), _args(std::move(args)) {}
+        StaticDiagnosticError::StaticDiagnosticError(DiagnosticID diagnosticID, llvm::ArrayRef<DiagnosticArg> args):
+            _diagnosticID(diagnosticID), _args(args.begin(), args.end()) {}
 
         void StaticDiagnosticError::diagnose() const {
-            DiagnosticEngine::diagnose(_diagnosticID, _args);
+            DiagnosticEngine::diagnose(_diagnosticID, getArgs());
+        }
+
+        void StaticDiagnosticError::diagnose(DiagnosticSink & sink) const {
+            DiagnosticEngine::diagnose(sink, _diagnosticID, getArgs());
         }
     }
 }
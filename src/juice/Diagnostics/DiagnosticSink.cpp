@@ -0,0 +1,316 @@
+// src/juice/Diagnostics/DiagnosticSink.cpp - Destinations of the diagnostics emitted by a DiagnosticEngine
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Diagnostics/DiagnosticSink.h"
+
+#include <tuple>
+#include <utility>
+
+#include "juice/Basic/ColoredStringStream.h"
+#include "juice/Basic/Version.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+
+namespace juice {
+    namespace diag {
+        static llvm::StringRef kindName(DiagnosticKind kind) {
+            switch (kind) {
+                case DiagnosticKind::error:
+                    return "error";
+                case DiagnosticKind::warning:
+                    return "warning";
+                case DiagnosticKind::output:
+                    return "output";
+            }
+
+            llvm_unreachable("All diagnostic kinds should be handled here");
+        }
+
+        // Structured sinks don't color errors and warnings, so only the trailing newline has to be removed.
+        static llvm::StringRef messageText(const DiagnosticInfo & diagnostic) {
+            llvm::StringRef text = diagnostic.text;
+            text.consume_back("\n");
+
+            return text;
+        }
+
+        static void writeArguments(llvm::json::OStream & json, const DiagnosticInfo & diagnostic) {
+            json.array([&] {
+                for (const DiagnosticArg & arg: diagnostic.args) {
+                    switch (arg.getKind()) {
+                        case DiagnosticArg::Kind::integer:
+                            json.value((int64_t)arg.getAsInteger());
+                            break;
+                        case DiagnosticArg::Kind::doubleValue:
+                            json.value(arg.getAsDouble());
+                            break;
+                        case DiagnosticArg::Kind::boolean:
+                            json.value(arg.getAsBoolean());
+                            break;
+                        case DiagnosticArg::Kind::string:
+                            json.value(arg.getAsString());
+                            break;
+                        default: {
+                            std::string string;
+                            llvm::raw_string_ostream os(string);
+                            DiagnosticEngine::formatArgInto(os, arg, diagnostic.sourceManager);
+
+                            json.value(os.str());
+                            break;
+                        }
+                    }
+                }
+            });
+        }
+
+        struct ResolvedLocation {
+            llvm::StringRef file;
+            unsigned int line, column;
+            size_t offset;
+        };
+
+        static llvm::Optional<ResolvedLocation> resolveLocation(const DiagnosticInfo & diagnostic) {
+            if (!diagnostic.sourceManager || diagnostic.location.isInvalid()) return llvm::None;
+
+            const llvm::SourceMgr & sourceMgr = diagnostic.sourceManager->getLLVMSourceMgr();
+
+            unsigned int bufferID = sourceMgr.FindBufferContainingLoc(diagnostic.location.llvm());
+            if (bufferID == 0) return llvm::None;
+
+            const llvm::MemoryBuffer * buffer = sourceMgr.getMemoryBuffer(bufferID);
+
+            ResolvedLocation location{buffer->getBufferIdentifier()};
+            std::tie(location.line, location.column) = diagnostic.sourceManager->getLineAndColumn(diagnostic.location);
+            location.offset = diagnostic.location.getPointer() - buffer->getBufferStart();
+
+            return location;
+        }
+
+        // SARIF columns count code points instead of bytes, so the UTF-8 continuation bytes before the location on
+        // its line are left out.
+        static unsigned int codePointColumn(const DiagnosticInfo & diagnostic, const ResolvedLocation & location) {
+            const char * pointer = diagnostic.location.getPointer();
+
+            unsigned int column = 1;
+            for (const char * it = pointer - (location.column - 1); it < pointer; ++it) {
+                if (((unsigned char)*it & 0xC0) != 0x80) ++column;
+            }
+
+            return column;
+        }
+
+
+        std::unique_ptr<DiagnosticSink> DiagnosticSink::create(DiagnosticOutputFormat format,
+                                                               llvm::raw_ostream & outputOS) {
+            switch (format) {
+                case DiagnosticOutputFormat::text:
+                    return std::make_unique<ConsoleDiagnosticSink>(outputOS);
+                case DiagnosticOutputFormat::json:
+                    return std::make_unique<JSONDiagnosticSink>(outputOS);
+                case DiagnosticOutputFormat::sarif:
+                    return std::make_unique<SARIFDiagnosticSink>(outputOS);
+            }
+
+            llvm_unreachable("All diagnostic output formats should be handled here");
+        }
+
+
+        constexpr size_t ConsoleDiagnosticSink::bufferSize;
+
+        ConsoleDiagnosticSink::ConsoleDiagnosticSink(llvm::raw_ostream & outputOS):
+            _outputOS(&outputOS), _errorColors(llvm::errs().has_colors()), _outputColors(outputOS.has_colors()) {}
+
+        ConsoleDiagnosticSink::~ConsoleDiagnosticSink() {
+            flush();
+        }
+
+        bool ConsoleDiagnosticSink::hasColors(DiagnosticKind kind) const {
+            return kind == DiagnosticKind::output ? _outputColors : _errorColors;
+        }
+
+        void ConsoleDiagnosticSink::consume(const DiagnosticInfo & diagnostic) {
+            if (diagnostic.kind == DiagnosticKind::output) {
+                getBuffer(*_outputOS).append(diagnostic.text.begin(), diagnostic.text.end());
+            } else if (diagnostic.sourceManager) {
+                basic::ColoredStringStream os(getBuffer(llvm::errs()), _errorColors);
+                diagnostic.sourceManager->printDiagnostic(os, diagnostic.text, diagnostic.kind, diagnostic.location);
+                os.flush();
+            } else {
+                basic::ColoredStringStream os(getBuffer(llvm::errs()), _errorColors);
+                os << basic::Color::bold << basic::Color::yellow << "juice: "
+                   << (diagnostic.kind == DiagnosticKind::error ? basic::Color::red : basic::Color::magenta)
+                   << kindName(diagnostic.kind) << ": " << basic::Color::reset << diagnostic.text;
+                os.flush();
+            }
+
+            flushIfFull();
+        }
+
+        void ConsoleDiagnosticSink::flush() {
+            if (!_bufferOS) return;
+
+            *_bufferOS << _buffer;
+            _bufferOS->flush();
+
+            _buffer.clear();
+            _bufferOS = nullptr;
+        }
+
+        void ConsoleDiagnosticSink::setOutputStream(llvm::raw_ostream & outputOS) {
+            flush();
+
+            _outputOS = &outputOS;
+            _outputColors = outputOS.has_colors();
+        }
+
+        std::string & ConsoleDiagnosticSink::getBuffer(llvm::raw_ostream & os) {
+            // Keeps the order of the messages if stderr and the output stream are the same terminal.
+            if (&os != _bufferOS) {
+                flush();
+                _bufferOS = &os;
+            }
+
+            return _buffer;
+        }
+
+
+        bool JSONDiagnosticSink::hasColors(DiagnosticKind kind) const {
+            return kind == DiagnosticKind::output && ConsoleDiagnosticSink::hasColors(kind);
+        }
+
+        void JSONDiagnosticSink::consume(const DiagnosticInfo & diagnostic) {
+            if (diagnostic.kind == DiagnosticKind::output) {
+                ConsoleDiagnosticSink::consume(diagnostic);
+                return;
+            }
+
+            llvm::raw_string_ostream os(getBuffer(llvm::errs()));
+            llvm::json::OStream json(os);
+
+            json.object([&] {
+                json.attribute("id", DiagnosticEngine::diagnosticNameFor(diagnostic.id));
+                json.attribute("kind", kindName(diagnostic.kind));
+
+                if (auto location = resolveLocation(diagnostic)) {
+                    json.attribute("file", location->file);
+                    json.attribute("line", (int64_t)location->line);
+                    json.attribute("column", (int64_t)location->column);
+                    json.attribute("offset", (int64_t)location->offset);
+                }
+
+                json.attribute("message", messageText(diagnostic));
+                json.attributeBegin("arguments");
+                writeArguments(json, diagnostic);
+                json.attributeEnd();
+            });
+
+            os << '\n';
+            os.flush();
+
+            flush();
+        }
+
+
+        SARIFDiagnosticSink::~SARIFDiagnosticSink() {
+            llvm::raw_string_ostream os(getBuffer(llvm::errs()));
+
+            if (!_hasStarted) writeStart(os);
+
+            os << (_hasResults ? "\n" : "") << "]}]}\n";
+            os.flush();
+
+            flush();
+        }
+
+        bool SARIFDiagnosticSink::hasColors(DiagnosticKind kind) const {
+            return kind == DiagnosticKind::output && ConsoleDiagnosticSink::hasColors(kind);
+        }
+
+        void SARIFDiagnosticSink::consume(const DiagnosticInfo & diagnostic) {
+            if (diagnostic.kind == DiagnosticKind::output) {
+                ConsoleDiagnosticSink::consume(diagnostic);
+                return;
+            }
+
+            llvm::raw_string_ostream os(getBuffer(llvm::errs()));
+
+            if (!_hasStarted) writeStart(os);
+
+            // Every result is on its own line, so the log stays readable without being pretty-printed.
+            os << (_hasResults ? ",\n" : "\n");
+            _hasResults = true;
+
+            llvm::json::OStream json(os);
+
+            json.object([&] {
+                json.attribute("ruleId", DiagnosticEngine::diagnosticNameFor(diagnostic.id));
+                json.attribute("level", kindName(diagnostic.kind));
+                json.attributeObject("message", [&] {
+                    json.attribute("text", messageText(diagnostic));
+                });
+
+                if (auto location = resolveLocation(diagnostic)) {
+                    json.attributeArray("locations", [&] {
+                        json.object([&] {
+                            json.attributeObject("physicalLocation", [&] {
+                                json.attributeObject("artifactLocation", [&] {
+                                    json.attribute("uri", location->file);
+                                });
+                                json.attributeObject("region", [&] {
+                                    json.attribute("startLine", (int64_t)location->line);
+                                    json.attribute("startColumn", (int64_t)codePointColumn(diagnostic, *location));
+                                    json.attribute("byteOffset", (int64_t)location->offset);
+                                });
+                            });
+                        });
+                    });
+                }
+
+                json.attributeObject("properties", [&] {
+                    json.attributeBegin("arguments");
+                    writeArguments(json, diagnostic);
+                    json.attributeEnd();
+                });
+            });
+
+            os.flush();
+
+            flush();
+        }
+
+        void SARIFDiagnosticSink::writeStart(llvm::raw_ostream & os) {
+            // The log can't be written with a single json::OStream, because its results are written as they arrive,
+            // so its beginning is written on its own and the result array is closed by hand.
+            os << R"({"$schema":"https://json.schemastore.org/sarif-2.1.0.json","version":"2.1.0","runs":[{"tool":)";
+
+            llvm::json::OStream json(os);
+            json.object([&] {
+                json.attributeObject("driver", [&] {
+                    json.attribute("name", "juice");
+                    json.attribute("version", basic::Version::getCurrentString());
+                    json.attribute("informationUri", "https://github.com/juice-lang/juice");
+                });
+            });
+
+            os << R"(,"columnKind":"unicodeCodePoints","results":[)";
+
+            _hasStarted = true;
+        }
+
+
+        void MemoryDiagnosticSink::consume(const DiagnosticInfo & diagnostic) {
+            _diagnostics.push_back({diagnostic.id, diagnostic.kind, diagnostic.location, diagnostic.text.str()});
+        }
+    }
+}
@@ -15,9 +15,10 @@
 #include <utility>
 
 #include "juice/Basic/ColoredStringStream.h"
-#include "juice/Basic/StringHelpers.h"
+#include "juice/Diagnostics/DiagnosticFormat.h"
+#include "juice/Diagnostics/DiagnosticSink.h"
+#include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FormatVariadic.h"
-#include "llvm/Support/FormatAdapters.h"
 
 namespace juice {
     namespace diag {
@@ -38,195 +39,129 @@ namespace juice {
             #include "juice/Diagnostics/Diagnostics.def"
         };
 
-        DiagnosticEngine::DiagnosticEngine(std::unique_ptr<basic::SourceManager> sourceManager,
-                                           llvm::raw_ostream & outputOS):
-                _sourceManager(std::move(sourceManager)), _outputOS(outputOS) {}
+        static constexpr const char * const diagnosticNames[] {
+            #define DIAG(KIND, ID, Text, Newline) #ID,
+            #include "juice/Diagnostics/Diagnostics.def"
+        };
 
-        void DiagnosticEngine::diagnose(basic::SourceLocation location, DiagnosticID id,
-                                        const std::vector<DiagnosticArg> & args) {
-            DiagnosticKind kind = diagnosticKindFor(id);
-            llvm::StringRef text(diagnosticStringFor(id));
-            bool newline = diagnosticNewlineFor(id);
+        static constexpr size_t diagnosticCount = sizeof(diagnosticStrings) / sizeof(*diagnosticStrings);
 
-            if (kind == DiagnosticKind::error) _hadError = true;
+        static constexpr size_t countFormatSegments() {
+            size_t count = 0;
+            for (const char * text: diagnosticStrings) {
+                count += DiagnosticFormatCompiler(text, nullptr).compile();
+            }
 
+            return count;
+        }
 
-            bool coloredOutput;
-            switch (kind) {
-                case DiagnosticKind::error:
-                case DiagnosticKind::warning:
-                    coloredOutput = llvm::errs().has_colors();
-                    break;
-                case DiagnosticKind::output:
-                    coloredOutput = _outputOS.has_colors();
-                    break;
-            }
+        static_assert(countFormatSegments() <= UINT16_MAX, "Too many diagnostic format segments");
 
+        // The segments of all diagnostic texts, those of the diagnostic with ID i are in the range from starts[i] to
+        // starts[i + 1].
+        struct FormatTable {
+            FormatSegment segments[countFormatSegments()];
+            uint16_t starts[diagnosticCount + 1];
+        };
 
-            std::string message;
-            basic::ColoredStringStream os(message, coloredOutput);
+        static constexpr FormatTable compileFormatTable() {
+            FormatTable table{};
 
-            os << basic::Color::bold;
+            size_t count = 0;
+            for (size_t i = 0; i < diagnosticCount; ++i) {
+                table.starts[i] = (uint16_t)count;
+                count += DiagnosticFormatCompiler(diagnosticStrings[i], table.segments + count).compile();
+            }
+            table.starts[diagnosticCount] = (uint16_t)count;
 
-            formatDiagnosticTextInto(os, text, args, this);
+            return table;
+        }
 
-            os << basic::Color::reset;
+        // Diagnostic texts are only parsed here, at compile time.
+        static constexpr FormatTable formatTable = compileFormatTable();
 
-            if (newline) os << '\n';
+        DiagnosticEngine::DiagnosticEngine(std::unique_ptr<basic::SourceManager> sourceManager,
+                                           std::shared_ptr<DiagnosticSink> sink):
+                _sourceManager(std::move(sourceManager)), _sink(std::move(sink)) {}
 
-            os.flush();
+        DiagnosticEngine::DiagnosticEngine(std::unique_ptr<basic::SourceManager> sourceManager,
+                                           llvm::raw_ostream & outputOS):
+                DiagnosticEngine(std::move(sourceManager), std::make_shared<ConsoleDiagnosticSink>(outputOS)) {}
 
-            if (kind == DiagnosticKind::output) _outputOS << message;
-            else {
-                _sourceManager->printDiagnostic(message, kind, location);
-            }
+        DiagnosticEngine::~DiagnosticEngine() = default;
+
+        void DiagnosticEngine::flush() {
+            _sink->flush();
         }
 
-        void DiagnosticEngine::diagnose(DiagnosticID id, const std::vector<DiagnosticArg> & args) {
+        void DiagnosticEngine::diagnose(basic::SourceLocation location, DiagnosticID id,
+                                        llvm::ArrayRef<DiagnosticArg> args) {
             DiagnosticKind kind = diagnosticKindFor(id);
-            llvm::StringRef text(diagnosticStringFor(id));
-            bool newline = diagnosticNewlineFor(id);
-
-            std::string message;
 
-            llvm::raw_string_ostream os(message);
+            if (kind == DiagnosticKind::error) _hadError = true;
 
-            os << basic::Color::bold;
+            formatMessageInto(_text, id, args, _sink->hasColors(kind), this);
 
-            switch (kind) {
-                case DiagnosticKind::error: {
-                    os << basic::Color::yellow << "juice: " << basic::Color::red << "error: " << basic::Color::reset
-                       << basic::Color::bold;
-                    break;
-                }
-                case DiagnosticKind::warning: {
-                    os << basic::Color::yellow << "juice: " << basic::Color::magenta << "error: " << basic::Color::reset
-                       << basic::Color::bold;
-                    break;
-                }
-                case DiagnosticKind::output:
-                    break;
-            }
+            _sink->consume({id, kind, location, args, _text, _sourceManager.get()});
+        }
 
-            formatDiagnosticTextInto(os, text, args, nullptr);
+        void DiagnosticEngine::diagnose(DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args) {
+            ConsoleDiagnosticSink sink(llvm::outs());
 
-            os << basic::Color::reset;
+            diagnose(sink, id, args);
+        }
 
-            if (newline) os << '\n';
+        void DiagnosticEngine::diagnose(DiagnosticSink & sink, DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args) {
+            DiagnosticKind kind = diagnosticKindFor(id);
 
-            os.flush();
+            std::string text;
+            formatMessageInto(text, id, args, sink.hasColors(kind), nullptr);
 
-            (kind == DiagnosticKind::error ? llvm::errs() : llvm::outs()) << message;
+            sink.consume({id, kind, basic::SourceLocation(), args, text, nullptr});
+            sink.flush();
         }
 
-        llvm::StringRef
-        DiagnosticEngine::skipToDelimiter(llvm::StringRef & text, char delimiter, bool * foundDelimiter) {
-            unsigned int depth = 0;
-            if (foundDelimiter) *foundDelimiter = false;
+        void DiagnosticEngine::formatMessageInto(std::string & text, DiagnosticID id, llvm::ArrayRef<DiagnosticArg> args,
+                                                 bool coloredOutput, DiagnosticEngine * diagnostics) {
+            text.clear();
+            basic::ColoredStringStream os(text, coloredOutput);
 
-            unsigned int i = 0;
-            for (unsigned int n = text.size(); i != n; ++i) {
-                if (text[i] == '{') {
-                    ++depth;
-                    continue;
-                }
-                if (depth > 0) {
-                    if (text[i] == '}')
-                        --depth;
-                    continue;
-                }
+            os << basic::Color::bold;
 
-                if (text[i] == delimiter) {
-                    if (foundDelimiter) *foundDelimiter = true;
-                    break;
-                }
-            }
+            formatDiagnosticInto(os, id, args, diagnostics);
 
-            assert(depth == 0 && "Unbalanced {} set in diagnostic text");
-            llvm::StringRef result = text.substr(0, i);
-            text = text.substr(i + 1);
-            return result;
-        }
+            os << basic::Color::reset;
 
-        void DiagnosticEngine::formatSelectionArgInto(llvm::raw_ostream & out, llvm::StringRef modifierArguments,
-                                                      const std::vector<DiagnosticArg> & args,
-                                                      unsigned int selectedIndex) {
-            bool foundPipe = false;
-            do {
-                assert((!modifierArguments.empty() || foundPipe) && "Index beyond bounds in %select modifier");
-                llvm::StringRef text = skipToDelimiter(modifierArguments, '|', &foundPipe);
-                if (selectedIndex == 0) {
-                    formatDiagnosticTextInto(out, text, args, nullptr);
-                    break;
-                }
-                --selectedIndex;
-            } while (true);
+            if (diagnosticNewlineFor(id)) os << '\n';
+
+            os.flush();
         }
 
-        void DiagnosticEngine::formatDiagnosticArgInto(llvm::raw_ostream & out, llvm::StringRef modifier,
-                                                       llvm::StringRef modifierArguments,
-                                                       const std::vector<DiagnosticArg> & args, unsigned int argIndex,
-                                                       DiagnosticEngine * diagnostics) {
-            if (modifier == "reset") {
-                out << basic::Color::reset << basic::Color::bold;
-                return;
-            }
-            DiagnosticArg arg = args[argIndex];
+        void DiagnosticEngine::formatArgInto(llvm::raw_ostream & out, const DiagnosticArg & arg,
+                                             const basic::SourceManager * sourceManager) {
             switch (arg.getKind()) {
-                case DiagnosticArg::Kind::integer: {
-                    if (modifier == "indent") {
-                        out << llvm::formatv("{0}", llvm::fmt_repeat("    ", arg.getAsInteger()));
-                    } else if (modifier == "select") {
-                        formatSelectionArgInto(out, modifierArguments, args, arg.getAsInteger());
-                    } else if (modifier == "s") {
-                        if (arg.getAsInteger() != 1)
-                            out << 's';
-                    } else {
-                        assert(modifier.empty() && "Improper modifier for integer argument");
-                        out << arg.getAsInteger();
-                    }
+                case DiagnosticArg::Kind::integer:
+                    out << arg.getAsInteger();
                     break;
-                }
-                case DiagnosticArg::Kind::doubleValue: {
-                    assert(modifier.empty() && "Improper modifier for double argument");
+                case DiagnosticArg::Kind::doubleValue:
                     out << llvm::formatv("{0}", arg.getAsDouble());
                     break;
-                }
-                case DiagnosticArg::Kind::boolean: {
-                    if (modifier == "if") {
-                        if (arg.getAsBoolean()) {
-                            formatDiagnosticTextInto(out, modifierArguments, args, diagnostics);
-                        }
-                    } else {
-                        assert(modifier.empty() && "Improper modifier for boolean argument");
-                        out << (arg.getAsBoolean() ? "true" : "false");
-                    }
+                case DiagnosticArg::Kind::boolean:
+                    out << (arg.getAsBoolean() ? "true" : "false");
                     break;
-                }
-                case DiagnosticArg::Kind::string: {
-                    assert(modifier.empty() && "Improper modifier for string argument");
+                case DiagnosticArg::Kind::string:
                     out << arg.getAsString();
                     break;
-                }
-                case DiagnosticArg::Kind::lexerToken: {
-                    assert(modifier.empty() && "Improper modifier for LexerToken argument");
-                    out << arg.getAsLexerToken()
-                        << (diagnostics != nullptr ? diagnostics->_sourceManager.get() : nullptr);
+                case DiagnosticArg::Kind::lexerToken:
+                    out << arg.getAsLexerToken() << sourceManager;
                     break;
-                }
-                case DiagnosticArg::Kind::color: {
-                    assert(modifier.empty() && "Improper modifier for Color argument");
+                case DiagnosticArg::Kind::color:
                     out << basic::Color::bold << arg.getAsColor();
                     break;
-                }
-                case DiagnosticArg::Kind::type: {
-                    assert(modifier.empty() && "Improper modifier for Type argument");
+                case DiagnosticArg::Kind::type:
                     out << arg.getAsType();
                     break;
-                }
                 case DiagnosticArg::Kind::types: {
-                    assert(modifier.empty() && "Improper modifier for vector of types argument");
-
                     const auto & types = arg.getAsTypes();
 
                     out << '{';
@@ -241,67 +176,86 @@ namespace juice {
 
                     break;
                 }
-                case DiagnosticArg::Kind::typeRepr: {
-                    assert(modifier.empty() && "Improper modifier for TypeRepr argument");
-                    out << arg.getAsTypeRepr();
-                    break;
-                }
-                case DiagnosticArg::Kind::errorCode: {
-                    assert(modifier.empty() && "Improper modifier for error_code argument");
+                case DiagnosticArg::Kind::errorCode:
                     out << arg.getAsErrorCode().message();
                     break;
-                }
             }
         }
 
-        void DiagnosticEngine::formatDiagnosticTextInto(llvm::raw_ostream & out, llvm::StringRef text,
-                                                        const std::vector<DiagnosticArg> & args,
-                                                        DiagnosticEngine * diagnostics) {
-            while (!text.empty()) {
-                size_t percent = text.find('%');
-                if (percent == llvm::StringRef::npos) {
-                    out << text;
-                    break;
-                }
-
-                out << text.take_front(percent);
-                text = text.substr(percent + 1);
-
-                if (text[0] == '%') {
-                    out << '%';
-                    text = text.drop_front();
+        void DiagnosticEngine::formatSegmentsInto(llvm::raw_ostream & out, const char * text,
+                                                  const FormatSegment * begin, const FormatSegment * end,
+                                                  llvm::ArrayRef<DiagnosticArg> args,
+                                                  DiagnosticEngine * diagnostics) {
+            for (const FormatSegment * segment = begin; segment < end; ++segment) {
+                if (segment->kind == FormatSegment::Kind::text) {
+                    out << llvm::StringRef(text + segment->offset, segment->length);
                     continue;
                 }
 
-                llvm::StringRef modifier;
-                {
-                    size_t length = text.find_if_not(basic::isAlpha);
-                    modifier = text.substr(0, length);
-                    text = text.substr(length);
+                if (segment->kind == FormatSegment::Kind::reset) {
+                    out << basic::Color::reset << basic::Color::bold;
+                    continue;
                 }
 
-                llvm::StringRef modifierArguments;
-                if (text[0] == '{') {
-                    text = text.substr(1);
-                    modifierArguments = skipToDelimiter(text, '}');
-                }
+                assert(segment->argIndex < args.size() && "Out-of-range argument index");
+                const DiagnosticArg & arg = args[segment->argIndex];
+
+                switch (segment->kind) {
+                    case FormatSegment::Kind::argument:
+                        formatArgInto(out, arg, diagnostics != nullptr ? diagnostics->_sourceManager.get() : nullptr);
+                        break;
+                    case FormatSegment::Kind::indent:
+                        assert(arg.getKind() == DiagnosticArg::Kind::integer && "Improper argument for %indent");
+                        out.indent(arg.getAsInteger() * 4);
+                        break;
+                    case FormatSegment::Kind::plural:
+                        assert(arg.getKind() == DiagnosticArg::Kind::integer && "Improper argument for %s");
+                        if (arg.getAsInteger() != 1)
+                            out << 's';
+                        break;
+                    case FormatSegment::Kind::select: {
+                        assert(arg.getKind() == DiagnosticArg::Kind::integer && "Improper argument for %select");
 
-                unsigned int argIndex;
+                        const FormatSegment * selectEnd = segment + 1 + segment->length;
 
-                if (modifier != "reset") {
-                    size_t length = text.find_if_not(basic::isDigit);
-                    bool Result = text.substr(0, length).getAsInteger(10, argIndex);
-                    assert(!Result && "Unparseable argument index value?");
-                    (void)Result;
-                    assert(argIndex < args.size() && "Out-of-range argument index");
+                        const FormatSegment * alternative = segment + 1;
+                        for (u_int64_t i = arg.getAsInteger(); i > 0; --i) {
+                            alternative += 1 + alternative->length;
+                            assert(alternative < selectEnd && "Index beyond bounds in %select modifier");
+                        }
 
-                    text = text.substr(length);
-                } else argIndex = 0;
+                        formatSegmentsInto(out, text, alternative + 1, alternative + 1 + alternative->length, args,
+                                           diagnostics);
 
-                formatDiagnosticArgInto(out, modifier, modifierArguments, args, argIndex, diagnostics);
+                        segment = selectEnd - 1;
+                        break;
+                    }
+                    case FormatSegment::Kind::condition:
+                        assert(arg.getKind() == DiagnosticArg::Kind::boolean && "Improper argument for %if");
+
+                        if (arg.getAsBoolean())
+                            formatSegmentsInto(out, text, segment + 1, segment + 1 + segment->length, args,
+                                               diagnostics);
+
+                        segment += segment->length;
+                        break;
+                    case FormatSegment::Kind::text:
+                    case FormatSegment::Kind::alternative:
+                    case FormatSegment::Kind::reset:
+                        llvm_unreachable("These segments are handled above or skipped by their %select");
+                }
             }
         }
 
+        void DiagnosticEngine::formatDiagnosticInto(llvm::raw_ostream & out, DiagnosticID id,
+                                                    llvm::ArrayRef<DiagnosticArg> args,
+                                                    DiagnosticEngine * diagnostics) {
+            auto index = (unsigned int)id;
+
+            formatSegmentsInto(out, diagnosticStringFor(id), formatTable.segments + formatTable.starts[index],
+                               formatTable.segments + formatTable.starts[index + 1], args, diagnostics);
+        }
+
         constexpr DiagnosticKind DiagnosticEngine::diagnosticKindFor(DiagnosticID id) {
             return diagnosticKinds[(unsigned int)id];
         }
@@ -313,5 +267,9 @@ namespace juice {
         constexpr bool DiagnosticEngine::diagnosticNewlineFor(DiagnosticID id) {
             return diagnosticNewlines[(unsigned int)id];
         }
+
+        const char * DiagnosticEngine::diagnosticNameFor(DiagnosticID id) {
+            return diagnosticNames[(unsigned int)id];
+        }
     }
 }
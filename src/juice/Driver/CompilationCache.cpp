@@ -0,0 +1,165 @@
+// src/juice/Driver/CompilationCache.cpp - Persistent on-disk cache of compiled object files
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Driver/CompilationCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "juice/Basic/Version.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+
+namespace juice {
+    namespace driver {
+        namespace {
+            // Every part of the key is terminated by a null byte, so that e.g. the CPU "ab" with the features "c"
+            // doesn't hash the same as the CPU "a" with the features "bc".
+            void addToHash(llvm::MD5 & hash, llvm::StringRef part) {
+                static const uint8_t terminator = 0;
+
+                hash.update(part);
+                hash.update(terminator);
+            }
+
+            // The version only changes with releases, so the size and modification time of the compiler itself stand
+            // in for the build, to keep builds of the same version from sharing entries.
+            void addBuildToHash(llvm::MD5 & hash, llvm::StringRef executablePath) {
+                llvm::sys::fs::file_status status;
+                if (llvm::sys::fs::status(executablePath, status))
+                    return;
+
+                const uint64_t build[] = {
+                    status.getSize(),
+                    static_cast<uint64_t>(llvm::sys::toTimeT(status.getLastModificationTime()))
+                };
+                hash.update(llvm::makeArrayRef(reinterpret_cast<const uint8_t *>(build), sizeof(build)));
+            }
+        }
+
+        CompilationCache::CompilationCache(std::string directory): _directory(std::move(directory)) {}
+
+        std::shared_ptr<const CompilationCache> CompilationCache::create(llvm::StringRef directory) {
+            llvm::SmallString<128> path(directory);
+
+            if (path.empty()) {
+                if (!llvm::sys::path::cache_directory(path))
+                    return nullptr;
+
+                llvm::sys::path::append(path, "juice");
+            }
+
+            if (llvm::sys::fs::create_directories(path))
+                return nullptr;
+
+            return std::shared_ptr<const CompilationCache>(new CompilationCache(std::string(path)));
+        }
+
+        llvm::Optional<std::string> CompilationCache::computeKey(llvm::StringRef executablePath,
+                                                                 llvm::StringRef inputPath, Frontend::Action action,
+                                                                 const irgen::CodeGenOptions & options) {
+            auto buffer = llvm::MemoryBuffer::getFile(inputPath);
+            if (!buffer)
+                return llvm::None;
+
+            llvm::MD5 hash;
+
+            addToHash(hash, basic::Version::getCurrentString());
+            if (auto llvmVersion = basic::Version::getLLVM())
+                addToHash(hash, llvmVersion->getString());
+            addBuildToHash(hash, executablePath);
+
+            addToHash(hash, llvm::sys::getDefaultTargetTriple());
+
+            const uint8_t flags[] = {
+                static_cast<uint8_t>(action),
+                static_cast<uint8_t>(options.optimizationLevel)
+            };
+            hash.update(flags);
+
+            // "native" means something different on every machine, so the actual host CPU has to be part of the key.
+            if (options.cpu == "native") {
+                addToHash(hash, llvm::sys::getHostCPUName());
+
+                llvm::StringMap<bool> hostFeatures;
+                llvm::SmallVector<std::string, 64> enabledFeatures;
+                if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+                    for (const auto & feature: hostFeatures) {
+                        if (feature.getValue())
+                            enabledFeatures.push_back(feature.getKey().str());
+                    }
+                }
+
+                std::sort(enabledFeatures.begin(), enabledFeatures.end());
+                for (const std::string & feature: enabledFeatures)
+                    addToHash(hash, feature);
+            } else {
+                addToHash(hash, options.cpu);
+            }
+
+            addToHash(hash, options.features);
+
+            hash.update((*buffer)->getBuffer());
+
+            llvm::MD5::MD5Result result;
+            hash.final(result);
+
+            return std::string(result.digest());
+        }
+
+        bool CompilationCache::retrieve(llvm::StringRef key, llvm::StringRef outputPath) const {
+            std::string entryPath = getEntryPath(key);
+
+            if (!llvm::sys::fs::exists(entryPath))
+                return false;
+
+            return !llvm::sys::fs::copy_file(entryPath, outputPath);
+        }
+
+        void CompilationCache::store(llvm::StringRef key, llvm::StringRef outputPath) const {
+            llvm::SmallString<128> model(_directory);
+            llvm::sys::path::append(model, key + "-%%%%%%%%.tmp");
+
+            // The entry is written to a unique file first and then renamed, so that concurrent compilations never
+            // see a partially written entry.
+            llvm::SmallString<128> tempPath;
+            if (llvm::sys::fs::createUniqueFile(model, tempPath))
+                return;
+
+            if (llvm::sys::fs::copy_file(outputPath, tempPath) || llvm::sys::fs::rename(tempPath, getEntryPath(key))) {
+                llvm::sys::fs::remove(tempPath);
+                return;
+            }
+
+            // Entries that haven't been used for a week, or that make the cache take up more than 75% of the free
+            // space, are removed. The directory is only scanned if it hasn't been pruned in the last 20 minutes.
+            llvm::pruneCache(_directory, llvm::CachePruningPolicy());
+        }
+
+        std::string CompilationCache::getEntryPath(llvm::StringRef key) const {
+            llvm::SmallString<128> path(_directory);
+            // llvm::pruneCache only removes files with this prefix.
+            llvm::sys::path::append(path, "llvmcache-" + key + ".o");
+
+            return std::string(path);
+        }
+    }
+}
@@ -13,6 +13,8 @@
 
 #include "juice/Driver/FrontendDriver.h"
 #include "juice/Driver/MainDriver.h"
+#include "juice/Driver/REPLDriver.h"
+#include "juice/Driver/RunDriver.h"
 #include "llvm/Support/CommandLine.h"
 
 namespace juice {
@@ -24,6 +26,10 @@ namespace juice {
                 if (*subcommand) {
                     if (subcommand == &frontendSubcommand) {
                         driver = new FrontendDriver();
+                    } else if (subcommand == &replSubcommand) {
+                        driver = new REPLDriver();
+                    } else if (subcommand == &runSubcommand) {
+                        driver = new RunDriver();
                     } else if (subcommand == &*llvm::cl::TopLevelSubCommand) {
                         driver = new MainDriver(firstArg);
                     } else {
@@ -0,0 +1,34 @@
+// src/juice/Driver/DriverOptions.cpp - Command line option definitions shared between Driver subclasses
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Driver/DriverOptions.h"
+
+#include "juice/IRGen/CodeGenOptions.h"
+
+namespace juice {
+    namespace driver {
+        namespace options {
+            llvm::cl::desc optimizationLevelDescription() {
+                return llvm::cl::desc("Choose optimization level");
+            }
+
+            llvm::cl::ValuesClass optimizationLevelValues() {
+                return llvm::cl::values(
+                    clEnumValN(irgen::OptimizationLevel::O0, "0", "No optimization"),
+                    clEnumValN(irgen::OptimizationLevel::O1, "1", "Enable basic optimizations"),
+                    clEnumValN(irgen::OptimizationLevel::O2, "2", "Enable default optimizations"),
+                    clEnumValN(irgen::OptimizationLevel::O3, "3", "Enable aggressive optimizations"),
+                    clEnumValN(irgen::OptimizationLevel::Os, "s", "Optimize for code size")
+                );
+            }
+        }
+    }
+}
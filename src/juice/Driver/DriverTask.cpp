@@ -13,14 +13,19 @@
 
 #include <chrono>
 #include <utility>
+#include <vector>
 
 #include "juice/Basic/Error.h"
 #include "juice/Basic/Process.h"
 #include "juice/Diagnostics/DiagnosticError.h"
 #include "juice/Platform/Macros.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/Threading.h"
 
 #if OS_MAC
 #include "juice/Platform/MacOS/SDKPath.h"
@@ -30,9 +35,10 @@ namespace juice {
     namespace driver {
         DriverTask::DriverTask(Kind kind, std::string executablePath, llvm::SmallVector<std::string, 16> arguments,
                                llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs,
-                               std::string outputPath, bool outputIsTemporary):
+                               std::string outputPath, bool outputIsTemporary, unsigned int jobs):
             _kind(kind), _executablePath(std::move(executablePath)), _arguments(std::move(arguments)),
-            _inputs(std::move(inputs)), _outputPath(std::move(outputPath)), _outputIsTemporary(outputIsTemporary) {}
+            _inputs(std::move(inputs)), _outputPath(std::move(outputPath)), _outputIsTemporary(outputIsTemporary),
+            _jobs(jobs) {}
 
         llvm::Expected<bool> DriverTask::executeIfNecessary(llvm::sys::TimePoint<> timePoint) {
             if (_outputPath == "-") {
@@ -75,6 +81,15 @@ namespace juice {
             }
 
 
+            if (auto error = run())
+                return std::move(error);
+
+            return true;
+        }
+
+        llvm::Error DriverTask::run() {
+            llvm::TimeTraceScope traceScope("Execute", _executablePath);
+
             llvm::SmallVector<llvm::StringRef, 16> arguments = {
                 _executablePath
             };
@@ -88,7 +103,7 @@ namespace juice {
                 return createExecutionError(exitCode);
             }
 
-            return true;
+            return llvm::Error::success();
         }
 
         llvm::Error DriverTask::createExecutionError(int exitCode) {
@@ -108,15 +123,46 @@ namespace juice {
         llvm::Expected<bool> DriverTask::executeInputs(llvm::sys::TimePoint<> timePoint) {
             bool someInputWasExecuted = false;
 
-            for (auto & input: _inputs) {
-                auto wasExecuted = input->executeIfNecessary(timePoint);
-                if (auto error = wasExecuted.takeError())
-                    return error;
+            std::vector<llvm::Optional<llvm::Expected<bool>>> results(_inputs.size());
 
-                if (wasExecuted)
+            // Every input is executed even if another one fails, so that all errors are reported at once.
+            if (_jobs == 1 || _inputs.size() <= 1) {
+                for (size_t i = 0, n = _inputs.size(); i < n; ++i) {
+                    results[i].emplace(_inputs[i]->executeIfNecessary(timePoint));
+                }
+            } else {
+                llvm::ThreadPool pool(llvm::hardware_concurrency(_jobs));
+
+                // Each worker records its events into its own lane of the trace, which is merged into the trace of
+                // the main thread when the task is done.
+                bool isTracing = llvm::timeTraceProfilerEnabled();
+
+                for (size_t i = 0, n = _inputs.size(); i < n; ++i) {
+                    pool.async([this, &results, i, timePoint, isTracing] {
+                        if (isTracing) llvm::timeTraceProfilerInitialize(traceGranularity, "juice");
+
+                        results[i].emplace(_inputs[i]->executeIfNecessary(timePoint));
+
+                        if (isTracing) llvm::timeTraceProfilerFinishThread();
+                    });
+                }
+
+                pool.wait();
+            }
+
+            llvm::Error errors = llvm::Error::success();
+
+            for (auto & result: results) {
+                if (auto error = result->takeError()) {
+                    errors = llvm::joinErrors(std::move(errors), std::move(error));
+                } else if (**result) {
                     someInputWasExecuted = true;
+                }
             }
 
+            if (errors)
+                return std::move(errors);
+
             return someInputWasExecuted;
         }
 
@@ -145,12 +191,18 @@ namespace juice {
 
         CompilationTask::CompilationTask(std::string executablePath, llvm::SmallVector<std::string, 16> arguments,
                                          llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs,
-                                         std::string outputPath, bool outputIsTemporary):
+                                         std::string outputPath, bool outputIsTemporary,
+                                         Frontend::Action frontendAction, irgen::CodeGenOptions options,
+                                         bool inProcess, std::shared_ptr<const CompilationCache> cache):
             DriverTask(Kind::compilation, std::move(executablePath), std::move(arguments), std::move(inputs),
-                       std::move(outputPath), outputIsTemporary) {}
+                       std::move(outputPath), outputIsTemporary),
+            _frontendAction(frontendAction), _options(std::move(options)), _inProcess(inProcess),
+            _cache(std::move(cache)) {}
 
         llvm::Expected<std::unique_ptr<CompilationTask>>
-        CompilationTask::create(const char * firstArg, DriverAction action, std::unique_ptr<InputTask> input) {
+        CompilationTask::create(const char * firstArg, DriverAction action, const irgen::CodeGenOptions & options,
+                                bool inProcess, std::shared_ptr<const CompilationCache> cache,
+                                std::unique_ptr<InputTask> input) {
             llvm::StringRef inputBaseName = llvm::sys::path::stem(input->getOutputPathRef());
 
             llvm::SmallString<128> tempOutputPath;
@@ -159,61 +211,135 @@ namespace juice {
                                                                        inputBaseName, errorCode);
             }
 
-            return CompilationTask::create(firstArg, action, std::move(input), std::string(tempOutputPath), true);
+            return CompilationTask::create(firstArg, action, options, inProcess, std::move(cache), std::move(input),
+                                           std::string(tempOutputPath), true);
         }
 
         std::unique_ptr<CompilationTask>
-        CompilationTask::create(const char * firstArg, DriverAction action, std::unique_ptr<InputTask> input,
-                                std::string outputPath, bool outputIsTemporary) {
+        CompilationTask::create(const char * firstArg, DriverAction action, const irgen::CodeGenOptions & options,
+                                bool inProcess, std::shared_ptr<const CompilationCache> cache,
+                                std::unique_ptr<InputTask> input, std::string outputPath, bool outputIsTemporary) {
             std::string executablePath = basic::getMainExecutablePath(firstArg);
 
             std::string actionString;
+            Frontend::Action frontendAction;
             switch (action) {
                 case DriverAction::dumpParse:
                     actionString = "--dump-parse";
+                    frontendAction = Frontend::Action::dumpParse;
                     break;
                 case DriverAction::dumpAST:
                     actionString = "--dump-ast";
+                    frontendAction = Frontend::Action::dumpAST;
                     break;
                 case DriverAction::emitIR:
                     actionString = "--emit-ir";
+                    frontendAction = Frontend::Action::emitIR;
                     break;
                 case DriverAction::emitObject:
                 case DriverAction::emitExecutable:
                     actionString = "--emit-object";
+                    frontendAction = Frontend::Action::emitObject;
+                    break;
+            }
+
+            std::string optimizationString;
+            switch (options.optimizationLevel) {
+                case irgen::OptimizationLevel::O0:
+                    optimizationString = "-O0";
+                    break;
+                case irgen::OptimizationLevel::O1:
+                    optimizationString = "-O1";
+                    break;
+                case irgen::OptimizationLevel::O2:
+                    optimizationString = "-O2";
+                    break;
+                case irgen::OptimizationLevel::O3:
+                    optimizationString = "-O3";
+                    break;
+                case irgen::OptimizationLevel::Os:
+                    optimizationString = "-Os";
                     break;
             }
 
             llvm::SmallVector<std::string, 16> arguments = {
                 "frontend",
                 actionString,
+                optimizationString,
                 "--input-file",
                 input->getOutputPath(),
                 "--output-file",
                 outputPath
             };
 
+            if (!options.cpu.empty()) {
+                arguments.push_back("--target-cpu");
+                arguments.push_back(options.cpu);
+            }
+
+            if (!options.features.empty()) {
+                arguments.push_back("--target-features");
+                arguments.push_back(options.features);
+            }
+
             llvm::SmallVector<std::unique_ptr<DriverTask>, 4> inputs;
             inputs.push_back(std::move(input));
 
             return std::unique_ptr<CompilationTask>(
                 new CompilationTask(std::move(executablePath), std::move(arguments), std::move(inputs),
-                                    std::move(outputPath), outputIsTemporary));
+                                    std::move(outputPath), outputIsTemporary, frontendAction, options, inProcess,
+                                    std::move(cache)));
         }
 
         llvm::Error CompilationTask::createExecutionError(int exitCode) {
             return llvm::make_error<basic::AlreadyHandledError>();
         }
 
+        llvm::Error CompilationTask::run() {
+            llvm::TimeTraceScope traceScope("Compile", getInputs().front()->getOutputPathRef());
+
+            if (!_cache || _frontendAction != Frontend::Action::emitObject || getOutputPathRef() == "-")
+                return runFrontend();
+
+            auto key = CompilationCache::computeKey(getExecutablePathRef(), getInputs().front()->getOutputPathRef(),
+                                                    _frontendAction, _options);
+            if (!key)
+                return runFrontend();
+
+            if (_cache->retrieve(*key, getOutputPathRef()))
+                return llvm::Error::success();
+
+            if (auto error = runFrontend())
+                return error;
+
+            _cache->store(*key, getOutputPathRef());
+
+            return llvm::Error::success();
+        }
+
+        llvm::Error CompilationTask::runFrontend() {
+            if (!_inProcess) return DriverTask::run();
+
+            Frontend frontend(_frontendAction, getInputs().front()->getOutputPath(), getOutputPath(), _options);
+
+            int exitCode = frontend.execute();
+
+            if (exitCode != 0) {
+                return createExecutionError(exitCode);
+            }
+
+            return llvm::Error::success();
+        }
+
         LinkingTask::LinkingTask(std::string executablePath, llvm::SmallVector<std::string, 16> arguments,
                                  llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs,
-                                 std::string outputPath):
+                                 std::string outputPath, unsigned int jobs):
             DriverTask(Kind::linking, std::move(executablePath), std::move(arguments), std::move(inputs),
-                       std::move(outputPath), false) {}
+                       std::move(outputPath), false, jobs) {}
 
         llvm::Expected<std::unique_ptr<LinkingTask>>
         LinkingTask::create(llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs,
-                            std::string outputPath) {
+                            std::string outputPath, unsigned int jobs) {
             auto executablePath = llvm::sys::findProgramByName("ld");
             if (std::error_code errorCode = executablePath.getError()) {
                 return basic::createError<diag::StaticDiagnosticError>(diag::DiagnosticID::error_finding_program,
@@ -245,7 +371,19 @@ namespace juice {
 
             return std::unique_ptr<LinkingTask>(
                 new LinkingTask(std::move(*executablePath), std::move(arguments), std::move(inputs),
-                                std::move(outputPath)));
+                                std::move(outputPath), jobs));
+        }
+
+        BatchTask::BatchTask(llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs, unsigned int jobs):
+            DriverTask(Kind::batch, "", {}, std::move(inputs), "", false, jobs) {}
+
+        std::unique_ptr<BatchTask>
+        BatchTask::create(llvm::SmallVectorImpl<std::unique_ptr<DriverTask>> && inputs, unsigned int jobs) {
+            return std::unique_ptr<BatchTask>(new BatchTask(std::move(inputs), jobs));
+        }
+
+        llvm::Expected<bool> BatchTask::executeIfNecessary(llvm::sys::TimePoint<> timePoint) {
+            return executeInputs(timePoint);
         }
     }
 }
@@ -0,0 +1,172 @@
+// src/juice/Driver/Frontend.cpp - Frontend class, runs the compiler pipeline on a single source file
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Driver/Frontend.h"
+
+#include <cstdio>
+#include <system_error>
+#include <utility>
+
+#include "juice/AST/ASTContext.h"
+#include "juice/Basic/Error.h"
+#include "juice/Basic/SourceManager.h"
+#include "juice/Diagnostics/DiagnosticError.h"
+#include "juice/Diagnostics/Diagnostics.h"
+#include "juice/IRGen/IRGen.h"
+#include "juice/IRGen/JIT.h"
+#include "juice/Parser/Lexer.h"
+#include "juice/Parser/Parser.h"
+#include "juice/Sema/TypeChecker.h"
+#include "juice/Sema/TypeCheckedStatementAST.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/PassTimingInfo.h"
+
+namespace juice {
+    namespace driver {
+        Frontend::Frontend(Action action, std::string inputFile, std::string outputFile,
+                           irgen::CodeGenOptions options):
+            _action(action), _inputFile(std::move(inputFile)), _outputFile(std::move(outputFile)),
+            _options(std::move(options)) {}
+
+        FrontendStatistics & Frontend::enableStatistics() {
+            if (!_statistics) _statistics = std::make_unique<FrontendStatistics>();
+
+            return *_statistics;
+        }
+
+        diag::DiagnosticSink & Frontend::getDiagnosticSink() {
+            // Output diagnostics can only be written once the output stream has been opened, so they go to stdout
+            // until then.
+            if (!_diagnosticSink) _diagnosticSink = diag::DiagnosticSink::create(_diagnosticOutputFormat, llvm::outs());
+
+            return *_diagnosticSink;
+        }
+
+        int Frontend::execute() {
+            llvm::StringRef filePath(_inputFile);
+
+            llvm::TimeTraceScope traceScope("Frontend", filePath);
+
+            diag::DiagnosticSink & sink = getDiagnosticSink();
+
+            auto manager = basic::SourceManager::mainFile(filePath);
+            if (manager == nullptr) {
+                diag::DiagnosticEngine::diagnose(sink, diag::DiagnosticID::file_not_found, filePath);
+                return 1;
+            }
+
+            auto expectedOutputOS = getOutputOS();
+            if (basic::handleAllErrors(expectedOutputOS.takeError(), [&](const diag::StaticDiagnosticError & error) {
+                error.diagnose(sink);
+            })) {
+                return 1;
+            }
+
+            llvm::raw_pwrite_stream & outputOS = expectedOutputOS.get();
+
+            sink.setOutputStream(outputOS);
+            _diagnostics = std::make_shared<diag::DiagnosticEngine>(std::move(manager), _diagnosticSink);
+
+            ast::ASTContext context(timePhase(Phase::lex, [&] {
+                return parser::Lexer(_diagnostics->getBuffer()).tokenize();
+            }));
+            parser::Parser juiceParser(context, _diagnostics);
+
+            auto ast = timePhase(Phase::parse, [&] { return juiceParser.parseModule(); });
+
+            if (_statistics) {
+                _statistics->setTokenCount(context.getTokens().size());
+                _statistics->setParsedNodeCount(context.getNodeCount());
+                _statistics->setASTBytes(context.getBytesAllocated());
+            }
+
+            // The parser recovers from syntax errors, so the AST is dumped even if it is incomplete.
+            if (_action == Action::dumpParse) {
+                timePhase(Phase::emit, [&] { ast->diagnoseInto(context, *_diagnostics, 0); });
+
+                return _diagnostics->hadError() ? 1 : 0;
+            }
+
+            if (!_diagnostics->hadError()) {
+                sema::TypeChecker typeChecker(context, ast, _diagnostics);
+                auto typeCheckResult = timePhase(Phase::typeCheck, [&] { return typeChecker.typeCheck(); });
+
+                if (_statistics) {
+                    _statistics->setTypeCheckedNodeCount(context.getNodeCount() - _statistics->getParsedNodeCount());
+                    _statistics->setASTBytes(context.getBytesAllocated());
+                }
+
+                if (!_diagnostics->hadError()) {
+                    if (_action == Action::dumpAST) {
+                        timePhase(Phase::emit, [&] { typeCheckResult.ast->diagnoseInto(context, *_diagnostics, 0); });
+
+                        return 0;
+                    }
+
+                    irgen::IRGen codegen(context, typeCheckResult, _diagnostics, _options);
+
+                    llvm::TimePassesHandler * passTimer = _statistics ? &_statistics->getPassTimer() : nullptr;
+
+                    if (timePhase(Phase::generateIR, [&] { return codegen.generate(); })
+                        && timePhase(Phase::optimize, [&] { return codegen.optimize(passTimer); })) {
+                        if (_action == Action::run)
+                            return run(codegen);
+
+                        if (_action == Action::emitIR) {
+                            timePhase(Phase::emit, [&] { codegen.dumpProgram(outputOS); });
+
+                            return 0;
+                        }
+
+                        if (timePhase(Phase::emit, [&] { return codegen.emitObject(outputOS); })) {
+                            return 0;
+                        }
+                    }
+                }
+            }
+
+            return 1;
+        }
+
+        int Frontend::run(irgen::IRGen & codegen) {
+            auto jit = irgen::JIT::create(_options);
+            if (!jit || !jit->addModule(codegen.takeModule())) return 1;
+
+            irgen::JIT::Function mainFunction = jit->lookup("main");
+            if (!mainFunction) return 1;
+
+            // The generated code prints through the C standard library, so both streams have to be flushed to keep
+            // the output in order.
+            llvm::outs().flush();
+            int exitCode = mainFunction();
+            std::fflush(stdout);
+
+            return exitCode;
+        }
+
+        llvm::Expected<llvm::raw_pwrite_stream &> Frontend::getOutputOS() {
+            if (_outputFile == "-") {
+                return llvm::outs();
+            } else if (_outputOS) {
+                return *_outputOS;
+            } else {
+                std::error_code errorCode;
+                _outputOS = std::make_unique<llvm::raw_fd_ostream>(_outputFile, errorCode);
+
+                if (errorCode)
+                    return basic::createError<diag::StaticDiagnosticError>(
+                        diag::DiagnosticID::error_opening_output_file, (llvm::StringRef)_outputFile, errorCode);
+
+                return *_outputOS;
+            }
+        }
+    }
+}
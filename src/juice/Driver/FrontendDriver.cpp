@@ -11,20 +11,12 @@
 
 #include "juice/Driver/FrontendDriver.h"
 
-#include <memory>
 #include <string>
-#include <utility>
+#include <system_error>
 
-#include "juice/Basic/Error.h"
-#include "juice/Basic/RawStreamHelpers.h"
-#include "juice/Basic/SourceManager.h"
-#include "juice/Diagnostics/DiagnosticError.h"
 #include "juice/Diagnostics/Diagnostics.h"
-#include "juice/IRGen/IRGen.h"
-#include "juice/Parser/Parser.h"
-#include "juice/Sema/TypeChecker.h"
-#include "juice/Sema/TypeCheckedStatementAST.h"
-#include "llvm/ADT/StringRef.h"
+#include "juice/Driver/DriverOptions.h"
+#include "llvm/Support/raw_ostream.h"
 
 namespace juice {
     namespace driver {
@@ -53,87 +45,88 @@ namespace juice {
             llvm::cl::Required
         );
 
+        llvm::cl::opt<irgen::OptimizationLevel> FrontendDriver::optimizationLevel(
+            llvm::cl::sub(frontendSubcommand),
+            "O",
+            llvm::cl::Prefix,
+            options::optimizationLevelDescription(),
+            options::optimizationLevelValues(),
+            llvm::cl::init(irgen::OptimizationLevel::O0)
+        );
 
-        FrontendDriver::~FrontendDriver() {
-            delete _outputOS;
-        }
-
-
-        int FrontendDriver::execute() {
-            llvm::StringRef filePath(inputFile);
-
-            auto manager = basic::SourceManager::mainFile(filePath);
-            if (manager == nullptr) {
-                diag::DiagnosticEngine::diagnose(diag::DiagnosticID::file_not_found, filePath);
-                return 1;
-            }
-
-            auto expectedOutputOS = getOutputOS();
-            if (basic::handleAllErrors(expectedOutputOS.takeError(), [](const diag::StaticDiagnosticError & error) {
-                error.diagnose();
-            })) {
-                return 1;
-            }
-
-            llvm::raw_pwrite_stream & outputOS = expectedOutputOS.get();
-
-            auto diagnostics = std::make_shared<diag::DiagnosticEngine>(std::move(manager), outputOS);
-
-            parser::Parser juiceParser(diagnostics);
-
-            auto ast = juiceParser.parseModule();
+        llvm::cl::opt<std::string> FrontendDriver::targetCPU(
+            llvm::cl::sub(frontendSubcommand),
+            "target-cpu",
+            llvm::cl::desc("Generate code for the given CPU, or for the host CPU and its features if 'native'"),
+            llvm::cl::value_desc("cpu-name")
+        );
 
-            if (ast) {
-                if (action == Action::dumpParse) {
-                    ast->diagnoseInto(*diagnostics, 0);
+        llvm::cl::opt<std::string> FrontendDriver::targetFeatures(
+            llvm::cl::sub(frontendSubcommand),
+            "target-features",
+            llvm::cl::desc("Enable (+) or disable (-) target features, e.g. '+avx2,-bmi2'"),
+            llvm::cl::value_desc("a1,+a2,-a3,...")
+        );
 
-                    return 0;
-                }
+        llvm::cl::opt<diag::DiagnosticOutputFormat> FrontendDriver::diagnosticsFormat(
+            llvm::cl::sub(frontendSubcommand),
+            "diagnostics-format",
+            llvm::cl::desc("Choose the format of errors and warnings"),
+            llvm::cl::values(
+                clEnumValN(diag::DiagnosticOutputFormat::text, "text", "Messages with the source line"),
+                clEnumValN(diag::DiagnosticOutputFormat::json, "json", "One JSON object per line"),
+                clEnumValN(diag::DiagnosticOutputFormat::sarif, "sarif", "SARIF 2.1.0 log")
+            ),
+            llvm::cl::init(diag::DiagnosticOutputFormat::text)
+        );
 
-                sema::TypeChecker typeChecker(std::move(ast), diagnostics);
-                auto typeCheckResult = typeChecker.typeCheck();
+        llvm::cl::opt<bool> FrontendDriver::timeReport(
+            llvm::cl::sub(frontendSubcommand),
+            "time-report",
+            llvm::cl::desc("Print the time and memory used by each phase and LLVM pass to stderr")
+        );
 
-                if (!diagnostics->hadError()) {
-                    if (action == Action::dumpAST) {
-                        typeCheckResult.ast->diagnoseInto(*diagnostics, 0);
+        llvm::cl::opt<std::string> FrontendDriver::timeReportFile(
+            llvm::cl::sub(frontendSubcommand),
+            "time-report-file",
+            llvm::cl::desc("Write the time and memory used by each phase and LLVM pass to <file> as JSON"),
+            llvm::cl::value_desc("file")
+        );
 
-                        return 0;
-                    }
 
-                    irgen::IRGen codegen(std::move(typeCheckResult), diagnostics);
+        int FrontendDriver::execute() {
+            irgen::CodeGenOptions options;
+            options.optimizationLevel = optimizationLevel;
+            options.cpu = targetCPU;
+            options.features = targetFeatures;
 
-                    if (codegen.generate()) {
-                        if (action == Action::emitIR) {
-                            codegen.dumpProgram(outputOS);
+            Frontend frontend(action, inputFile, outputFile, options);
+            frontend.setDiagnosticOutputFormat(diagnosticsFormat);
 
-                            return 0;
-                        }
+            if (!timeReport && timeReportFile.empty())
+                return frontend.execute();
 
-                        if (codegen.emitObject(outputOS)) {
-                            return 0;
-                        }
-                    }
-                }
-            }
+            FrontendStatistics & statistics = frontend.enableStatistics();
+            int exitCode = frontend.execute();
 
-            return 1;
-        }
+            if (timeReport)
+                statistics.print(llvm::errs());
 
-        llvm::Expected<llvm::raw_pwrite_stream &> FrontendDriver::getOutputOS() {
-            if (outputFile == "-") {
-                return llvm::outs();
-            } else if (_outputOS) {
-                return *_outputOS;
-            } else {
+            if (!timeReportFile.empty()) {
                 std::error_code errorCode;
-                _outputOS = new llvm::raw_fd_ostream(outputFile, errorCode);
+                llvm::raw_fd_ostream os(timeReportFile, errorCode);
 
-                if (errorCode)
-                    return basic::createError<diag::StaticDiagnosticError>(
-                        diag::DiagnosticID::error_opening_output_file, (llvm::StringRef)outputFile, errorCode);
+                if (errorCode) {
+                    diag::DiagnosticEngine::diagnose(frontend.getDiagnosticSink(),
+                                                     diag::DiagnosticID::error_opening_output_file,
+                                                     (llvm::StringRef)timeReportFile, errorCode);
+                    return 1;
+                }
 
-                return *_outputOS;
+                statistics.printJSON(os);
             }
+
+            return exitCode;
         }
     }
 }
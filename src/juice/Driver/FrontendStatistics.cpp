@@ -0,0 +1,107 @@
+// src/juice/Driver/FrontendStatistics.cpp - Time and memory report of the frontend phases
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Driver/FrontendStatistics.h"
+
+#include "juice/Basic/Process.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
+
+namespace juice {
+    namespace driver {
+        FrontendStatistics::FrontendStatistics():
+            _timerGroup("frontend", "Frontend phases"), _passTimer(true) {
+            for (size_t i = 0; i < phaseCount; ++i) {
+                auto phase = static_cast<Phase>(i);
+                _timers[i].init(getName(phase), getDescription(phase), _timerGroup);
+            }
+
+            llvm::TimePassesIsEnabled = true;
+
+            // Timers only record the change in heap usage if LLVM's hidden --track-memory option is set.
+            auto & options = llvm::cl::getRegisteredOptions();
+            auto trackMemory = options.find("track-memory");
+            if (trackMemory != options.end())
+                trackMemory->second->addOccurrence(0, "track-memory", "true");
+        }
+
+        FrontendStatistics::~FrontendStatistics() {
+            llvm::TimerGroup::clearAll();
+        }
+
+        void FrontendStatistics::print(llvm::raw_ostream & os) {
+            os << "===" << std::string(73, '-') << "===\n"
+               << "                              Frontend statistics\n"
+               << "===" << std::string(73, '-') << "===\n\n";
+
+            os << llvm::format("%12zu  tokens\n", _tokenCount)
+               << llvm::format("%12zu  parsed AST nodes\n", _parsedNodeCount)
+               << llvm::format("%12zu  type-checked AST nodes\n", _typeCheckedNodeCount)
+               << llvm::format("%12zu  bytes allocated for the AST\n", _astBytes)
+               << llvm::format("%12zu  bytes peak resident set size\n\n", basic::getPeakMemoryUsage());
+
+            llvm::TimerGroup::printAll(os);
+        }
+
+        void FrontendStatistics::printJSON(llvm::raw_ostream & os) {
+            os << "{\n"
+               << "\t\"frontend.tokens\": " << _tokenCount << ",\n"
+               << "\t\"frontend.parsed-nodes\": " << _parsedNodeCount << ",\n"
+               << "\t\"frontend.type-checked-nodes\": " << _typeCheckedNodeCount << ",\n"
+               << "\t\"frontend.ast-bytes\": " << _astBytes << ",\n"
+               << "\t\"frontend.peak-rss\": " << basic::getPeakMemoryUsage();
+
+            llvm::TimerGroup::printAllJSONValues(os, ",\n");
+
+            os << "\n}\n";
+        }
+
+        const char * FrontendStatistics::getName(Phase phase) {
+            switch (phase) {
+                case Phase::lex:
+                    return "lex";
+                case Phase::parse:
+                    return "parse";
+                case Phase::typeCheck:
+                    return "type-check";
+                case Phase::generateIR:
+                    return "irgen";
+                case Phase::optimize:
+                    return "optimize";
+                case Phase::emit:
+                    return "emit";
+            }
+
+            llvm_unreachable("All phases should be handled here!");
+        }
+
+        const char * FrontendStatistics::getDescription(Phase phase) {
+            switch (phase) {
+                case Phase::lex:
+                    return "Lexing";
+                case Phase::parse:
+                    return "Parsing";
+                case Phase::typeCheck:
+                    return "Type checking";
+                case Phase::generateIR:
+                    return "LLVM IR generation";
+                case Phase::optimize:
+                    return "Optimization";
+                case Phase::emit:
+                    return "Code emission";
+            }
+
+            llvm_unreachable("All phases should be handled here!");
+        }
+    }
+}
@@ -11,18 +11,23 @@
 
 #include "juice/Driver/MainDriver.h"
 
+#include <system_error>
 #include <utility>
 
 #include "juice/Basic/Error.h"
 #include "juice/Diagnostics/DiagnosticError.h"
+#include "juice/Diagnostics/Diagnostics.h"
+#include "juice/Driver/DriverOptions.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/TimeProfiler.h"
 
 namespace juice {
     namespace driver {
-        llvm::cl::opt<std::string> MainDriver::inputFilename(
+        llvm::cl::list<std::string> MainDriver::inputFilenames(
             llvm::cl::Positional,
-            llvm::cl::desc("<input file>"),
-            llvm::cl::Required
+            llvm::cl::desc("<input files>"),
+            llvm::cl::OneOrMore
         );
 
         llvm::cl::opt<std::string> MainDriver::outputFilename(
@@ -52,10 +57,98 @@ namespace juice {
             llvm::cl::init(DriverAction::emitExecutable)
         );
 
+        llvm::cl::opt<irgen::OptimizationLevel> MainDriver::optimizationLevel(
+            "O",
+            llvm::cl::Prefix,
+            options::optimizationLevelDescription(),
+            options::optimizationLevelValues(),
+            llvm::cl::init(irgen::OptimizationLevel::O0)
+        );
+
+        llvm::cl::opt<std::string> MainDriver::targetArchitecture(
+            "march",
+            llvm::cl::desc("Generate code for the given CPU, or for the host CPU and its features if 'native'"),
+            llvm::cl::value_desc("cpu-name")
+        );
+
+        llvm::cl::opt<std::string> MainDriver::targetCPU(
+            "mcpu",
+            llvm::cl::desc("Generate code for the given CPU, takes precedence over --march"),
+            llvm::cl::value_desc("cpu-name")
+        );
+
+        llvm::cl::opt<std::string> MainDriver::targetFeatures(
+            "mattr",
+            llvm::cl::desc("Enable (+) or disable (-) target features, e.g. '+avx2,-bmi2'"),
+            llvm::cl::value_desc("a1,+a2,-a3,...")
+        );
+
+        llvm::cl::opt<bool> MainDriver::spawnFrontend(
+            "spawn-frontend",
+            llvm::cl::desc("Run the frontend in a separate process for every input file")
+        );
+
+        llvm::cl::opt<unsigned int> MainDriver::jobs(
+            "j",
+            llvm::cl::desc("Compile up to <N> input files in parallel (default: one per hardware thread)"),
+            llvm::cl::value_desc("N"),
+            llvm::cl::Prefix,
+            llvm::cl::init(0)
+        );
+
+        llvm::cl::opt<bool> MainDriver::disableCache(
+            "no-cache",
+            llvm::cl::desc("Always compile input files instead of reusing object files from the compilation cache")
+        );
+
+        llvm::cl::opt<std::string> MainDriver::cacheDirectory(
+            "cache-dir",
+            llvm::cl::desc("Store the compilation cache in <directory> (default: the user's cache directory)"),
+            llvm::cl::value_desc("directory")
+        );
+
+        llvm::cl::opt<std::string> MainDriver::traceFilename(
+            "trace",
+            llvm::cl::desc("Write a Chrome trace of all tasks, frontend phases and LLVM passes to <file>"),
+            llvm::cl::value_desc("file")
+        );
+
+
+        irgen::CodeGenOptions MainDriver::getCodeGenOptions() {
+            irgen::CodeGenOptions options;
+            options.optimizationLevel = optimizationLevel;
+            options.cpu = targetCPU.empty() ? targetArchitecture : targetCPU;
+            options.features = targetFeatures;
+
+            return options;
+        }
+
+        std::shared_ptr<const CompilationCache> MainDriver::getCompilationCache() {
+            if (disableCache)
+                return nullptr;
+
+            return CompilationCache::create(cacheDirectory);
+        }
+
 
         MainDriver::MainDriver(const char * firstArg): _firstArg(firstArg) {}
 
         int MainDriver::execute() {
+            if (traceFilename.empty())
+                return executeTask();
+
+            llvm::timeTraceProfilerInitialize(DriverTask::traceGranularity, "juice");
+
+            int exitCode = executeTask();
+
+            if (!writeTrace()) exitCode = 1;
+
+            llvm::timeTraceProfilerCleanup();
+
+            return exitCode;
+        }
+
+        int MainDriver::executeTask() {
             auto task = parseOptions();
             if (basic::handleAllErrors(task.takeError(), [](const diag::StaticDiagnosticError & error) {
                 error.diagnose();
@@ -72,34 +165,78 @@ namespace juice {
             return 0;
         }
 
-        llvm::Expected<std::unique_ptr<DriverTask>> MainDriver::parseOptions() {
-            auto inputTask = std::make_unique<InputTask>(inputFilename);
+        bool MainDriver::writeTrace() {
+            std::error_code errorCode;
+            llvm::raw_fd_ostream os(traceFilename, errorCode);
 
-            auto outputFile = getAction().outputFile(inputFilename, outputFilename);
+            if (errorCode) {
+                diag::DiagnosticEngine::diagnose(diag::DiagnosticID::error_opening_output_file,
+                                                 (llvm::StringRef)traceFilename, errorCode);
+                return false;
+            }
 
-            if (outputFile.hasValue()) {
-                if (action == DriverAction::emitExecutable) {
-                    auto compilationTask = CompilationTask::create(_firstArg, getAction(), std::move(inputTask));
-                    if (auto error = compilationTask.takeError())
-                        return error;
+            llvm::timeTraceProfilerWrite(os);
 
-                    llvm::SmallVector<std::unique_ptr<DriverTask>, 4> linkerInputs;
-                    linkerInputs.push_back(std::move(*compilationTask));
+            return true;
+        }
 
-                    return LinkingTask::create(std::move(linkerInputs), (std::string)outputFile.getValue());
-                } else {
-                    return CompilationTask::create(_firstArg, getAction(), std::move(inputTask),
-                                                   (std::string)outputFile.getValue());
-                }
-            } else {
-                if (action == DriverAction::emitExecutable) {
+        llvm::Expected<std::unique_ptr<DriverTask>> MainDriver::parseOptions() {
+            auto cache = getCompilationCache();
+
+            if (action == DriverAction::emitExecutable) {
+                // Every module defines main, so the objects of several input files can't be linked together.
+                if (inputFilenames.size() > 1)
+                    return basic::createError<diag::StaticDiagnosticError>(
+                        diag::DiagnosticID::executable_with_multiple_inputs);
+
+                auto outputFile = getAction().outputFile(inputFilenames.front(), outputFilename);
+
+                if (!outputFile.hasValue())
                     return basic::createError<diag::StaticDiagnosticError>(diag::DiagnosticID::linker_output_to_stdout);
+
+                auto compilationTask = CompilationTask::create(_firstArg, getAction(), getCodeGenOptions(),
+                                                               !spawnFrontend, cache,
+                                                               std::make_unique<InputTask>(inputFilenames.front()));
+                if (auto error = compilationTask.takeError())
+                    return error;
+
+                llvm::SmallVector<std::unique_ptr<DriverTask>, 4> linkerInputs;
+                linkerInputs.push_back(std::move(*compilationTask));
+
+                return LinkingTask::create(std::move(linkerInputs), (std::string)outputFile.getValue(), jobs);
+            }
+
+            if (inputFilenames.size() > 1 && !outputFilename.empty() && outputFilename != "-")
+                return basic::createError<diag::StaticDiagnosticError>(
+                    diag::DiagnosticID::output_file_with_multiple_inputs);
+
+            llvm::SmallVector<std::unique_ptr<DriverTask>, 4> compilationTasks;
+            bool outputsToStdout = false;
+
+            for (const std::string & inputFilename: inputFilenames) {
+                auto inputTask = std::make_unique<InputTask>(inputFilename);
+
+                auto outputFile = getAction().outputFile(inputFilename, outputFilename);
+
+                if (outputFile.hasValue()) {
+                    compilationTasks.push_back(
+                        CompilationTask::create(_firstArg, getAction(), getCodeGenOptions(), !spawnFrontend, cache,
+                                                std::move(inputTask), (std::string)outputFile.getValue()));
                 } else if (action == DriverAction::emitObject) {
                     return basic::createError<diag::StaticDiagnosticError>(diag::DiagnosticID::object_to_stdout);
                 } else {
-                    return CompilationTask::create(_firstArg, getAction(), std::move(inputTask), "-");
+                    outputsToStdout = true;
+                    compilationTasks.push_back(
+                        CompilationTask::create(_firstArg, getAction(), getCodeGenOptions(), !spawnFrontend, cache,
+                                                std::move(inputTask), "-"));
                 }
             }
+
+            if (compilationTasks.size() == 1)
+                return std::move(compilationTasks.front());
+
+            // Output written to stdout has to appear in the order of the input files.
+            return BatchTask::create(std::move(compilationTasks), outputsToStdout ? 1 : (unsigned int)jobs);
         }
     }
 }
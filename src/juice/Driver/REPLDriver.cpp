@@ -11,13 +11,112 @@
 
 #include "juice/Driver/REPLDriver.h"
 
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "juice/Basic/RawStreamHelpers.h"
+#include "juice/Basic/SourceManager.h"
+#include "juice/IRGen/IRGen.h"
+#include "juice/Parser/Lexer.h"
+#include "juice/Parser/Parser.h"
+#include "juice/Sema/TypeCheckedStatementAST.h"
+#include "juice/Sema/TypeHint.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace juice {
     namespace driver {
+        llvm::cl::SubCommand replSubcommand("repl", "Start an interactive juice session");
+
         int REPLDriver::execute() {
-            llvm::outs() << "REPL\n"; // TODO
+            _jit = irgen::JIT::create();
+            if (!_jit) return 1;
+
+            bool isInteractive = llvm::sys::Process::StandardInIsUserInput();
+
+            std::string input;
+            for (unsigned int lineNumber = 1;; ++lineNumber) {
+                if (isInteractive) {
+                    llvm::outs() << basic::Color::bold << lineNumber << "> " << basic::Color::reset;
+                    llvm::outs().flush();
+                }
+
+                if (!std::getline(std::cin, input)) break;
+
+                if (llvm::StringRef(input).trim().empty()) continue;
+
+                evaluate(input, lineNumber);
+            }
+
+            if (isInteractive) llvm::outs() << "\n";
+
             return 0;
         }
+
+        void REPLDriver::evaluate(llvm::StringRef input, unsigned int lineNumber) {
+            auto manager = basic::SourceManager::mainString(input.str() + "\n",
+                                                            ("<repl:" + llvm::Twine(lineNumber) + ">").str());
+
+            auto diagnostics = std::make_shared<diag::DiagnosticEngine>(std::move(manager), llvm::outs());
+
+            auto context = std::make_unique<ast::ASTContext>(parser::Lexer(diagnostics->getBuffer()).tokenize());
+            parser::Parser juiceParser(*context, diagnostics);
+
+            auto ast = juiceParser.parseModule();
+            if (diagnostics->hadError()) return;
+
+            if (!_state) {
+                _state = std::make_unique<sema::TypeChecker::State>(*context);
+                sema::TypeChecker::declareBuiltinTypes(*_state);
+            }
+
+            // The line's declarations are only kept if it can be executed, so that a failed line doesn't leave
+            // behind variables that were never initialized.
+            _state->newScope();
+
+            sema::TypeChecker typeChecker(*context, ast, diagnostics);
+            auto typeCheckResult = typeChecker.typeCheck(*_state, sema::NoneTypeHint());
+
+            if (diagnostics->hadError()) {
+                _state->endScope();
+                return;
+            }
+
+            std::string functionName = "juice.repl." + std::to_string(lineNumber);
+
+            irgen::IRGen codegen(*context, typeCheckResult, diagnostics);
+
+            if (!codegen.generateIncremental(functionName) || !codegen.optimize()) {
+                _state->endScope();
+                return;
+            }
+
+            // Like its declarations, the line's definitions are removed from the JIT again if it can't be executed,
+            // so that they can't clash with the ones of later lines.
+            auto module = _jit->addModule(codegen.takeModule());
+            if (!module) {
+                _state->endScope();
+                return;
+            }
+
+            irgen::JIT::Function function = _jit->lookup(functionName);
+            if (!function) {
+                _jit->removeModule(std::move(module));
+                _state->endScope();
+                return;
+            }
+
+            _state->commitScope();
+            _lines.push_back({std::move(diagnostics), std::move(context)});
+
+            // The generated code prints through the C standard library, so both streams have to be flushed to keep
+            // the output in order.
+            llvm::outs().flush();
+            function();
+            std::fflush(stdout);
+        }
     }
 }
@@ -0,0 +1,47 @@
+// src/juice/Driver/RunDriver.cpp - Driver subclass that executes a source file without linking it
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Driver/RunDriver.h"
+
+#include "juice/Driver/DriverOptions.h"
+#include "juice/Driver/Frontend.h"
+
+namespace juice {
+    namespace driver {
+        llvm::cl::SubCommand runSubcommand("run", "Compile and execute a juice file without linking it");
+
+        llvm::cl::opt<std::string> RunDriver::inputFilename(
+            llvm::cl::sub(runSubcommand),
+            llvm::cl::Positional,
+            llvm::cl::desc("<input file>"),
+            llvm::cl::Required
+        );
+
+        llvm::cl::opt<irgen::OptimizationLevel> RunDriver::optimizationLevel(
+            llvm::cl::sub(runSubcommand),
+            "O",
+            llvm::cl::Prefix,
+            options::optimizationLevelDescription(),
+            options::optimizationLevelValues(),
+            llvm::cl::init(irgen::OptimizationLevel::O0)
+        );
+
+
+        int RunDriver::execute() {
+            irgen::CodeGenOptions options;
+            options.optimizationLevel = optimizationLevel;
+            // The code is only ever executed on this machine.
+            options.cpu = "native";
+
+            return Frontend(Frontend::Action::run, inputFilename, "-", options).execute();
+        }
+    }
+}
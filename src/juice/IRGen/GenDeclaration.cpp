@@ -12,16 +12,17 @@
 #include "juice/IRGen/IRGen.h"
 
 #include "juice/Sema/TypeCheckedDeclarationAST.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/GlobalVariable.h"
 #include "llvm/Support/Casting.h"
 
 namespace juice {
     namespace irgen {
-        void IRGen::generateDeclaration(std::unique_ptr<sema::TypeCheckedDeclarationAST> declaration) {
-            switch (declaration->_kind) {
+        void IRGen::generateDeclaration(const sema::TypeCheckedDeclarationAST & declaration) {
+            switch (declaration._kind) {
                 case sema::TypeCheckedAST::Kind::variableDeclaration: {
-                    auto variable = std::unique_ptr<sema::TypeCheckedVariableDeclarationAST>(
-                        llvm::cast<sema::TypeCheckedVariableDeclarationAST>(declaration.release()));
-                    generateVariableDeclaration(std::move(variable));
+                    const auto & variable = llvm::cast<sema::TypeCheckedVariableDeclarationAST>(declaration);
+                    generateVariableDeclaration(variable);
                     break;
                 }
                 default:
@@ -29,14 +30,24 @@ namespace juice {
             }
         }
 
-        void IRGen::generateVariableDeclaration(std::unique_ptr<sema::TypeCheckedVariableDeclarationAST> declaration) {
-            auto value = generateExpression(std::move(declaration->_initialization));
+        void IRGen::generateVariableDeclaration(const sema::TypeCheckedVariableDeclarationAST & declaration) {
+            auto value = generateExpression(*declaration._initialization);
 
-            llvm::AllocaInst * alloca = _builder.CreateAlloca(declaration->_variableType->toLLVM(_context), nullptr,
-                                                              declaration->_name->string);
-            _builder.CreateStore(value, alloca);
+            llvm::Type * type = declaration._variableType->toLLVM(_context);
+            llvm::StringRef name = _astContext.getString(declaration._name);
 
-            _allocas.at(declaration->_index) = alloca;
+            llvm::Value * variable;
+            if (_hasPersistentVariables && _blockDepth == 0) {
+                variable = new llvm::GlobalVariable(*_module, type, false, llvm::GlobalValue::ExternalLinkage,
+                                                    llvm::Constant::getNullValue(type),
+                                                    getPersistentVariableName(declaration._index, name));
+            } else {
+                variable = _builder.CreateAlloca(type, nullptr, name);
+            }
+
+            _builder.CreateStore(value, variable);
+
+            _variables.at(declaration._index) = variable;
         }
     }
 }
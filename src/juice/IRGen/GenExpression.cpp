@@ -14,6 +14,7 @@
 #include <map>
 #include <utility>
 
+#include "juice/Sema/BuiltinType.h"
 #include "juice/Sema/Type.h"
 #include "juice/Sema/TypeCheckedExpressionAST.h"
 #include "llvm/ADT/APFloat.h"
@@ -24,50 +25,43 @@
 
 namespace juice {
     namespace irgen {
-        llvm::Value * IRGen::generateExpression(std::unique_ptr<sema::TypeCheckedExpressionAST> expression) {
-            switch (expression->_kind) {
+        llvm::Value * IRGen::generateExpression(const sema::TypeCheckedExpressionAST & expression) {
+            switch (expression._kind) {
                 case sema::TypeCheckedAST::Kind::binaryOperatorExpression: {
-                    auto binaryOperator = std::unique_ptr<sema::TypeCheckedBinaryOperatorExpressionAST>(
-                        llvm::cast<sema::TypeCheckedBinaryOperatorExpressionAST>(expression.release()));
-                    return generateBinaryOperatorExpression(std::move(binaryOperator));
+                    const auto & binaryOperator = llvm::cast<sema::TypeCheckedBinaryOperatorExpressionAST>(expression);
+                    return generateBinaryOperatorExpression(binaryOperator);
                 }
                 case sema::TypeCheckedAST::Kind::integerLiteralExpression: {
-                    auto literal = std::unique_ptr<sema::TypeCheckedIntegerLiteralExpressionAST>(
-                        llvm::cast<sema::TypeCheckedIntegerLiteralExpressionAST>(expression.release()));
-                    return generateIntegerLiteralExpression(std::move(literal));
+                    const auto & literal = llvm::cast<sema::TypeCheckedIntegerLiteralExpressionAST>(expression);
+                    return generateIntegerLiteralExpression(literal);
                 }
                 case sema::TypeCheckedAST::Kind::floatingPointLiteralExpression: {
-                    auto literal = std::unique_ptr<sema::TypeCheckedFloatingPointLiteralExpressionAST>(
-                        llvm::cast<sema::TypeCheckedFloatingPointLiteralExpressionAST>(expression.release()));
-                    return generateFloatingPointLiteralExpression(std::move(literal));
+                    const auto & literal = llvm::cast<sema::TypeCheckedFloatingPointLiteralExpressionAST>(expression);
+                    return generateFloatingPointLiteralExpression(literal);
                 }
                 case sema::TypeCheckedAST::Kind::booleanLiteralExpression: {
-                    auto literal = std::unique_ptr<sema::TypeCheckedBooleanLiteralExpressionAST>(
-                        llvm::cast<sema::TypeCheckedBooleanLiteralExpressionAST>(expression.release()));
-                    return generateBooleanLiteralExpression(std::move(literal));
+                    const auto & literal = llvm::cast<sema::TypeCheckedBooleanLiteralExpressionAST>(expression);
+                    return generateBooleanLiteralExpression(literal);
                 }
                 case sema::TypeCheckedAST::Kind::variableExpression: {
-                    auto variable = std::unique_ptr<sema::TypeCheckedVariableExpressionAST>(
-                        llvm::cast<sema::TypeCheckedVariableExpressionAST>(expression.release()));
-                    return generateVariableExpression(std::move(variable));
+                    const auto & variable = llvm::cast<sema::TypeCheckedVariableExpressionAST>(expression);
+                    return generateVariableExpression(variable);
                 }
                 case sema::TypeCheckedAST::Kind::groupingExpression: {
-                    auto grouping = std::unique_ptr<sema::TypeCheckedGroupingExpressionAST>(
-                        llvm::cast<sema::TypeCheckedGroupingExpressionAST>(expression.release()));
-                    return generateGroupingExpression(std::move(grouping));
+                    const auto & grouping = llvm::cast<sema::TypeCheckedGroupingExpressionAST>(expression);
+                    return generateGroupingExpression(grouping);
                 }
                 case sema::TypeCheckedAST::Kind::ifExpression: {
-                    auto _if = std::unique_ptr<sema::TypeCheckedIfExpressionAST>(
-                        llvm::cast<sema::TypeCheckedIfExpressionAST>(expression.release()));
-                    return generateIfExpression(std::move(_if));
+                    const auto & _if = llvm::cast<sema::TypeCheckedIfExpressionAST>(expression);
+                    return generateIfExpression(_if);
                 }
                 default:
                     llvm_unreachable("All expression AST nodes should be handled here");
             }
         }
 
-        llvm::Value * IRGen::generateBinaryOperatorExpression(
-            std::unique_ptr<sema::TypeCheckedBinaryOperatorExpressionAST> expression) {
+        llvm::Value *
+        IRGen::generateBinaryOperatorExpression(const sema::TypeCheckedBinaryOperatorExpressionAST & expression) {
             using TokenType = parser::LexerToken::Type;
             using AssignmentFunction =
                 llvm::function_ref<llvm::Value * (llvm::IRBuilder<> &, llvm::Value *, llvm::Value *)>;
@@ -110,45 +104,47 @@ namespace juice {
                 }
             };
 
-            auto instruction = assignmentOperators.find(expression->_token->type);
+            TokenType operatorType = _astContext.getTokens().getType(expression._token);
+
+            auto instruction = assignmentOperators.find(operatorType);
 
-            sema::Type type = expression->_type;
+            sema::Type type = expression._type;
 
             if (instruction != assignmentOperators.end()) {
-                const auto & variable = llvm::cast<sema::TypeCheckedVariableExpressionAST>(*expression->_left);
+                const auto & variable = llvm::cast<sema::TypeCheckedVariableExpressionAST>(*expression._left);
 
-                llvm::StringRef name = variable.name();
+                llvm::StringRef name = variable.name(_astContext);
 
-                auto right = generateExpression(std::move(expression->_right));
+                auto right = generateExpression(*expression._right);
 
-                llvm::AllocaInst * alloca = _allocas.at(variable._index);
+                llvm::Value * storage = getVariable(variable._index, type->toLLVM(_context), name);
 
                 if (type.isBuiltinInteger() && instruction->second.first) {
-                    llvm::Value * variableValue = _builder.CreateLoad(type->toLLVM(_context), alloca, name);
+                    llvm::Value * variableValue = _builder.CreateLoad(type->toLLVM(_context), storage, name);
 
                     right = instruction->second.first(_builder, variableValue, right);
                 } else if (type.isBuiltinFloatingPoint() && instruction->second.second) {
-                    llvm::Value * variableValue = _builder.CreateLoad(type->toLLVM(_context), alloca, name);
+                    llvm::Value * variableValue = _builder.CreateLoad(type->toLLVM(_context), storage, name);
 
                     right = instruction->second.second(_builder, variableValue, right);
                 }
 
-                _builder.CreateStore(right, alloca);
+                _builder.CreateStore(right, storage);
 
                 return right;
             }
 
-            auto left = generateExpression(std::move(expression->_left));
+            auto left = generateExpression(*expression._left);
 
-            if (expression->_token->type == TokenType::operatorAndAnd
-                || expression->_token->type == TokenType::operatorPipePipe) {
+            if (operatorType == TokenType::operatorAndAnd
+                || operatorType == TokenType::operatorPipePipe) {
 
                 llvm::Function * function = _builder.GetInsertBlock()->getParent();
 
                 llvm::BasicBlock * rightBlock = llvm::BasicBlock::Create(_context, "logical", function);
                 llvm::BasicBlock * mergeBlock = llvm::BasicBlock::Create(_context, "logicalcont");
 
-                if (expression->_token->type == TokenType::operatorAndAnd)
+                if (operatorType == TokenType::operatorAndAnd)
                     _builder.CreateCondBr(left, rightBlock, mergeBlock);
                 else _builder.CreateCondBr(left, mergeBlock, rightBlock);
 
@@ -157,7 +153,7 @@ namespace juice {
 
                 _builder.SetInsertPoint(rightBlock);
 
-                auto right = generateExpression(std::move(expression->_right));
+                auto right = generateExpression(*expression._right);
 
                 _builder.CreateBr(mergeBlock);
 
@@ -174,10 +170,10 @@ namespace juice {
                 return phi;
             }
 
-            auto right = generateExpression(std::move(expression->_right));
+            auto right = generateExpression(*expression._right);
 
             if (type.isBuiltinInteger()) {
-                switch (expression->_token->type) {
+                switch (operatorType) {
                     case TokenType::operatorPlus:
                         return _builder.CreateAdd(left, right, "addtmp");
                     case TokenType::operatorMinus:
@@ -202,7 +198,7 @@ namespace juice {
                         llvm_unreachable("All possible parsed operators should be handled here");
                 }
             } else if (type.isBuiltinFloatingPoint()) {
-                switch (expression->_token->type) {
+                switch (operatorType) {
                     case TokenType::operatorPlus:
                         return _builder.CreateFAdd(left, right, "addtmp");
                     case TokenType::operatorMinus:
@@ -232,57 +228,61 @@ namespace juice {
         }
 
         llvm::Value * IRGen::generateIntegerLiteralExpression(
-            std::unique_ptr<sema::TypeCheckedIntegerLiteralExpressionAST> expression) {
-            if (expression->_type.isBuiltinInteger()) {
-                return llvm::ConstantInt::get(expression->_type->toLLVM(_context), expression->_value, true);
-            } else if (expression->_type.isBuiltinDouble()) {
-                return llvm::ConstantFP::get(llvm::Type::getDoubleTy(_context),
-                                             llvm::APFloat((double)expression->_value));
-            } else if (expression->_type.isBuiltinFloat()) {
-                return llvm::ConstantFP::get(llvm::Type::getFloatTy(_context),
-                                             llvm::APFloat((float)expression->_value));
+            const sema::TypeCheckedIntegerLiteralExpressionAST & expression) {
+            if (expression._type.isBuiltinInteger()) {
+                auto * type = llvm::cast<llvm::IntegerType>(expression._type->toLLVM(_context));
+                return llvm::ConstantInt::get(type, expression._value.zextOrTrunc(type->getBitWidth()));
+            } else if (expression._type.isBuiltinFloatingPoint()) {
+                const auto * floatingPointType =
+                    llvm::cast<sema::BuiltinFloatingPointType>(expression._type.getPointer());
+
+                llvm::APFloat value(floatingPointType->getSemantics());
+                value.convertFromAPInt(expression._value, false, llvm::APFloat::rmNearestTiesToEven);
+
+                return llvm::ConstantFP::get(_context, value);
             } else {
                 llvm_unreachable("integer literal can only be of integer or floating point type");
             }
         }
 
         llvm::Value * IRGen::generateFloatingPointLiteralExpression(
-            std::unique_ptr<sema::TypeCheckedFloatingPointLiteralExpressionAST> expression) {
-            if (expression->_type.isBuiltinDouble()) {
-                return llvm::ConstantFP::get(llvm::Type::getDoubleTy(_context), llvm::APFloat(expression->_value));
-            } else if (expression->_type.isBuiltinFloat()) {
+            const sema::TypeCheckedFloatingPointLiteralExpressionAST & expression) {
+            if (expression._type.isBuiltinDouble()) {
+                return llvm::ConstantFP::get(llvm::Type::getDoubleTy(_context), llvm::APFloat(expression._value));
+            } else if (expression._type.isBuiltinFloat()) {
                 return llvm::ConstantFP::get(llvm::Type::getFloatTy(_context),
-                                             llvm::APFloat((float)expression->_value));
+                                             llvm::APFloat((float)expression._value));
             } else {
                 llvm_unreachable("integer literal can only be of integer or floating point type");
             }
         }
 
         llvm::Value * IRGen::generateBooleanLiteralExpression(
-            std::unique_ptr<sema::TypeCheckedBooleanLiteralExpressionAST> expression) {
-            return _builder.getInt1(expression->_value);
+            const sema::TypeCheckedBooleanLiteralExpressionAST & expression) {
+            return _builder.getInt1(expression._value);
         }
 
         llvm::Value *
-        IRGen::generateVariableExpression(std::unique_ptr<sema::TypeCheckedVariableExpressionAST> expression) {
-            llvm::AllocaInst * alloca = _allocas.at(expression->_index);
+        IRGen::generateVariableExpression(const sema::TypeCheckedVariableExpressionAST & expression) {
+            llvm::Type * type = expression._type->toLLVM(_context);
+            llvm::StringRef name = expression.name(_astContext);
 
-            return _builder.CreateLoad(expression->_type->toLLVM(_context), alloca, expression->name());
+            return _builder.CreateLoad(type, getVariable(expression._index, type, name), name);
         }
 
         llvm::Value *
-        IRGen::generateGroupingExpression(std::unique_ptr<sema::TypeCheckedGroupingExpressionAST> expression) {
-            return generateExpression(std::move(expression->_expression));
+        IRGen::generateGroupingExpression(const sema::TypeCheckedGroupingExpressionAST & expression) {
+            return generateExpression(*expression._expression);
         }
 
-        llvm::Value * IRGen::generateIfExpression(std::unique_ptr<sema::TypeCheckedIfExpressionAST> expression) {
-            auto ifCondition = generateExpression(std::move(expression->_ifCondition));
+        llvm::Value * IRGen::generateIfExpression(const sema::TypeCheckedIfExpressionAST & expression) {
+            auto ifCondition = generateExpression(*expression._ifCondition);
 
             llvm::Function * function = _builder.GetInsertBlock()->getParent();
 
             llvm::BasicBlock * ifBlock = llvm::BasicBlock::Create(_context, "if", function);
 
-            std::vector<llvm::BasicBlock *> elifBlocks(expression->_elifConditionsAndBodies.size() * 2);
+            std::vector<llvm::BasicBlock *> elifBlocks(expression._elifConditionsAndBodies.size() * 2);
 
             for (int i = 0; i < elifBlocks.size(); ++i) {
                 elifBlocks[i] = llvm::BasicBlock::Create(_context, i % 2 == 0 ? "elifcmp" : "elif");
@@ -296,31 +296,31 @@ namespace juice {
 
             _builder.SetInsertPoint(ifBlock);
 
-            auto ifValue = generateControlFlowBody(std::move(expression->_ifBody));
+            auto ifValue = generateControlFlowBody(*expression._ifBody);
 
             _builder.CreateBr(mergeBlock);
 
             ifBlock = _builder.GetInsertBlock();
 
 
-            std::vector<llvm::Value *> elifValues(expression->_elifConditionsAndBodies.size());
+            std::vector<llvm::Value *> elifValues(expression._elifConditionsAndBodies.size());
 
             auto elifBlocksIt = elifBlocks.begin();
-            auto elifConditionsAndBodiesIt = expression->_elifConditionsAndBodies.begin();
+            auto elifConditionsAndBodiesIt = expression._elifConditionsAndBodies.begin();
             auto elifValuesIt = elifValues.begin();
 
             while (elifBlocksIt != elifBlocks.end()) {
                 auto & compareBlock = *elifBlocksIt;
                 auto & block = *(elifBlocksIt + 1);
-                auto condition = std::move(std::get<0>(*elifConditionsAndBodiesIt));
-                auto body = std::move(std::get<1>(*elifConditionsAndBodiesIt));
+                const auto & condition = *std::get<0>(*elifConditionsAndBodiesIt);
+                const auto & body = *std::get<1>(*elifConditionsAndBodiesIt);
 
                 auto nextBlockIt = elifBlocksIt + 2;
 
                 function->getBasicBlockList().push_back(compareBlock);
                 _builder.SetInsertPoint(compareBlock);
 
-                auto elifCondition = generateExpression(std::move(condition));
+                auto elifCondition = generateExpression(condition);
 
                 if (nextBlockIt != elifBlocks.end()) _builder.CreateCondBr(elifCondition, block, *nextBlockIt);
                 else _builder.CreateCondBr(elifCondition, block, elseBlock);
@@ -331,7 +331,7 @@ namespace juice {
                 function->getBasicBlockList().push_back(block);
                 _builder.SetInsertPoint(block);
 
-                auto elifValue = generateControlFlowBody(std::move(body));
+                auto elifValue = generateControlFlowBody(body);
 
                 *elifValuesIt = elifValue;
 
@@ -349,7 +349,7 @@ namespace juice {
             function->getBasicBlockList().push_back(elseBlock);
             _builder.SetInsertPoint(elseBlock);
 
-            auto elseValue = generateControlFlowBody(std::move(expression->_elseBody));
+            auto elseValue = generateControlFlowBody(*expression._elseBody);
 
             _builder.CreateBr(mergeBlock);
 
@@ -358,8 +358,8 @@ namespace juice {
             function->getBasicBlockList().push_back(mergeBlock);
             _builder.SetInsertPoint(mergeBlock);
 
-            llvm::PHINode * phi = _builder.CreatePHI(expression->_type->toLLVM(_context),
-                                                     2 + expression->_elifConditionsAndBodies.size(), "iftmp");
+            llvm::PHINode * phi = _builder.CreatePHI(expression._type->toLLVM(_context),
+                                                     2 + expression._elifConditionsAndBodies.size(), "iftmp");
             phi->addIncoming(ifValue, ifBlock);
 
             elifBlocksIt = elifBlocks.begin();
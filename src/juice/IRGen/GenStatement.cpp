@@ -20,35 +20,30 @@
 
 namespace juice {
     namespace irgen {
-        void IRGen::generateStatement(std::unique_ptr<sema::TypeCheckedStatementAST> statement) {
-            if (llvm::isa<sema::TypeCheckedDeclarationAST>(statement.get())) {
-                auto declaration = std::unique_ptr<sema::TypeCheckedDeclarationAST>(
-                    llvm::cast<sema::TypeCheckedDeclarationAST>(statement.release()));
-                generateDeclaration(std::move(declaration));
+        void IRGen::generateStatement(const sema::TypeCheckedStatementAST & statement) {
+            if (llvm::isa<sema::TypeCheckedDeclarationAST>(statement)) {
+                const auto & declaration = llvm::cast<sema::TypeCheckedDeclarationAST>(statement);
+                generateDeclaration(declaration);
             } else {
-                switch (statement->_kind) {
+                switch (statement._kind) {
                     case sema::TypeCheckedAST::Kind::blockStatement: {
-                        auto block = std::unique_ptr<sema::TypeCheckedBlockStatementAST>(
-                            llvm::cast<sema::TypeCheckedBlockStatementAST>(statement.release()));
-                        generateBlockStatement(std::move(block));
+                        const auto & block = llvm::cast<sema::TypeCheckedBlockStatementAST>(statement);
+                        generateBlockStatement(block);
                         break;
                     }
                     case sema::TypeCheckedAST::Kind::expressionStatement: {
-                        auto expression = std::unique_ptr<sema::TypeCheckedExpressionStatementAST>(
-                            llvm::cast<sema::TypeCheckedExpressionStatementAST>(statement.release()));
-                        generateExpressionStatement(std::move(expression));
+                        const auto & expression = llvm::cast<sema::TypeCheckedExpressionStatementAST>(statement);
+                        generateExpressionStatement(expression);
                         break;
                     }
                     case sema::TypeCheckedAST::Kind::ifStatement: {
-                        auto _if = std::unique_ptr<sema::TypeCheckedIfStatementAST>(
-                            llvm::cast<sema::TypeCheckedIfStatementAST>(statement.release()));
-                        generateIfStatement(std::move(_if));
+                        const auto & _if = llvm::cast<sema::TypeCheckedIfStatementAST>(statement);
+                        generateIfStatement(_if);
                         break;
                     }
                     case sema::TypeCheckedAST::Kind::whileStatement: {
-                        auto _while = std::unique_ptr<sema::TypeCheckedWhileStatementAST>(
-                            llvm::cast<sema::TypeCheckedWhileStatementAST>(statement.release()));
-                        generateWhileStatement(std::move(_while));
+                        const auto & _while = llvm::cast<sema::TypeCheckedWhileStatementAST>(statement);
+                        generateWhileStatement(_while);
                         break;
                     }
                     default:
@@ -57,42 +52,40 @@ namespace juice {
             }
         }
 
-        llvm::Value * IRGen::generateYieldingStatement(std::unique_ptr<sema::TypeCheckedStatementAST> statement) {
-            switch (statement->_kind) {
+        llvm::Value * IRGen::generateYieldingStatement(const sema::TypeCheckedStatementAST & statement) {
+            switch (statement._kind) {
                 case sema::TypeCheckedAST::Kind::blockStatement: {
-                    auto block = std::unique_ptr<sema::TypeCheckedBlockStatementAST>(
-                        llvm::cast<sema::TypeCheckedBlockStatementAST>(statement.release()));
-                    return generateBlockStatement(std::move(block));
+                    const auto & block = llvm::cast<sema::TypeCheckedBlockStatementAST>(statement);
+                    return generateBlockStatement(block);
                 }
                 case sema::TypeCheckedAST::Kind::expressionStatement: {
-                    auto expression = std::unique_ptr<sema::TypeCheckedExpressionStatementAST>(
-                        llvm::cast<sema::TypeCheckedExpressionStatementAST>(statement.release()));
-                    return generateExpressionStatement(std::move(expression));
+                    const auto & expression = llvm::cast<sema::TypeCheckedExpressionStatementAST>(statement);
+                    return generateExpressionStatement(expression);
                 }
                 default:
                     llvm_unreachable("All yielding statement AST nodes should be handled here");
             }
         }
 
-        llvm::Value * IRGen::generateBlockStatement(std::unique_ptr<sema::TypeCheckedBlockStatementAST> statement) {
-            return generateBlock(std::move(statement->_block));
+        llvm::Value * IRGen::generateBlockStatement(const sema::TypeCheckedBlockStatementAST & statement) {
+            return generateBlock(*statement._block);
         }
 
         llvm::Value *
-        IRGen::generateExpressionStatement(std::unique_ptr<sema::TypeCheckedExpressionStatementAST> statement) {
-            return generateExpression(std::move(statement->_expression));
+        IRGen::generateExpressionStatement(const sema::TypeCheckedExpressionStatementAST & statement) {
+            return generateExpression(*statement._expression);
         }
 
-        void IRGen::generateIfStatement(std::unique_ptr<sema::TypeCheckedIfStatementAST> statement) {
-            bool hasElse = (bool)statement->_ifExpression->_elseBody;
+        void IRGen::generateIfStatement(const sema::TypeCheckedIfStatementAST & statement) {
+            bool hasElse = (bool)statement._ifExpression->_elseBody;
 
-            auto ifCondition = generateExpression(std::move(statement->_ifExpression->_ifCondition));
+            auto ifCondition = generateExpression(*statement._ifExpression->_ifCondition);
 
             llvm::Function * function = _builder.GetInsertBlock()->getParent();
 
             llvm::BasicBlock * ifBlock = llvm::BasicBlock::Create(_context, "if", function);
 
-            std::vector<llvm::BasicBlock *> elifBlocks(statement->_ifExpression->_elifConditionsAndBodies.size() * 2);
+            std::vector<llvm::BasicBlock *> elifBlocks(statement._ifExpression->_elifConditionsAndBodies.size() * 2);
 
             for (int i = 0; i < elifBlocks.size(); ++i) {
                 elifBlocks[i] = llvm::BasicBlock::Create(_context, i % 2 == 0 ? "elifcmp" : "elif");
@@ -106,26 +99,26 @@ namespace juice {
 
             _builder.SetInsertPoint(ifBlock);
 
-            generateControlFlowBody(std::move(statement->_ifExpression->_ifBody));
+            generateControlFlowBody(*statement._ifExpression->_ifBody);
 
             _builder.CreateBr(mergeBlock);
 
 
             auto elifBlocksIt = elifBlocks.begin();
-            auto elifConditionsAndBodiesIt = statement->_ifExpression->_elifConditionsAndBodies.begin();
+            auto elifConditionsAndBodiesIt = statement._ifExpression->_elifConditionsAndBodies.begin();
 
             while (elifBlocksIt != elifBlocks.end()) {
                 auto & compareBlock = *elifBlocksIt;
                 auto & block = *(elifBlocksIt + 1);
-                auto condition = std::move(std::get<0>(*elifConditionsAndBodiesIt));
-                auto body = std::move(std::get<1>(*elifConditionsAndBodiesIt));
+                const auto & condition = *std::get<0>(*elifConditionsAndBodiesIt);
+                const auto & body = *std::get<1>(*elifConditionsAndBodiesIt);
 
                 auto nextBlockIt = elifBlocksIt + 2;
 
                 function->getBasicBlockList().push_back(compareBlock);
                 _builder.SetInsertPoint(compareBlock);
 
-                auto elifCondition = generateExpression(std::move(condition));
+                auto elifCondition = generateExpression(condition);
 
                 if (nextBlockIt != elifBlocks.end()) _builder.CreateCondBr(elifCondition, block, *(nextBlockIt));
                 else _builder.CreateCondBr(elifCondition, block, hasElse ? elseBlock : mergeBlock);
@@ -136,7 +129,7 @@ namespace juice {
                 function->getBasicBlockList().push_back(block);
                 _builder.SetInsertPoint(block);
 
-                generateControlFlowBody(std::move(body));
+                generateControlFlowBody(body);
 
                 _builder.CreateBr(mergeBlock);
 
@@ -149,7 +142,7 @@ namespace juice {
                 function->getBasicBlockList().push_back(elseBlock);
                 _builder.SetInsertPoint(elseBlock);
 
-                generateControlFlowBody(std::move(statement->_ifExpression->_elseBody));
+                generateControlFlowBody(*statement._ifExpression->_elseBody);
 
                 _builder.CreateBr(mergeBlock);
             }
@@ -158,7 +151,7 @@ namespace juice {
             _builder.SetInsertPoint(mergeBlock);
         }
 
-        void IRGen::generateWhileStatement(std::unique_ptr<sema::TypeCheckedWhileStatementAST> statement) {
+        void IRGen::generateWhileStatement(const sema::TypeCheckedWhileStatementAST & statement) {
             llvm::Function * function = _builder.GetInsertBlock()->getParent();
 
             llvm::BasicBlock * conditionBlock = llvm::BasicBlock::Create(_context, "whilecmp", function);
@@ -170,7 +163,7 @@ namespace juice {
 
             _builder.SetInsertPoint(conditionBlock);
 
-            auto condition = generateExpression(std::move(statement->_condition));
+            auto condition = generateExpression(*statement._condition);
 
             _builder.CreateCondBr(condition, block, mergeBlock);
 
@@ -178,7 +171,7 @@ namespace juice {
             function->getBasicBlockList().push_back(block);
             _builder.SetInsertPoint(block);
 
-            generateControlFlowBody(std::move(statement->_body));
+            generateControlFlowBody(*statement._body);
 
             _builder.CreateBr(conditionBlock);
 
@@ -11,48 +11,112 @@
 
 #include "juice/IRGen/IRGen.h"
 
+#include <cassert>
+#include <string>
 #include <utility>
 
+#include "juice/IRGen/TargetMachineCache.h"
+#include "juice/Sema/Type.h"
 #include "juice/Sema/TypeCheckedAST.h"
 #include "juice/Sema/TypeCheckedExpressionAST.h"
 #include "juice/Sema/TypeCheckedStatementAST.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/PassManager.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/CodeGen.h"
+#include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/raw_ostream.h"
-#include "llvm/Support/TargetRegistry.h"
-#include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
-#include "llvm/Target/TargetOptions.h"
 
 namespace juice {
     namespace irgen {
-        IRGen::IRGen(sema::TypeChecker::Result typeCheckResult,
-                     std::shared_ptr<diag::DiagnosticEngine> diagnostics):
-            _ast(std::move(typeCheckResult.ast)), _diagnostics(std::move(diagnostics)), _builder(_context) {
+        IRGen::IRGen(const ast::ASTContext & astContext, const sema::TypeChecker::Result & typeCheckResult,
+                     std::shared_ptr<diag::DiagnosticEngine> diagnostics, const CodeGenOptions & options):
+            _astContext(astContext), _ast(*typeCheckResult.ast), _diagnostics(std::move(diagnostics)),
+            _options(options), _ownedContext(std::make_unique<llvm::LLVMContext>()), _context(*_ownedContext),
+            _builder(_context) {
             _module = std::make_unique<llvm::Module>("expression", _context);
-            _allocas.resize(typeCheckResult.allocaVectorSize);
+            _variables.resize(typeCheckResult.allocaVectorSize);
+
+            llvm::SubtargetFeatures features;
+
+            if (_options.cpu == "native") {
+                _targetCPU = llvm::sys::getHostCPUName().str();
+
+                llvm::StringMap<bool> hostFeatures;
+                if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+                    for (const auto & feature: hostFeatures) {
+                        features.AddFeature(feature.getKey(), feature.getValue());
+                    }
+                }
+            } else {
+                _targetCPU = _options.cpu;
+            }
+
+            // Explicitly requested features come last, so they override the ones detected on the host.
+            llvm::SmallVector<llvm::StringRef, 8> requestedFeatures;
+            llvm::StringRef(_options.features).split(requestedFeatures, ',', -1, false);
+            for (llvm::StringRef feature: requestedFeatures) {
+                features.AddFeature(feature.trim());
+            }
+
+            _targetFeatures = features.getString();
+
+            // The target options are recorded on every generated function, so they have to be valid before anything is
+            // generated, not only once a target machine is created.
+            _hasValidTargetOptions = checkTargetOptions();
+        }
+
+        IRGen::~IRGen() {
+            TargetMachineCache::release(std::move(_targetMachine));
         }
 
         bool IRGen::generate() {
+            return generateFunction("main");
+        }
+
+        bool IRGen::generateIncremental(llvm::StringRef functionName) {
+            _hasPersistentVariables = true;
+
+            return generateFunction(functionName);
+        }
+
+        bool IRGen::generateFunction(llvm::StringRef name) {
+            if (!_hasValidTargetOptions) return false;
+
             llvm::Function * printfFunction = createFunction(llvm::Type::getInt32Ty(_context),
                                                              {llvm::Type::getInt8PtrTy(_context)}, true, "printf");
 
-            llvm::Function * mainFunction = createFunction(llvm::Type::getInt32Ty(_context), {}, false, "main");
+            llvm::Function * mainFunction = createFunction(llvm::Type::getInt32Ty(_context), {}, false, name);
+
+            // Recording the target on the function lets the optimizer query the matching cost model, and keeps the
+            // choice intact if the module is compiled again, e.g. from the output of --emit-ir.
+            if (!_targetCPU.empty()) mainFunction->addFnAttr("target-cpu", _targetCPU);
+            if (!_targetFeatures.empty()) mainFunction->addFnAttr("target-features", _targetFeatures);
             llvm::BasicBlock * mainEntryBlock = llvm::BasicBlock::Create(_context, "entry", mainFunction);
             _builder.SetInsertPoint(mainEntryBlock);
 
             llvm::Value * value = generateModule();
 
-            llvm::GlobalVariable * formatString;
-            if (_ast->_type.isBuiltinFloatingPoint()) {
+            llvm::GlobalVariable * formatString = nullptr;
+            if (!value) {
+                assert(_hasPersistentVariables && "Module has to return a value at the moment");
+            } else if (_ast._type.isBuiltinFloatingPoint()) {
                 formatString = _builder.CreateGlobalString("%f\n", ".str");
-            } else if (_ast->_type.isBuiltinBool()) {
+            } else if (_ast._type.isBuiltinBool()) {
                 formatString = _builder.CreateGlobalString("%s\n", ".str");
 
                 auto * trueString = _builder.CreateGlobalString("true", "true.str");
@@ -84,16 +148,18 @@ namespace juice {
                 phi->addIncoming(falseStringValue, falseBlock);
 
                 value = phi;
-            } else if (_ast->_type.isBuiltinInteger()) {
+            } else if (_ast._type.isBuiltinInteger()) {
                 formatString = _builder.CreateGlobalString("%d\n", ".str");
-            } else {
+            } else if (!_hasPersistentVariables) {
                 llvm_unreachable("All possible yield types kinds should be handled here");
             }
 
-            llvm::Value * formatStringValue = _builder.CreateBitCast(formatString, llvm::Type::getInt8PtrTy(_context),
-                                                                     "cast");
+            if (formatString) {
+                llvm::Value * formatStringValue = _builder.CreateBitCast(formatString,
+                                                                         llvm::Type::getInt8PtrTy(_context), "cast");
 
-            _builder.CreateCall(printfFunction, {formatStringValue, value}, "printfCall");
+                _builder.CreateCall(printfFunction, {formatStringValue, value}, "printfCall");
+            }
 
             _builder.CreateRet(_builder.getInt32(0));
 
@@ -115,37 +181,69 @@ namespace juice {
             return true;
         }
 
+        llvm::orc::ThreadSafeModule IRGen::takeModule() {
+            return llvm::orc::ThreadSafeModule(std::move(_module), std::move(_ownedContext));
+        }
+
         void IRGen::dumpProgram(llvm::raw_ostream & os) {
             os << basic::Color::bold;
             _module->print(os, nullptr);
             os << basic::Color::reset;
         }
 
-        bool IRGen::emitObject(llvm::raw_pwrite_stream & os) {
-            llvm::InitializeAllTargetInfos();
-            llvm::InitializeAllTargets();
-            llvm::InitializeAllTargetMCs();
-            llvm::InitializeAllAsmParsers();
-            llvm::InitializeAllAsmPrinters();
+        bool IRGen::optimize(llvm::TimePassesHandler * passTimer) {
+            llvm::OptimizationLevel level;
+            switch (_options.optimizationLevel) {
+                case OptimizationLevel::O0:
+                    return true;
+                case OptimizationLevel::O1:
+                    level = llvm::OptimizationLevel::O1;
+                    break;
+                case OptimizationLevel::O2:
+                    level = llvm::OptimizationLevel::O2;
+                    break;
+                case OptimizationLevel::O3:
+                    level = llvm::OptimizationLevel::O3;
+                    break;
+                case OptimizationLevel::Os:
+                    level = llvm::OptimizationLevel::Os;
+                    break;
+            }
 
-            std::string targetTriple = llvm::sys::getDefaultTargetTriple();
-            _module->setTargetTriple(targetTriple);
+            // The pipeline queries the target for cost models, so it has to be known before optimizing.
+            llvm::TargetMachine * targetMachine = getTargetMachine();
+            if (!targetMachine) return false;
 
-            std::string errorString;
-            const llvm::Target * target = llvm::TargetRegistry::lookupTarget(targetTriple, errorString);
+            llvm::PipelineTuningOptions tuningOptions;
+            tuningOptions.LoopVectorization = level.getSpeedupLevel() > 1;
+            tuningOptions.SLPVectorization = level.getSpeedupLevel() > 1;
 
-            if (!target) {
-                _diagnostics->diagnose(diag::DiagnosticID::target_lookup_error,
-                                       targetTriple.c_str(), errorString.c_str());
-                return false;
-            }
+            llvm::LoopAnalysisManager loopAnalysisManager;
+            llvm::FunctionAnalysisManager functionAnalysisManager;
+            llvm::CGSCCAnalysisManager cgsccAnalysisManager;
+            llvm::ModuleAnalysisManager moduleAnalysisManager;
+
+            llvm::PassInstrumentationCallbacks instrumentationCallbacks;
+            if (passTimer) passTimer->registerCallbacks(instrumentationCallbacks);
 
-            llvm::TargetOptions options;
-            auto relocationModel = llvm::Optional<llvm::Reloc::Model>();
-            auto targetMachine = target->createTargetMachine(targetTriple, "generic", "", options, relocationModel);
+            llvm::PassBuilder passBuilder(targetMachine, tuningOptions, llvm::None, &instrumentationCallbacks);
 
-            _module->setDataLayout(targetMachine->createDataLayout());
+            passBuilder.registerModuleAnalyses(moduleAnalysisManager);
+            passBuilder.registerCGSCCAnalyses(cgsccAnalysisManager);
+            passBuilder.registerFunctionAnalyses(functionAnalysisManager);
+            passBuilder.registerLoopAnalyses(loopAnalysisManager);
+            passBuilder.crossRegisterProxies(loopAnalysisManager, functionAnalysisManager, cgsccAnalysisManager,
+                                             moduleAnalysisManager);
 
+            llvm::ModulePassManager modulePassManager = passBuilder.buildPerModuleDefaultPipeline(level);
+            modulePassManager.run(*_module, moduleAnalysisManager);
+
+            return true;
+        }
+
+        bool IRGen::emitObject(llvm::raw_pwrite_stream & os) {
+            llvm::TargetMachine * targetMachine = getTargetMachine();
+            if (!targetMachine) return false;
 
             llvm::legacy::PassManager outputPassManager;
             auto outputFileType = llvm::CGFT_ObjectFile;
@@ -161,47 +259,127 @@ namespace juice {
             return true;
         }
 
-        llvm::Value * IRGen::generateModule() {
-            switch (_ast->_statements.size()) {
-                case 0:
-                    llvm_unreachable("Module has to return a value at the moment");
-                case 1:
-                    return generateYieldingStatement(std::move(_ast->_statements.front()));
-                default: {
-                    auto last = _ast->_statements.end() - 1;
-                    for (auto it = _ast->_statements.begin(); it < last; ++it) {
-                        generateStatement(std::move(*it));
-                    }
-                    return generateYieldingStatement(std::move(*last));
+        bool IRGen::checkTargetOptions() {
+            if (_options.cpu.empty() && _options.features.empty()) return true;
+
+            std::string targetTriple = llvm::sys::getDefaultTargetTriple();
+
+            std::string errorString;
+            const llvm::Target * target = TargetMachineCache::lookupTarget(targetTriple, errorString);
+            if (!target) {
+                _diagnostics->diagnose(diag::DiagnosticID::target_lookup_error,
+                                       targetTriple.c_str(), errorString.c_str());
+                return false;
+            }
+
+            // LLVM only reports an unknown processor while it creates the target machine, and may then abort because
+            // the processor lacks features the triple requires, so the configuration is checked up front.
+            std::unique_ptr<llvm::MCSubtargetInfo> subtargetInfo(target->createMCSubtargetInfo(targetTriple, "", ""));
+            if (_options.cpu != "native" && !_targetCPU.empty() && !subtargetInfo->isCPUStringValid(_targetCPU)) {
+                _diagnostics->diagnose(diag::DiagnosticID::unknown_target_cpu, (llvm::StringRef)_targetCPU,
+                                       targetTriple.c_str());
+                return false;
+            }
+
+            llvm::SmallVector<llvm::StringRef, 8> requestedFeatures;
+            llvm::StringRef(_options.features).split(requestedFeatures, ',', -1, false);
+            for (llvm::StringRef feature: requestedFeatures) {
+                llvm::StringRef name = llvm::SubtargetFeatures::StripFlag(feature.trim());
+
+                // Toggling a known feature always changes at least its own bit.
+                llvm::FeatureBitset featureBits = subtargetInfo->getFeatureBits();
+                if (subtargetInfo->ToggleFeature(name) == featureBits) {
+                    _diagnostics->diagnose(diag::DiagnosticID::unknown_target_feature, name, targetTriple.c_str());
+                    return false;
                 }
             }
+
+            return true;
         }
 
-        llvm::Value * IRGen::generateBlock(std::unique_ptr<sema::TypeCheckedBlockAST> block) {
-            switch (block->_statements.size()) {
-                case 0:
-                    return nullptr;
-                case 1:
-                    return generateYieldingStatement(std::move(block->_statements.front()));
-                default: {
-                    auto last = block->_statements.end() - 1;
-                    for (auto it = block->_statements.begin(); it < last; ++it) {
-                        generateStatement(std::move(*it));
-                    }
-                    return generateYieldingStatement(std::move(*last));
-                }
+        llvm::TargetMachine * IRGen::getTargetMachine() {
+            if (_targetMachine) return _targetMachine.get();
+            if (!_hasValidTargetOptions) return nullptr;
+
+            std::string targetTriple = llvm::sys::getDefaultTargetTriple();
+            llvm::StringRef cpu = _targetCPU.empty() ? llvm::StringRef("generic") : llvm::StringRef(_targetCPU);
+
+            std::string errorString;
+            _targetMachine = TargetMachineCache::acquire(targetTriple, cpu, _targetFeatures,
+                                                         _options.getCodeGenLevel(), errorString);
+
+            if (!_targetMachine) {
+                _diagnostics->diagnose(diag::DiagnosticID::target_lookup_error,
+                                       targetTriple.c_str(), errorString.c_str());
+                return nullptr;
+            }
+
+            _module->setTargetTriple(targetTriple);
+            _module->setDataLayout(_targetMachine->createDataLayout());
+
+            return _targetMachine.get();
+        }
+
+        llvm::Value * IRGen::generateModule() {
+            if (_ast._statements.empty()) return nullptr;
+
+            auto last = _ast._statements.end() - 1;
+            for (auto it = _ast._statements.begin(); it < last; ++it) {
+                generateStatement(**it);
+            }
+
+            // Only REPL input may end in a statement that doesn't yield a value, e.g. a declaration.
+            if (llvm::isa<sema::NothingType>(_ast._type.getPointer())) {
+                generateStatement(**last);
+                return nullptr;
             }
+
+            return generateYieldingStatement(**last);
         }
 
-        llvm::Value * IRGen::generateControlFlowBody(std::unique_ptr<sema::TypeCheckedControlFlowBodyAST> body) {
-            switch (body->_bodyKind) {
+        llvm::Value * IRGen::generateBlock(const sema::TypeCheckedBlockAST & block) {
+            if (block._statements.empty()) return nullptr;
+
+            ++_blockDepth;
+
+            auto last = block._statements.end() - 1;
+            for (auto it = block._statements.begin(); it < last; ++it) {
+                generateStatement(**it);
+            }
+            llvm::Value * value = generateYieldingStatement(**last);
+
+            --_blockDepth;
+
+            return value;
+        }
+
+        llvm::Value * IRGen::generateControlFlowBody(const sema::TypeCheckedControlFlowBodyAST & body) {
+            switch (body._bodyKind) {
                 case sema::TypeCheckedControlFlowBodyAST::BodyKind::block:
-                    return generateBlock(std::move(body->_block));
+                    return generateBlock(*body._block);
                 case sema::TypeCheckedControlFlowBodyAST::BodyKind::expression:
-                    return generateExpression(std::move(body->_expression));
+                    return generateExpression(*body._expression);
             }
         }
 
+        llvm::Value * IRGen::getVariable(size_t index, llvm::Type * type, llvm::StringRef name) {
+            llvm::Value *& variable = _variables.at(index);
+
+            // A variable without storage in this module was declared by earlier REPL input.
+            if (!variable) {
+                assert(_hasPersistentVariables && "Variable used before its declaration");
+
+                variable = new llvm::GlobalVariable(*_module, type, false, llvm::GlobalValue::ExternalLinkage, nullptr,
+                                                    getPersistentVariableName(index, name));
+            }
+
+            return variable;
+        }
+
+        std::string IRGen::getPersistentVariableName(size_t index, llvm::StringRef name) {
+            return "juice.var." + std::to_string(index) + "." + name.str();
+        }
+
         llvm::Function * IRGen::createFunction(llvm::Type * returnType, const std::vector<llvm::Type *> & params,
                                                bool isVarArg, llvm::StringRef name) {
             llvm::FunctionType * type = llvm::FunctionType::get(returnType, params, isVarArg);
@@ -0,0 +1,99 @@
+// src/juice/IRGen/JIT.cpp - JIT compiler that executes generated modules in the current process
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/IRGen/JIT.h"
+
+#include <string>
+#include <utility>
+
+#include "juice/Diagnostics/Diagnostics.h"
+#include "juice/IRGen/TargetMachineCache.h"
+#include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/Support/Error.h"
+
+namespace juice {
+    namespace irgen {
+        namespace {
+            void diagnoseJITError(llvm::Error error) {
+                std::string message = llvm::toString(std::move(error));
+                diag::DiagnosticEngine::diagnose(diag::DiagnosticID::jit_error, message.c_str());
+            }
+        }
+
+        JIT::JIT(std::unique_ptr<llvm::orc::LLJIT> jit): _jit(std::move(jit)) {}
+
+        std::unique_ptr<JIT> JIT::create(const CodeGenOptions & options) {
+            TargetMachineCache::initializeNativeTarget();
+
+            // The code always runs on the host, so its CPU is the right default. The CPU and features requested in
+            // the options are already recorded on the generated functions by IRGen.
+            auto targetMachineBuilder = llvm::orc::JITTargetMachineBuilder::detectHost();
+            if (!targetMachineBuilder) {
+                diagnoseJITError(targetMachineBuilder.takeError());
+                return nullptr;
+            }
+
+            targetMachineBuilder->setCodeGenOptLevel(options.getCodeGenLevel());
+
+            auto jit = llvm::orc::LLJITBuilder()
+                .setJITTargetMachineBuilder(std::move(*targetMachineBuilder))
+                .create();
+            if (!jit) {
+                diagnoseJITError(jit.takeError());
+                return nullptr;
+            }
+
+            auto processSymbols = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+                (*jit)->getDataLayout().getGlobalPrefix());
+            if (!processSymbols) {
+                diagnoseJITError(processSymbols.takeError());
+                return nullptr;
+            }
+
+            (*jit)->getMainJITDylib().addGenerator(std::move(*processSymbols));
+
+            return std::unique_ptr<JIT>(new JIT(std::move(*jit)));
+        }
+
+        llvm::orc::ResourceTrackerSP JIT::addModule(llvm::orc::ThreadSafeModule module) {
+            auto tracker = _jit->getMainJITDylib().createResourceTracker();
+
+            if (auto error = _jit->addIRModule(tracker, std::move(module))) {
+                diagnoseJITError(std::move(error));
+                removeModule(std::move(tracker));
+                return nullptr;
+            }
+
+            return tracker;
+        }
+
+        bool JIT::removeModule(llvm::orc::ResourceTrackerSP module) {
+            if (auto error = module->remove()) {
+                diagnoseJITError(std::move(error));
+                return false;
+            }
+
+            return true;
+        }
+
+        JIT::Function JIT::lookup(llvm::StringRef name) {
+            auto symbol = _jit->lookup(name);
+            if (!symbol) {
+                diagnoseJITError(symbol.takeError());
+                return nullptr;
+            }
+
+            return llvm::jitTargetAddressToFunction<Function>(symbol->getAddress());
+        }
+    }
+}
@@ -0,0 +1,116 @@
+// src/juice/IRGen/TargetMachineCache.cpp - Process-wide target initialization and reuse of target machines
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/IRGen/TargetMachineCache.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetOptions.h"
+
+namespace juice {
+    namespace irgen {
+        namespace {
+            std::mutex idleTargetMachinesMutex;
+            std::multimap<std::string, std::unique_ptr<llvm::TargetMachine>> idleTargetMachines;
+
+            void initializeAllTargets() {
+                static std::once_flag allTargetsInitialized;
+                std::call_once(allTargetsInitialized, [] {
+                    llvm::InitializeAllTargetInfos();
+                    llvm::InitializeAllTargets();
+                    llvm::InitializeAllTargetMCs();
+                    llvm::InitializeAllAsmParsers();
+                    llvm::InitializeAllAsmPrinters();
+                });
+            }
+        }
+
+        void TargetMachineCache::initializeNativeTarget() {
+            // Registering targets is not thread-safe, and the driver may compile several files on different threads.
+            static std::once_flag nativeTargetInitialized;
+            std::call_once(nativeTargetInitialized, [] {
+                llvm::InitializeNativeTarget();
+                llvm::InitializeNativeTargetAsmParser();
+                llvm::InitializeNativeTargetAsmPrinter();
+            });
+        }
+
+        const llvm::Target * TargetMachineCache::lookupTarget(llvm::StringRef triple, std::string & errorString) {
+            initializeNativeTarget();
+
+            if (const llvm::Target * target = llvm::TargetRegistry::lookupTarget(triple.str(), errorString))
+                return target;
+
+            initializeAllTargets();
+
+            errorString.clear();
+            return llvm::TargetRegistry::lookupTarget(triple.str(), errorString);
+        }
+
+        std::unique_ptr<llvm::TargetMachine>
+        TargetMachineCache::acquire(llvm::StringRef triple, llvm::StringRef cpu, llvm::StringRef features,
+                                    llvm::CodeGenOpt::Level level, std::string & errorString) {
+            std::string key = getKey(triple, cpu, features, level);
+
+            {
+                std::lock_guard<std::mutex> lock(idleTargetMachinesMutex);
+
+                auto it = idleTargetMachines.find(key);
+                if (it != idleTargetMachines.end()) {
+                    auto targetMachine = std::move(it->second);
+                    idleTargetMachines.erase(it);
+
+                    return targetMachine;
+                }
+            }
+
+            const llvm::Target * target = lookupTarget(triple, errorString);
+            if (!target) return nullptr;
+
+            llvm::TargetOptions options;
+            auto relocationModel = llvm::Optional<llvm::Reloc::Model>();
+
+            return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(triple, cpu, features, options,
+                                                                                    relocationModel, llvm::None,
+                                                                                    level));
+        }
+
+        void TargetMachineCache::release(std::unique_ptr<llvm::TargetMachine> targetMachine) {
+            if (!targetMachine) return;
+
+            std::string key = getKey(targetMachine->getTargetTriple().str(), targetMachine->getTargetCPU(),
+                                     targetMachine->getTargetFeatureString(), targetMachine->getOptLevel());
+
+            std::lock_guard<std::mutex> lock(idleTargetMachinesMutex);
+            idleTargetMachines.emplace(std::move(key), std::move(targetMachine));
+        }
+
+        std::string TargetMachineCache::getKey(llvm::StringRef triple, llvm::StringRef cpu, llvm::StringRef features,
+                                               llvm::CodeGenOpt::Level level) {
+            // The parts are separated by null bytes, which none of them can contain.
+            std::string key;
+            key += triple;
+            key += '\0';
+            key += cpu;
+            key += '\0';
+            key += features;
+            key += '\0';
+            key += static_cast<char>('0' + level);
+
+            return key;
+        }
+    }
+}
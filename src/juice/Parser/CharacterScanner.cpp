@@ -0,0 +1,179 @@
+// src/juice/Parser/CharacterScanner.cpp - Vectorized scanning of character runs for the Lexer
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Parser/CharacterScanner.h"
+
+#include <cstdint>
+
+#include "juice/Basic/StringHelpers.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #define JUICE_SCANNER_SSE2 1
+#else
+    #define JUICE_SCANNER_SSE2 0
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define JUICE_SCANNER_AVX2 1
+#else
+    #define JUICE_SCANNER_AVX2 0
+#endif
+
+namespace juice {
+    namespace parser {
+        namespace {
+            bool vectorizedScanning = true;
+
+        #if JUICE_SCANNER_SSE2
+            inline __m128i equal(__m128i chars, char c) {
+                return _mm_cmpeq_epi8(chars, _mm_set1_epi8(c));
+            }
+
+            // Signed comparison is fine here: non-ASCII bytes are negative and therefore never in range.
+            inline __m128i inRange(__m128i chars, char low, char high) {
+                return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(low - 1)),
+                                     _mm_cmplt_epi8(chars, _mm_set1_epi8(high + 1)));
+            }
+
+            inline __m128i toLower(__m128i chars) {
+                return _mm_or_si128(chars, _mm_set1_epi8(0x20));
+            }
+
+            inline __m128i either(__m128i a, __m128i b) {
+                return _mm_or_si128(a, b);
+            }
+        #endif
+
+        #if JUICE_SCANNER_AVX2
+            inline __m256i equal(__m256i chars, char c) {
+                return _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(c));
+            }
+
+            inline __m256i inRange(__m256i chars, char low, char high) {
+                return _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8(low - 1)),
+                                        _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), chars));
+            }
+
+            inline __m256i toLower(__m256i chars) {
+                return _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+            }
+
+            inline __m256i either(__m256i a, __m256i b) {
+                return _mm256_or_si256(a, b);
+            }
+        #endif
+
+            struct HorizontalWhitespace {
+                static constexpr bool inverted = false;
+
+                static bool matches(char c) {
+                    return c == ' ' || c == '\t' || c == '\r';
+                }
+
+                template <typename Vector>
+                static Vector matches(Vector chars) {
+                    return either(either(equal(chars, ' '), equal(chars, '\t')), equal(chars, '\r'));
+                }
+            };
+
+            struct IdentifierChar {
+                static constexpr bool inverted = false;
+
+                static bool matches(char c) {
+                    return basic::isIdentifierChar(c);
+                }
+
+                template <typename Vector>
+                static Vector matches(Vector chars) {
+                    return either(either(inRange(toLower(chars), 'a', 'z'), inRange(chars, '0', '9')),
+                                  equal(chars, '_'));
+                }
+            };
+
+            struct Digit {
+                static constexpr bool inverted = false;
+
+                static bool matches(char c) {
+                    return basic::isDigit(c);
+                }
+
+                template <typename Vector>
+                static Vector matches(Vector chars) {
+                    return inRange(chars, '0', '9');
+                }
+            };
+
+            // Vectorized, this matches newlines instead, so the resulting mask must not be inverted.
+            struct NotNewline {
+                static constexpr bool inverted = true;
+
+                static bool matches(char c) {
+                    return c != '\n';
+                }
+
+                template <typename Vector>
+                static Vector matches(Vector chars) {
+                    return equal(chars, '\n');
+                }
+            };
+
+            template <typename Class>
+            const char * scan(const char * current, const char * end) {
+            #if JUICE_SCANNER_AVX2
+                while (vectorizedScanning && end - current >= 32) {
+                    __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(current));
+                    auto mask = (uint32_t)_mm256_movemask_epi8(Class::matches(chars));
+                    if (!Class::inverted) mask = ~mask;
+
+                    if (mask != 0) return current + __builtin_ctz(mask);
+                    current += 32;
+                }
+            #endif
+
+            #if JUICE_SCANNER_SSE2
+                while (vectorizedScanning && end - current >= 16) {
+                    __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current));
+                    auto mask = (uint32_t)_mm_movemask_epi8(Class::matches(chars));
+                    if (!Class::inverted) mask = ~mask & 0xFFFF;
+
+                    if (mask != 0) return current + __builtin_ctz(mask);
+                    current += 16;
+                }
+            #endif
+
+                while (current < end && Class::matches(*current)) current++;
+                return current;
+            }
+        }
+
+        const char * scanHorizontalWhitespace(const char * current, const char * end) {
+            return scan<HorizontalWhitespace>(current, end);
+        }
+
+        const char * scanIdentifierChars(const char * current, const char * end) {
+            return scan<IdentifierChar>(current, end);
+        }
+
+        const char * scanDigits(const char * current, const char * end) {
+            return scan<Digit>(current, end);
+        }
+
+        const char * scanToNewline(const char * current, const char * end) {
+            return scan<NotNewline>(current, end);
+        }
+
+        void setVectorizedScanning(bool enabled) {
+            vectorizedScanning = enabled;
+        }
+    }
+}
@@ -1,4 +1,4 @@
-// src/juice/Parser/FSM.cpp - finite state machine classes for lexing string and number literals
+// src/juice/Parser/FSM.cpp - Finite state machines used by the Lexer
 //
 // This source file is part of the juice open source project
 //
@@ -11,133 +11,117 @@
 
 #include "juice/Parser/FSM.h"
 
-#include <utility>
-
-#include "juice/Basic/StringHelpers.h"
-
 namespace juice {
     namespace parser {
-        static const FSM::StateReturn acceptedState = {false, FSM::noNextState};
-        static const FSM::StateReturn errorState = {true, FSM::noNextState};
+        constexpr uint8_t FSM::noNextState;
 
-        FSM::Return FSM::run(const char * start, const char * end, FSM::State initialState) {
+        template <typename Machine>
+        FSM::Return<typename Machine::State> FSM::run(const char * start, const char * end,
+                                                      typename Machine::State initialState) {
             const char * current = start;
             const char * error = nullptr;
-            State currentState = initialState;
+            uint8_t currentState = initialState;
+
+            const char * last = (end[-1] == '\n') ? end : end + 1;
 
-            while (!((current == end && current[-1] == '\n') || current > end)) {
-                StateReturn result = currentState((current == end && current[-1] != '\n') ? "\n" : current);
-                if (result.error && error == nullptr) error = current;
-                if (result.next == &FSM::noNextState) {
-                    return {error, (size_t)(current - start), currentState};
+            while (current < last) {
+                char c = (current == end) ? '\n' : *current;
+
+                Transition transition = Machine::transitions[currentState][Machine::classify(c, current)];
+                if (transition.error && error == nullptr) error = current;
+                if (transition.next == noNextState) {
+                    return {error, (size_t)(current - start), (typename Machine::State)currentState};
                 }
 
                 current++;
-                currentState = result.next;
+                currentState = transition.next;
             }
 
-            return {current, (size_t)(current - start), currentState};
+            return {current, (size_t)(current - start), (typename Machine::State)currentState};
         }
 
-        FSM::StateReturn FSM::noNextState(const char *) {
-            return errorState;
-        }
 
+        static constexpr FSM::Transition accept = {false, FSM::noNextState};
+        static constexpr FSM::Transition reject = {true, FSM::noNextState};
 
-        FSM::Return NumberFSM::run(const char * start, const char * end) {
-            return FSM::run(start, end, begin);
-        }
+        constexpr FSM::CharacterClasses NumberFSM::createCharacterClasses() {
+            FSM::CharacterClasses result = {};
 
-        FSM::StateReturn NumberFSM::begin(const char * current) {
-            if (basic::isDigit(*current)) return {false, integer};
-            return errorState;
-        }
-
-        FSM::StateReturn NumberFSM::integer(const char * current) {
-            if (basic::isDigit(*current)) return {false, integer};
+            for (int c = '0'; c <= '9'; c++) result.classes[c] = digit;
+            result.classes['.'] = dot;
+            result.classes['e'] = result.classes['E'] = exponent;
+            result.classes['+'] = result.classes['-'] = sign;
 
-            if (*current == '.') {
-                if (*(current + 1) == '.') return acceptedState;
-                return {false, beginDecimal};
-            }
-
-            if (basic::toLower(*current) == 'e') return {false, beginExponent};
-            return acceptedState;
+            return result;
         }
 
-        FSM::StateReturn NumberFSM::beginDecimal(const char * current) {
-            if (basic::isDigit(*current)) return {false, decimal};
-            return errorState;
-        }
+        constexpr FSM::CharacterClasses NumberFSM::characterClasses = createCharacterClasses();
 
-        FSM::StateReturn NumberFSM::decimal(const char * current) {
-            if (basic::isDigit(*current)) return {false, decimal};
+        constexpr FSM::Transition NumberFSM::transitions[][classCount] = {
+            // Columns: other, digit, dot, dotDot, exponent, sign
+            // begin
+            {reject, {false, integer}, reject, reject, reject, reject},
+            // integer
+            {accept, {false, integer}, {false, beginDecimal}, accept, {false, beginExponent}, accept},
+            // beginDecimal
+            {reject, {false, decimal}, reject, reject, reject, reject},
+            // decimal
+            {accept, {false, decimal}, accept, accept, {false, beginExponent}, accept},
+            // beginExponent
+            {reject, {false, decimalWithExponent}, reject, reject, reject, {false, beginSignedExponent}},
+            // beginSignedExponent
+            {reject, {false, decimalWithExponent}, reject, reject, reject, reject},
+            // decimalWithExponent
+            {accept, {false, decimalWithExponent}, accept, accept, accept, accept}
+        };
 
-            if (basic::toLower(*current) == 'e') return {false, beginExponent};
-            return acceptedState;
+        uint8_t NumberFSM::classify(char c, const char * current) {
+            uint8_t characterClass = characterClasses.classes[(unsigned char)c];
+            if (characterClass == dot && current[1] == '.') return dotDot;
+            return characterClass;
         }
 
-        FSM::StateReturn NumberFSM::beginExponent(const char * current) {
-            if (*current == '+' || *current == '-')  return {false, beginSignedExponent};
-
-            if (basic::isDigit(*current)) return {false, decimalWithExponent};
-            return errorState;
-        }
-
-        FSM::StateReturn NumberFSM::beginSignedExponent(const char * current) {
-            if (basic::isDigit(*current)) return {false, decimalWithExponent};
-            return errorState;
-        }
-
-        FSM::StateReturn NumberFSM::decimalWithExponent(const char * current) {
-            if (basic::isDigit(*current)) return {false, decimalWithExponent};
-            return acceptedState;
+        FSM::Return<NumberFSM::State> NumberFSM::run(const char * start, const char * end) {
+            return FSM::run<NumberFSM>(start, end, begin);
         }
 
 
-        FSM::Return StringFSM::run(const char * start, const char * end) {
-            return FSM::run(start, end, begin);
-        }
+        constexpr FSM::CharacterClasses StringFSM::createCharacterClasses() {
+            FSM::CharacterClasses result = {};
 
-        FSM::StateReturn StringFSM::begin(const char * current) {
-            if (*current == '"') return {false, string};
-            return errorState;
-        }
+            result.classes['"'] = quote;
+            result.classes['\\'] = backslash;
+            result.classes['\n'] = newline;
+            result.classes['0'] = result.classes['t'] = result.classes['n'] = result.classes['r']
+                = result.classes['\''] = escapable;
 
-        FSM::StateReturn StringFSM::string(const char * current) {
-            if (*current == '\\') return {false, escape};
-            if (*current == '\n') return errorState;
-            if (*current == '"') return {false, end};
-            return {false, string};
+            return result;
         }
 
-        FSM::StateReturn StringFSM::escape(const char * current) {
-            switch (*current) {
-                case '0':
-                case '\\':
-                case 't':
-                case 'n':
-                case 'r':
-                case '"':
-                case '\'':
-                    return {false, string};
-                default:
-                    return {true, invalidEscape};
-            }
-        }
+        constexpr FSM::CharacterClasses StringFSM::characterClasses = createCharacterClasses();
 
-        FSM::StateReturn StringFSM::invalidEscape(const char * current) {
-            if (*current == '\n') return errorState;
-            if (*current == '"') return {false, invalidEscapeEnd};
-            return {false, invalidEscape};
-        }
+        constexpr FSM::Transition StringFSM::transitions[][classCount] = {
+            // Columns: other, quote, backslash, newline, escapable
+            // begin
+            {reject, {false, string}, reject, reject, reject},
+            // string
+            {{false, string}, {false, end}, {false, escape}, reject, {false, string}},
+            // escape
+            {{true, invalidEscape}, {false, string}, {false, string}, {true, invalidEscape}, {false, string}},
+            // invalidEscape
+            {{false, invalidEscape}, {false, invalidEscapeEnd}, {false, invalidEscape}, reject, {false, invalidEscape}},
+            // end
+            {accept, accept, accept, accept, accept},
+            // invalidEscapeEnd
+            {reject, reject, reject, reject, reject}
+        };
 
-        FSM::StateReturn StringFSM::end(const char *) {
-            return acceptedState;
+        uint8_t StringFSM::classify(char c, const char *) {
+            return characterClasses.classes[(unsigned char)c];
         }
 
-        FSM::StateReturn StringFSM::invalidEscapeEnd(const char * current) {
-            return errorState;
+        FSM::Return<StringFSM::State> StringFSM::run(const char * start, const char * end) {
+            return FSM::run<StringFSM>(start, end, begin);
         }
     }
 }
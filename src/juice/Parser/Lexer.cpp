@@ -11,14 +11,111 @@
 
 #include "juice/Parser/Lexer.h"
 
+#include <cstdint>
+#include <cstring>
 #include <utility>
 
 #include "juice/Basic/StringHelpers.h"
+#include "juice/Parser/CharacterScanner.h"
 #include "juice/Parser/FSM.h"
 #include "llvm/ADT/StringRef.h"
 
 namespace juice {
     namespace parser {
+        namespace {
+            struct Keyword {
+                const char * spelling;
+                size_t length;
+                LexerToken::Type type;
+            };
+
+            constexpr Keyword keywords[] = {
+                #define KEYWORD(Name, Spelling, DumpName) \
+                {Spelling, sizeof(Spelling) - 1, LexerToken::Type::keyword##Name},
+                #include "juice/Parser/Keywords.def"
+            };
+
+            constexpr size_t keywordCount = sizeof(keywords) / sizeof(Keyword);
+
+            constexpr size_t maximumKeywordLength() {
+                size_t result = 0;
+                for (const Keyword & keyword: keywords) {
+                    if (keyword.length > result) result = keyword.length;
+                }
+                return result;
+            }
+
+            constexpr size_t minimumKeywordLength() {
+                size_t result = maximumKeywordLength();
+                for (const Keyword & keyword: keywords) {
+                    if (keyword.length < result) result = keyword.length;
+                }
+                return result;
+            }
+
+            static_assert(minimumKeywordLength() >= 2, "The keyword hash reads the first two characters");
+
+            constexpr unsigned int keywordHashBits = 7;
+            constexpr size_t keywordTableSize = 1u << keywordHashBits;
+
+            static_assert(keywordCount <= keywordTableSize / 2, "The keyword table is too small");
+
+            // The hash combines the length with the first, second and last character of an identifier, and spreads
+            // that key with a multiplier chosen at compile time so that no two keywords share a slot.
+            constexpr uint32_t keywordKey(const char * string, size_t length) {
+                return (uint32_t)(unsigned char)string[0] | (uint32_t)(unsigned char)string[1] << 8u
+                       | (uint32_t)(unsigned char)string[length - 1] << 16u | (uint32_t)length << 24u;
+            }
+
+            constexpr uint32_t keywordHash(uint32_t key, uint32_t multiplier) {
+                return (uint32_t)(key * multiplier) >> (32u - keywordHashBits);
+            }
+
+            constexpr bool isPerfectMultiplier(uint32_t multiplier) {
+                bool used[keywordTableSize] = {};
+
+                for (const Keyword & keyword: keywords) {
+                    uint32_t hash = keywordHash(keywordKey(keyword.spelling, keyword.length), multiplier);
+                    if (used[hash]) return false;
+                    used[hash] = true;
+                }
+
+                return true;
+            }
+
+            constexpr uint32_t findPerfectMultiplier() {
+                for (uint32_t multiplier = 0x9E3779B1u; multiplier != 0x9E3779B1u + 2 * 4096; multiplier += 2) {
+                    if (isPerfectMultiplier(multiplier)) return multiplier;
+                }
+                return 0;
+            }
+
+            constexpr uint32_t keywordMultiplier = findPerfectMultiplier();
+
+            static_assert(keywordMultiplier != 0, "Could not find a perfect hash for the keyword set");
+
+            struct KeywordTable {
+                uint8_t entries[keywordTableSize];
+            };
+
+            constexpr uint8_t noKeyword = 0xFF;
+
+            constexpr KeywordTable createKeywordTable() {
+                KeywordTable table = {};
+
+                for (size_t i = 0; i < keywordTableSize; i++) table.entries[i] = noKeyword;
+
+                for (size_t i = 0; i < keywordCount; i++) {
+                    const Keyword & keyword = keywords[i];
+                    table.entries[keywordHash(keywordKey(keyword.spelling, keyword.length), keywordMultiplier)] = i;
+                }
+
+                return table;
+            }
+
+            constexpr KeywordTable keywordTable = createKeywordTable();
+        }
+
         char Lexer::peek() {
             if (_current == _sourceBuffer->getEnd() && _current[-1] != '\n') return '\n';
             return *_current;
@@ -52,23 +149,22 @@ namespace juice {
             return true;
         }
 
-        std::unique_ptr<LexerToken> Lexer::makeToken(LexerToken::Type type) {
-            llvm::StringRef string(_start, _current - _start);
-            return std::make_unique<LexerToken>(type, string);
+        LexerToken::Type Lexer::makeToken(LexerToken::Type type) {
+            return type;
         }
 
-        std::unique_ptr<LexerToken> Lexer::errorToken(diag::DiagnosticID id, bool atEnd) {
-            llvm::StringRef string(_start, _current - _start);
-            return std::make_unique<ErrorToken>(string, id, atEnd ? _current : _start);
+        LexerToken::Type Lexer::errorToken(diag::DiagnosticID id, bool atEnd) {
+            return errorToken(id, atEnd ? _current : _start);
         }
 
-        std::unique_ptr<LexerToken> Lexer::errorToken(diag::DiagnosticID id, const char * position) {
-            llvm::StringRef string(_start, _current - _start);
-            return std::make_unique<ErrorToken>(string, id, position);
+        LexerToken::Type Lexer::errorToken(diag::DiagnosticID id, const char * position) {
+            _errorID = id;
+            _errorPosition = position;
+            return LexerToken::Type::error;
         }
 
         void Lexer::skipLineComment() {
-            while (peek() != '\n' && !isAtEnd()) advance();
+            _current = scanToNewline(_current, _sourceBuffer->getEnd());
         }
 
         bool Lexer::skipBlockComment() {
@@ -94,121 +190,22 @@ namespace juice {
             return true;
         }
 
-        LexerToken::Type Lexer::checkKeyword(int startCount, int length, const char * rest,
-                                             juice::parser::LexerToken::Type type) {
-            if (_current - _start == startCount + length && memcmp(_start + startCount, rest, length) == 0) {
-                return type;
-            }
+        LexerToken::Type Lexer::identifierType(llvm::StringRef string) {
+            size_t length = string.size();
+            if (length < minimumKeywordLength() || length > maximumKeywordLength()) return LexerToken::Type::identifier;
 
-            return LexerToken::Type::identifier;
-        }
+            uint8_t index = keywordTable.entries[keywordHash(keywordKey(string.data(), length), keywordMultiplier)];
+            if (index == noKeyword) return LexerToken::Type::identifier;
 
-        LexerToken::Type Lexer::identifierType() {
-            switch (_start[0]) {
-                case 'a': return checkKeyword(1, 1, "s", LexerToken::Type::keywordAs);
-                case 'b': {
-                    if (_current - _start > 1) {
-                        switch (_start[1]) {
-                            case 'i': return checkKeyword(2, 4, "nary", LexerToken::Type::keywordBinary);
-                            case 'r': return checkKeyword(2, 3, "eak", LexerToken::Type::keywordBreak);
-                        }
-                    }
-                    break;
-                }
-                case 'c': {
-                    if (_current - _start > 1) {
-                        switch (_start[1]) {
-                            case 'a': return checkKeyword(2, 2, "se", LexerToken::Type::keywordCase);
-                            case 'l': return checkKeyword(2, 3, "ass", LexerToken::Type::keywordClass);
-                            case 'o': {
-                                if (_current - _start > 2) {
-                                    switch (_start[2]) {
-                                        case 'm': return checkKeyword(3, 5, "pound", LexerToken::Type::keywordCompound);
-                                        case 'n': return checkKeyword(3, 5, "tinue", LexerToken::Type::keywordContinue);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    break;
-                }
-                case 'd': return checkKeyword(1, 1, "o", LexerToken::Type::keywordDo);
-                case 'e': {
-                    if (_current - _start > 2 && _start[1] == 'l') {
-                        switch (_start[2]) {
-                            case 'i': return checkKeyword(3, 1, "f", LexerToken::Type::keywordElif);
-                            case 's': return checkKeyword(3, 1, "e", LexerToken::Type::keywordElse);
-                        }
-                    }
-                    break;
-                }
-                case 'f': {
-                    if (_current - _start > 1) {
-                        switch (_start[1]) {
-                            case 'a': {
-                                if (_current - _start > 2) {
-                                    switch (_start[2]) {
-                                        case 'i': return checkKeyword(3, 5, "lable", LexerToken::Type::keywordFailable);
-                                        case 'l': return checkKeyword(3, 2, "se", LexerToken::Type::keywordFalse);
-                                    }
-                                }
-                                break;
-                            }
-                            case 'o': return checkKeyword(2, 1, "r", LexerToken::Type::keywordFor);
-                            case 'u': return checkKeyword(2, 2, "nc", LexerToken::Type::keywordFunc);
-                        }
-                    }
-                    break;
-                }
-                case 'i': {
-                    if (_current - _start > 1) {
-                        switch (_start[1]) {
-                            case 'f': return checkKeyword(2, 0, "", LexerToken::Type::keywordIf);
-                            case 'n':
-                                if (_current - _start > 2) {
-                                    return checkKeyword(2, 2, "it", LexerToken::Type::keywordInit);
-                                } else {
-                                    return LexerToken::Type::keywordIn;
-                                }
-                            case 's': return checkKeyword(2, 0, "", LexerToken::Type::keywordIs);
-                        }
-                    }
-                    break;
-                }
-                case 'l': return checkKeyword(1, 2, "et", LexerToken::Type::keywordLet);
-                case 'n': return checkKeyword(1, 2, "il", LexerToken::Type::keywordNil);
-                case 'o': return checkKeyword(1, 7, "verride", LexerToken::Type::keywordOverride);
-                case 'p': {
-                    if (_current - _start > 3 && _start[1] == 'r' && _start[2] == 'i') {
-                        switch (_start[3]) {
-                            case 'n': return checkKeyword(4, 1, "t", LexerToken::Type::keywordPrint);
-                            case 'v': return checkKeyword(4, 3, "ate", LexerToken::Type::keywordPrivate);
-                        }
-                    }
-                    break;
-                }
-                case 'r': return checkKeyword(1, 5, "eturn", LexerToken::Type::keywordReturn);
-                case 's': {
-                    if (_current - _start > 1) {
-                        switch (_start[1]) {
-                            case 'e': return checkKeyword(2, 2, "lf", LexerToken::Type::keywordSelf);
-                            case 'u': return checkKeyword(2, 3, "per", LexerToken::Type::keywordSuper);
-                            case 'w': return checkKeyword(2, 4, "itch", LexerToken::Type::keywordSwitch);
-                        }
-                    }
-                    break;
-                }
-                case 't': return checkKeyword(1, 3, "rue", LexerToken::Type::keywordTrue);
-                case 'u': return checkKeyword(1, 4, "nary", LexerToken::Type::keywordUnary);
-                case 'v': return checkKeyword(1, 2, "ar", LexerToken::Type::keywordVar);
-                case 'w': return checkKeyword(1, 4, "hile", LexerToken::Type::keywordWhile);
-            }
+            const Keyword & keyword = keywords[index];
+            if (keyword.length != length || memcmp(string.data(), keyword.spelling, length) != 0)
+                return LexerToken::Type::identifier;
 
-            return LexerToken::Type::identifier;
+            return keyword.type;
         }
 
-        std::unique_ptr<LexerToken> Lexer::stringLiteral() {
-            FSM::Return result = StringFSM::run(_start, _sourceBuffer->getEnd());
+        LexerToken::Type Lexer::stringLiteral() {
+            auto result = StringFSM::run(_start, _sourceBuffer->getEnd());
 
             advanceBy(result.length - 1);
 
@@ -219,14 +216,22 @@ namespace juice {
             return errorToken(diag::DiagnosticID::unterminated_string, result.error);
         }
 
-        std::unique_ptr<LexerToken> Lexer::identifier() {
-            while (basic::isIdentifierChar(peek())) advance();
+        LexerToken::Type Lexer::identifier() {
+            _current = scanIdentifierChars(_current, _sourceBuffer->getEnd());
 
-            return makeToken(identifierType());
+            return makeToken(identifierType(llvm::StringRef(_start, _current - _start)));
         }
 
-        std::unique_ptr<LexerToken> Lexer::numberLiteral() {
-            FSM::Return result = NumberFSM::run(_start, _sourceBuffer->getEnd());
+        LexerToken::Type Lexer::numberLiteral() {
+            const char * digitsEnd = scanDigits(_current, _sourceBuffer->getEnd());
+
+            if (digitsEnd == _sourceBuffer->getEnd()
+                || (*digitsEnd != '.' && basic::toLower(*digitsEnd) != 'e')) {
+                _current = digitsEnd;
+                return makeToken(LexerToken::Type::integerLiteral);
+            }
+
+            auto result = NumberFSM::run(_start, _sourceBuffer->getEnd());
 
             advanceBy(result.length - 1);
 
@@ -241,11 +246,7 @@ namespace juice {
             return errorToken(diag::DiagnosticID::expected_digit_exponent, result.error);
         }
 
-        Lexer::Lexer(std::shared_ptr<basic::SourceBuffer> sourceBuffer): _sourceBuffer(std::move(sourceBuffer)) {
-            _start = _current = _sourceBuffer->getStart();
-        }
-
-        std::unique_ptr<LexerToken> Lexer::nextToken() {
+        LexerToken::Type Lexer::scanToken() {
             if (isAtEnd()) return makeToken(LexerToken::Type::eof);
 
             while(!isAtEnd()) {
@@ -258,9 +259,7 @@ namespace juice {
                     case ' ':
                     case '\r':
                     case '\t': {
-                        while (peek() == ' ' || peek() == '\r' || peek() == '\t') {
-                            advance();
-                        }
+                        _current = scanHorizontalWhitespace(_current, _sourceBuffer->getEnd());
                         break;
                     }
                     case '(': return makeToken(LexerToken::Type::delimiterLeftParen);
@@ -318,5 +317,33 @@ namespace juice {
 
             return makeToken(LexerToken::Type::eof);
         }
+
+        Lexer::Lexer(std::shared_ptr<basic::SourceBuffer> sourceBuffer):
+            _sourceBuffer(std::move(sourceBuffer)), _errorID(), _errorPosition(nullptr) {
+            _start = _current = _sourceBuffer->getStart();
+        }
+
+        TokenBuffer Lexer::tokenize() {
+            TokenBuffer buffer(_sourceBuffer);
+            buffer.reserve(_sourceBuffer->getSize() / 4 + 1);
+
+            LexerToken::Type type;
+            do {
+                type = scanToken();
+
+                if (type == LexerToken::Type::error) buffer.appendError(_start, _current, _errorID, _errorPosition);
+                else buffer.append(type, _start, _current);
+            } while (type != LexerToken::Type::eof);
+
+            return buffer;
+        }
+
+        std::unique_ptr<LexerToken> Lexer::nextToken() {
+            LexerToken::Type type = scanToken();
+            llvm::StringRef string(_start, _current - _start);
+
+            if (type == LexerToken::Type::error) return std::make_unique<ErrorToken>(string, _errorID, _errorPosition);
+            return std::make_unique<LexerToken>(type, string);
+        }
     }
 }
@@ -54,37 +54,9 @@ namespace juice {
                 case LexerToken::Type::delimiterRightBracket:   return "DELIMITER_RIGHT_BRACKET";
                 case LexerToken::Type::delimiterRightParen:     return "DELIMITER_RIGHT_PARENTHESIS";
                 case LexerToken::Type::delimiterSemicolon:      return "DELIMITER_SEMICOLON";
-                case LexerToken::Type::keywordBinary:           return "KEYWORD_BINARY";
-                case LexerToken::Type::keywordClass:            return "KEYWORD_CLASS";
-                case LexerToken::Type::keywordCompound:         return "KEYWORD_COMPOUND";
-                case LexerToken::Type::keywordFailable:         return "KEYWORD_FAILABLE";
-                case LexerToken::Type::keywordFunc:             return "KEYWORD_FUNC";
-                case LexerToken::Type::keywordInit:             return "KEYWORD_INIT";
-                case LexerToken::Type::keywordLet:              return "KEYWORD_LET";
-                case LexerToken::Type::keywordOverride:         return "KEYWORD_OVERRIDE";
-                case LexerToken::Type::keywordPrivate:          return "KEYWORD_PRIVATE";
-                case LexerToken::Type::keywordUnary:            return "KEYWORD_UNARY";
-                case LexerToken::Type::keywordVar:              return "KEYWORD_VAR";
-                case LexerToken::Type::keywordBreak:            return "KEYWORD_BREAK";
-                case LexerToken::Type::keywordCase:             return "KEYWORD_CASE";
-                case LexerToken::Type::keywordContinue:         return "KEYWORD_CONTINUE";
-                case LexerToken::Type::keywordDo:               return "KEYWORD_DO";
-                case LexerToken::Type::keywordElif:             return "KEYWORD_ELIF";
-                case LexerToken::Type::keywordElse:             return "KEYWORD_ELSE";
-                case LexerToken::Type::keywordFor:              return "KEYWORD_FOR";
-                case LexerToken::Type::keywordIf:               return "KEYWORD_IF";
-                case LexerToken::Type::keywordIn:               return "KEYWORD_IN";
-                case LexerToken::Type::keywordReturn:           return "KEYWORD_RETURN";
-                case LexerToken::Type::keywordSwitch:           return "KEYWORD_SWITCH";
-                case LexerToken::Type::keywordWhile:            return "KEYWORD_WHILE";
-                case LexerToken::Type::keywordAs:               return "KEYWORD_AS";
-                case LexerToken::Type::keywordFalse:            return "KEYWORD_FALSE";
-                case LexerToken::Type::keywordIs:               return "KEYWORD_IS";
-                case LexerToken::Type::keywordNil:              return "KEYWORD_NIL";
-                case LexerToken::Type::keywordPrint:            return "KEYWORD_PRINT";
-                case LexerToken::Type::keywordSelf:             return "KEYWORD_SELF";
-                case LexerToken::Type::keywordSuper:            return "KEYWORD_SUPER";
-                case LexerToken::Type::keywordTrue:             return "KEYWORD_TRUE";
+                #define KEYWORD(Name, Spelling, DumpName) \
+                case LexerToken::Type::keyword##Name: return DumpName;
+                #include "juice/Parser/Keywords.def"
                 case LexerToken::Type::identifier:              return "IDENTIFIER";
                 case LexerToken::Type::integerLiteral:          return "INTEGER_LITERAL";
                 case LexerToken::Type::floatingPointLiteral:          return "DECIMAL_LITERAL";
@@ -99,14 +71,13 @@ namespace juice {
             diagnostics.diagnose(location, diag::DiagnosticID::lexer_token, this);
         }
 
-        std::unique_ptr<LexerTokenStream> operator<<(llvm::raw_ostream & os, const LexerToken * token) {
-            return std::make_unique<LexerTokenStream>(os, token);
+        LexerTokenStream operator<<(llvm::raw_ostream & os, const LexerToken * token) {
+            return LexerTokenStream(os, token);
         }
 
-        llvm::raw_ostream & operator<<(std::unique_ptr<LexerTokenStream> tokenStream,
-                                       const basic::SourceManager * sourceManager) {
-            llvm::raw_ostream & os = tokenStream->getOS();
-            const LexerToken * token = tokenStream->getToken();
+        llvm::raw_ostream & operator<<(LexerTokenStream tokenStream, const basic::SourceManager * sourceManager) {
+            llvm::raw_ostream & os = tokenStream.getOS();
+            const LexerToken * token = tokenStream.getToken();
 
             os << "<" << tokenTypeName(token);
 
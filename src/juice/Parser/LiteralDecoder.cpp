@@ -0,0 +1,133 @@
+// src/juice/Parser/LiteralDecoder.cpp - Decoding of integer and floating-point literal tokens
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Parser/LiteralDecoder.h"
+
+#include <cstdint>
+
+#include "juice/Basic/StringHelpers.h"
+#include "llvm/Support/Error.h"
+
+namespace juice {
+    namespace parser {
+        namespace {
+            // The longest run of decimal digits that always fits into an uint64_t.
+            constexpr size_t maximumFastIntegerDigits = 19;
+
+            struct DecimalParts {
+                uint64_t mantissa;
+                int exponent;
+                bool isExact;
+            };
+
+            // Splits a literal of the form digits[.digits][(e|E)[+|-]digits] into a decimal mantissa and exponent.
+            // isExact is false if the mantissa had to be truncated, in which case only the slow path may be used.
+            DecimalParts splitDecimal(llvm::StringRef string) {
+                const char * current = string.begin();
+                const char * end = string.end();
+
+                uint64_t mantissa = 0;
+                int exponent = 0;
+                size_t significantDigits = 0;
+                bool isExact = true;
+
+                auto addDigit = [&](char c) {
+                    if (mantissa == 0 && c == '0') return;
+                    if (significantDigits == maximumFastIntegerDigits) {
+                        if (c != '0') isExact = false;
+                        exponent++;
+                        return;
+                    }
+
+                    mantissa = mantissa * 10 + (c - '0');
+                    significantDigits++;
+                };
+
+                for (; current != end && basic::isDigit(*current); current++) addDigit(*current);
+
+                if (current != end && *current == '.') {
+                    for (current++; current != end && basic::isDigit(*current); current++) {
+                        addDigit(*current);
+                        exponent--;
+                    }
+                }
+
+                if (current != end && basic::toLower(*current) == 'e') {
+                    current++;
+
+                    bool isNegative = false;
+                    if (current != end && (*current == '+' || *current == '-')) isNegative = *current++ == '-';
+
+                    int explicitExponent = 0;
+                    for (; current != end && basic::isDigit(*current); current++) {
+                        if (explicitExponent < 100000) explicitExponent = explicitExponent * 10 + (*current - '0');
+                    }
+
+                    exponent += isNegative ? -explicitExponent : explicitExponent;
+                }
+
+                return {mantissa, exponent, isExact};
+            }
+
+            // Clinger's fast path: if both the mantissa and the power of ten are exactly representable, a single
+            // multiplication or division yields the correctly rounded result.
+            template <typename Float, int mantissaBits, int maximumExactPower>
+            bool tryFastPath(const DecimalParts & parts, Float & result) {
+                static constexpr Float powersOfTen[] = {
+                    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16,
+                    1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+                };
+
+                if (!parts.isExact || parts.mantissa > (uint64_t(1) << mantissaBits)) return false;
+                if (parts.exponent < -maximumExactPower || parts.exponent > maximumExactPower) return false;
+
+                auto mantissa = (Float)parts.mantissa;
+
+                if (parts.exponent < 0) result = mantissa / powersOfTen[-parts.exponent];
+                else result = mantissa * powersOfTen[parts.exponent];
+
+                return true;
+            }
+        }
+
+        llvm::APInt decodeIntegerLiteral(llvm::StringRef string) {
+            if (string.size() <= maximumFastIntegerDigits) {
+                uint64_t value = 0;
+                for (char c: string) value = value * 10 + (c - '0');
+
+                return llvm::APInt(64, value);
+            }
+
+            unsigned int bitsNeeded = llvm::APInt::getBitsNeeded(string, 10);
+            llvm::APInt value(bitsNeeded < 64 ? 64 : bitsNeeded, string, 10);
+
+            unsigned int activeBits = value.getActiveBits();
+            return value.zextOrTrunc(activeBits < 64 ? 64 : activeBits);
+        }
+
+        llvm::APFloat decodeFloatingPointLiteral(llvm::StringRef string, const llvm::fltSemantics & semantics) {
+            DecimalParts parts = splitDecimal(string);
+
+            if (&semantics == &llvm::APFloat::IEEEdouble()) {
+                double result;
+                if (tryFastPath<double, 53, 22>(parts, result)) return llvm::APFloat(result);
+            } else if (&semantics == &llvm::APFloat::IEEEsingle()) {
+                float result;
+                if (tryFastPath<float, 24, 10>(parts, result)) return llvm::APFloat(result);
+            }
+
+            llvm::APFloat value(semantics);
+            llvm::cantFail(value.convertFromString(string, llvm::APFloat::rmNearestTiesToEven));
+
+            return value;
+        }
+    }
+}
@@ -11,12 +11,13 @@
 
 #include "juice/Parser/Parser.h"
 
-#include <string>
 #include <utility>
 
 #include "juice/Diagnostics/DiagnosticError.h"
 #include "juice/Basic/Error.h"
 #include "juice/Basic/SourceLocation.h"
+#include "juice/Parser/LiteralDecoder.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace juice {
     namespace parser {
@@ -24,43 +25,31 @@ namespace juice {
 
         template <typename... Args>
         llvm::Error Parser::createError(diag::DiagnosticID diagnosticID, Args &&... args) {
-            basic::SourceLocation location(_currentToken->string.begin());
+            basic::SourceLocation location(_tokens.getStart(_currentToken));
             return basic::createError<diag::DiagnosticError>(location, diagnosticID, std::forward<Args>(args)...);
         }
 
         bool Parser::isAtEnd() {
-            return _currentToken == nullptr || _currentToken->type == LexerToken::Type::eof;
+            return _tokens.getType(_currentToken) == LexerToken::Type::eof;
         }
 
-        const std::unique_ptr<LexerToken> & Parser::getPreviousToken() {
-            if (_previousToken) return _previousToken;
-            return _matchedToken;
+        size_t Parser::getPreviousToken() {
+            assert(_currentToken > 0 && "There should be a previous token.");
+            return _currentToken - 1;
         }
 
-        const std::unique_ptr<LexerToken> & Parser::getPreviousLookaheadToken() {
-            switch (_lookaheadTokens.size()) {
-                case 0: return getPreviousToken();
-                case 1: return _currentToken;
-                default: return *(_lookaheadTokens.end() - 1);
-            }
-        }
-
-        const std::unique_ptr<LexerToken> & Parser::getCurrentLookaheadToken() {
-            return _lookaheadTokens.empty() ? _currentToken : _lookaheadTokens.back();
+        size_t Parser::getPreviousLookaheadToken() {
+            if (_lookaheadToken == _currentToken) return getPreviousToken();
+            return _lookaheadToken - 1;
         }
 
-        std::unique_ptr<LexerToken> Parser::moveFirstLookaheadToken() {
-            assert(!_lookaheadTokens.empty() && "There should be at least one lookahead token.");
-
-            auto first = std::move(_lookaheadTokens.front());
-            _lookaheadTokens.pop_front();
-
-            return first;
+        size_t Parser::getCurrentLookaheadToken() {
+            return _lookaheadToken;
         }
 
         bool Parser::check(LexerToken::Type type) {
             if (isAtEnd()) return false;
-            return _currentToken->type == type;
+            return _tokens.getType(_currentToken) == type;
         }
 
         template<typename... T, std::enable_if_t<basic::all_same_v<LexerToken::Type, T...>> *>
@@ -80,14 +69,18 @@ namespace juice {
         }
 
         bool Parser::checkPrevious(LexerToken::Type type) {
-            return getPreviousToken()->type == type;
+            return _tokens.getType(getPreviousToken()) == type;
         }
 
         llvm::Error Parser::advanceOne() {
             if (isAtEnd()) return createError(diag::DiagnosticID::unexpected_parser_error);
-            _previousToken = std::move(_currentToken);
-            if (_previousToken) _wasNewline = (_previousToken->type == LexerToken::Type::delimiterNewline);
-            _currentToken = _lookaheadTokens.empty() ? _lexer->nextToken() : moveFirstLookaheadToken();
+            if (_hasPendingLexerError) {
+                _tokens.diagnoseInto(_currentToken, *_diagnostics);
+                _hasPendingLexerError = false;
+            }
+            _wasNewline = (_tokens.getType(_currentToken) == LexerToken::Type::delimiterNewline);
+            _currentToken++;
+            if (_lookaheadToken < _currentToken) _lookaheadToken = _currentToken;
             if (check(LexerToken::Type::error)) return llvm::make_error<LexerError>();
 
             return llvm::Error::success();
@@ -95,15 +88,23 @@ namespace juice {
 
         llvm::Error Parser::skipNewlines() {
             while (check(LexerToken::Type::delimiterNewline)) {
-                if (auto error = advanceOne()) return error;
+                // A token that the lexer couldn't scan after the newlines belongs to the next statement, so it mustn't
+                // make the statement that ends here fail. It stays pending until the next statement fails on it (see
+                // diagnoseError) or it is advanced past.
+                if (auto error = advanceOne()) {
+                    if (auto otherError = llvm::handleErrors(std::move(error), [this](const LexerError &) {
+                        _hasPendingLexerError = true;
+                    }))
+                        return otherError;
+                }
             }
 
             return llvm::Error::success();
         }
 
-        llvm::Expected<std::unique_ptr<LexerToken>> Parser::advance() {
+        llvm::Expected<size_t> Parser::advance() {
             if (auto error = advanceOne()) return error;
-            auto token = std::move(_previousToken);
+            size_t token = getPreviousToken();
 
             if (auto error = skipNewlines()) return error;
 
@@ -115,7 +116,7 @@ namespace juice {
                 auto matchedToken = advance();
                 if (auto error = matchedToken.takeError()) return error;
 
-                _matchedToken = std::move(*matchedToken);
+                _matchedToken = *matchedToken;
                 return true;
             }
             return false;
@@ -149,7 +150,7 @@ namespace juice {
                 auto matchedToken = advance();
                 if (auto error = matchedToken.takeError()) return error;
 
-                _matchedToken = std::move(*matchedToken);
+                _matchedToken = *matchedToken;
 
                 return llvm::Error::success();
             }
@@ -158,13 +159,12 @@ namespace juice {
         }
 
         bool Parser::lookaheadIsAtEnd() {
-            return getCurrentLookaheadToken() == nullptr || getCurrentLookaheadToken()->type == LexerToken::Type::eof;
+            return _tokens.getType(getCurrentLookaheadToken()) == LexerToken::Type::eof;
         }
 
         bool Parser::checkLookahead(LexerToken::Type type) {
             if (lookaheadIsAtEnd()) return false;
-            if (_lookaheadTokens.empty()) return check(type);
-            return getCurrentLookaheadToken()->type == type;
+            return _tokens.getType(getCurrentLookaheadToken()) == type;
         }
 
         template<typename... T, std::enable_if_t<basic::all_same_v<LexerToken::Type, T...>> *>
@@ -184,12 +184,12 @@ namespace juice {
         }
 
         bool Parser::checkPreviousLookahead(LexerToken::Type type) {
-            return getPreviousLookaheadToken()->type == type;
+            return _tokens.getType(getPreviousLookaheadToken()) == type;
         }
 
         llvm::Error Parser::advanceLookaheadOne() {
             if (lookaheadIsAtEnd()) return createError(diag::DiagnosticID::unexpected_parser_error);
-            _lookaheadTokens.push_back(_lexer->nextToken());
+            _lookaheadToken++;
             if (checkLookahead(LexerToken::Type::error)) return llvm::make_error<LexerError>();
 
             return llvm::Error::success();
@@ -203,9 +203,9 @@ namespace juice {
             return llvm::Error::success();
         }
 
-        llvm::Expected<const std::unique_ptr<LexerToken> &> Parser::advanceLookahead() {
+        llvm::Expected<size_t> Parser::advanceLookahead() {
             if (auto error = advanceLookaheadOne()) return error;
-            const auto & token = getPreviousLookaheadToken();
+            size_t token = getPreviousLookaheadToken();
 
             if (auto error = lookaheadSkipNewlines()) return error;
 
@@ -245,72 +245,72 @@ namespace juice {
         }
 
 
-        llvm::Expected<std::unique_ptr<ast::BlockAST>> Parser::parseBlock(llvm::StringRef name) {
+        llvm::Expected<ast::BlockAST *> Parser::parseBlock(llvm::StringRef name) {
             if (auto error = consume(LexerToken::Type::delimiterLeftBrace,
                                      diag::DiagnosticID::expected_left_brace, name))
                 return error;
 
-            auto block = std::make_unique<ast::BlockAST>(std::move(_matchedToken));
+            auto block = new (_context) ast::BlockAST(_matchedToken);
 
             bool wasInBlock = _inBlock;
             _inBlock = true;
 
-            if (auto error = parseContainer(*block, [](Parser * parser) {
+            parseContainer(*block, [](Parser * parser) {
                 return parser->isAtEnd() || parser->check(LexerToken::Type::delimiterRightBrace);
-            })) return error;
+            });
+
+            _inBlock = wasInBlock;
 
             if (auto error = consume(LexerToken::Type::delimiterRightBrace,
                                      diag::DiagnosticID::expected_right_brace, name))
                 return error;
 
-            _inBlock = wasInBlock;
-
             return block;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ControlFlowBodyAST>>
-        Parser::parseControlFlowBody(std::unique_ptr<LexerToken> keyword) {
+        llvm::Expected<ast::ControlFlowBodyAST *>
+        Parser::parseControlFlowBody(size_t keyword) {
             if (check(LexerToken::Type::delimiterLeftBrace)) {
-                auto block = parseBlock(keyword->string);
+                auto block = parseBlock(_tokens.getString(keyword));
                 if (auto error = block.takeError()) return error;
 
-                return std::make_unique<ast::ControlFlowBodyAST>(std::move(keyword), std::move(*block));
+                return new (_context) ast::ControlFlowBodyAST(keyword, *block);
             }
 
             if (auto error = consume(LexerToken::Type::delimiterColon,
-                                     diag::DiagnosticID::expected_left_brace_or_colon, keyword->string))
+                                     diag::DiagnosticID::expected_left_brace_or_colon, _tokens.getString(keyword)))
                 return error;
 
             auto expression = parseExpression();
             if (auto error = expression.takeError()) return error;
 
-            return std::make_unique<ast::ControlFlowBodyAST>(std::move(keyword), std::move(*expression));
+            return new (_context) ast::ControlFlowBodyAST(keyword, *expression);
         }
 
-        llvm::Expected<std::unique_ptr<ast::IfExpressionAST>> Parser::parseIfExpression(bool isStatement) {
-            auto ifKeyword = std::move(_matchedToken);
+        llvm::Expected<ast::IfExpressionAST *> Parser::parseIfExpression(bool isStatement) {
+            size_t ifKeyword = _matchedToken;
 
             auto ifCondition = parseExpression();
             if (auto error = ifCondition.takeError()) return error;
 
-            auto ifBody = parseControlFlowBody(std::move(ifKeyword));
+            auto ifBody = parseControlFlowBody(ifKeyword);
             if (auto error = ifBody.takeError()) return error;
 
-            ast::IfExpressionAST::ElifVector elifConditionsAndBodies;
+            llvm::SmallVector<ast::IfExpressionAST::ElifConditionAndBody, 4> elifConditionsAndBodies;
 
             auto matchedElif = match(LexerToken::Type::keywordElif);
             if (auto error = matchedElif.takeError()) return error;
 
             while (*matchedElif) {
-                auto elifKeyword = std::move(_matchedToken);
+                size_t elifKeyword = _matchedToken;
 
                 auto elifCondition = parseExpression();
                 if (auto error = elifCondition.takeError()) return error;
 
-                auto elifBody = parseControlFlowBody(std::move(elifKeyword));
+                auto elifBody = parseControlFlowBody(elifKeyword);
                 if (auto error = elifBody.takeError()) return error;
 
-                elifConditionsAndBodies.emplace_back(std::move(*elifCondition), std::move(*elifBody));
+                elifConditionsAndBodies.emplace_back(*elifCondition, *elifBody);
 
                 matchedElif = match(LexerToken::Type::keywordElif);
                 if (auto error = matchedElif.takeError()) return error;
@@ -321,42 +321,40 @@ namespace juice {
                 auto matchedElse = match(LexerToken::Type::keywordElse);
                 if (auto error = matchedElse.takeError()) return error;
 
-                std::unique_ptr<ast::ControlFlowBodyAST> elseBody = nullptr;
+                ast::ControlFlowBodyAST * elseBody = nullptr;
 
                 if (*matchedElse) {
-                    auto elseKeyword = std::move(_matchedToken);
+                    size_t elseKeyword = _matchedToken;
 
-                    auto expectedElseBody = parseControlFlowBody(std::move(elseKeyword));
+                    auto expectedElseBody = parseControlFlowBody(elseKeyword);
                     if (auto error = expectedElseBody.takeError()) return error;
 
-                    elseBody = std::move(*expectedElseBody);
+                    elseBody = *expectedElseBody;
                 }
 
-                return std::make_unique<ast::IfExpressionAST>(std::move(*ifCondition), std::move(*ifBody),
-                                                              std::move(elifConditionsAndBodies), std::move(elseBody),
-                                                              true);
+                return new (_context) ast::IfExpressionAST(*ifCondition, *ifBody,
+                                                           _context.copy(elifConditionsAndBodies), elseBody, true);
             }
 
 
             if (auto error = consume(LexerToken::Type::keywordElse, diag::DiagnosticID::expected_else))
                 return error;
 
-            auto elseKeyword = std::move(_matchedToken);
+            size_t elseKeyword = _matchedToken;
 
-            auto elseBody = parseControlFlowBody(std::move(elseKeyword));
+            auto elseBody = parseControlFlowBody(elseKeyword);
             if (auto error = elseBody.takeError()) return error;
 
-            return std::make_unique<ast::IfExpressionAST>(std::move(*ifCondition), std::move(*ifBody),
-                                                          std::move(elifConditionsAndBodies), std::move(*elseBody),
-                                                          false);
+            return new (_context) ast::IfExpressionAST(*ifCondition, *ifBody, _context.copy(elifConditionsAndBodies),
+                                                       *elseBody, false);
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseGroupedExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseGroupedExpression() {
             auto matched = match(LexerToken::Type::delimiterLeftParen);
             if (auto error = matched.takeError()) return error;
 
             if (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto expression = parseExpression();
                 if (auto error = expression.takeError()) return error;
@@ -365,46 +363,51 @@ namespace juice {
                                          diag::DiagnosticID::expected_right_paren))
                     return error;
 
-                return std::make_unique<ast::GroupingExpressionAST>(std::move(token), std::move(*expression));
+                return new (_context) ast::GroupingExpressionAST(token, *expression);
             }
 
             return createError(diag::DiagnosticID::expected_expression);
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parsePrimaryExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parsePrimaryExpression() {
             auto matchedInteger = match(LexerToken::Type::integerLiteral);
             if (auto error = matchedInteger.takeError()) return error;
 
             if (*matchedInteger) {
-                auto token = std::move(_matchedToken);
-                int64_t value = std::stoll(token->string.str());
-                return std::make_unique<ast::IntegerLiteralExpressionAST>(std::move(token), value);
+                size_t token = _matchedToken;
+                llvm::APInt value = decodeIntegerLiteral(_tokens.getString(token));
+                bool needsCleanup = value.needsCleanup();
+
+                auto literal = new (_context) ast::IntegerLiteralExpressionAST(token, std::move(value));
+                if (needsCleanup) _context.addDestruction(literal);
+
+                return literal;
             }
 
             auto matchedFloatingPoint = match(LexerToken::Type::floatingPointLiteral);
             if (auto error = matchedFloatingPoint.takeError()) return error;
 
             if (*matchedFloatingPoint) {
-                auto token = std::move(_matchedToken);
-                double value = std::stod(token->string.str());
-                return std::make_unique<ast::FloatingPointLiteralExpressionAST>(std::move(token), value);
+                size_t token = _matchedToken;
+                double value = decodeFloatingPointLiteral(_tokens.getString(token)).convertToDouble();
+                return new (_context) ast::FloatingPointLiteralExpressionAST(token, value);
             }
             
             auto matchedBooleanLiteral = match(LexerToken::Type::keywordTrue, LexerToken::Type::keywordFalse);
             if (auto error = matchedBooleanLiteral.takeError()) return error;
 
             if (*matchedBooleanLiteral) {
-                auto token = std::move(_matchedToken);
-                bool value = token->type == LexerToken::Type::keywordTrue;
-                return std::make_unique<ast::BooleanLiteralExpressionAST>(std::move(token), value);
+                size_t token = _matchedToken;
+                bool value = _tokens.getType(token) == LexerToken::Type::keywordTrue;
+                return new (_context) ast::BooleanLiteralExpressionAST(token, value);
             }
 
             auto matchedIdentifier = match(LexerToken::Type::identifier);
             if (auto error = matchedIdentifier.takeError()) return error;
 
             if (*matchedIdentifier) {
-                auto token = std::move(_matchedToken);
-                return std::make_unique<ast::VariableExpressionAST>(std::move(token));
+                size_t token = _matchedToken;
+                return new (_context) ast::VariableExpressionAST(token);
             }
 
             auto matchedIf = match(LexerToken::Type::keywordIf);
@@ -415,7 +418,7 @@ namespace juice {
             return parseGroupedExpression();
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseMultiplicationPrecedenceExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseMultiplicationPrecedenceExpression() {
             auto node = parsePrimaryExpression();
             if (auto error = node.takeError()) return error;
 
@@ -423,13 +426,12 @@ namespace juice {
             if (auto error = matched.takeError()) return error;
 
             while (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto right = parsePrimaryExpression();
                 if (auto error = right.takeError()) return error;
 
-                node = std::make_unique<ast::BinaryOperatorExpressionAST>(std::move(token), std::move(*node),
-                                                                          std::move(*right));
+                node = new (_context) ast::BinaryOperatorExpressionAST(token, *node, *right);
                 if (auto error = node.takeError()) return error;
 
                 matched = match(LexerToken::Type::operatorAsterisk, LexerToken::Type::operatorSlash);
@@ -439,7 +441,7 @@ namespace juice {
             return node;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseAdditionPrecedenceExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseAdditionPrecedenceExpression() {
             auto node = parseMultiplicationPrecedenceExpression();
             if (auto error = node.takeError()) return error;
 
@@ -447,13 +449,12 @@ namespace juice {
             if (auto error = matched.takeError()) return error;
 
             while (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto right = parseMultiplicationPrecedenceExpression();
                 if (auto error = right.takeError()) return error;
 
-                node = std::make_unique<ast::BinaryOperatorExpressionAST>(std::move(token), std::move(*node),
-                                                                          std::move(*right));
+                node = new (_context) ast::BinaryOperatorExpressionAST(token, *node, *right);
                 if (auto error = node.takeError()) return error;
 
                 matched = match(LexerToken::Type::operatorPlus, LexerToken::Type::operatorMinus);
@@ -463,7 +464,7 @@ namespace juice {
             return node;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseComparisonPrecedenceExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseComparisonPrecedenceExpression() {
             auto node = parseAdditionPrecedenceExpression();
             if (auto error = node.takeError()) return error;
 
@@ -472,13 +473,12 @@ namespace juice {
             if (auto error = matched.takeError()) return error;
 
             if (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto right = parseAdditionPrecedenceExpression();
                 if (auto error = right.takeError()) return error;
 
-                node = std::make_unique<ast::BinaryOperatorExpressionAST>(std::move(token), std::move(*node),
-                                                                          std::move(*right));
+                node = new (_context) ast::BinaryOperatorExpressionAST(token, *node, *right);
                 if (auto error = node.takeError()) return error;
 
                 if (check(LexerToken::Type::operatorLower, LexerToken::Type::operatorLowerEqual,
@@ -489,7 +489,7 @@ namespace juice {
             return node;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseEqualityPrecedenceExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseEqualityPrecedenceExpression() {
             auto node = parseComparisonPrecedenceExpression();
             if (auto error = node.takeError()) return error;
 
@@ -497,13 +497,12 @@ namespace juice {
             if (auto error = matched.takeError()) return error;
 
             if (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto right = parseComparisonPrecedenceExpression();
                 if (auto error = right.takeError()) return error;
 
-                node = std::make_unique<ast::BinaryOperatorExpressionAST>(std::move(token), std::move(*node),
-                                                                          std::move(*right));
+                node = new (_context) ast::BinaryOperatorExpressionAST(token, *node, *right);
                 if (auto error = node.takeError()) return error;
 
                 if (check(LexerToken::Type::operatorEqualEqual, LexerToken::Type::operatorBangEqual))
@@ -513,7 +512,7 @@ namespace juice {
             return node;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseLogicalAndPrecedenceExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseLogicalAndPrecedenceExpression() {
             auto node = parseEqualityPrecedenceExpression();
             if (auto error = node.takeError()) return error;
 
@@ -521,13 +520,12 @@ namespace juice {
             if (auto error = matched.takeError()) return error;
 
             while (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto right = parseEqualityPrecedenceExpression();
                 if (auto error = right.takeError()) return error;
 
-                node = std::make_unique<ast::BinaryOperatorExpressionAST>(std::move(token), std::move(*node),
-                                                                          std::move(*right));
+                node = new (_context) ast::BinaryOperatorExpressionAST(token, *node, *right);
                 if (auto error = node.takeError()) return error;
 
                 matched = match(LexerToken::Type::operatorAndAnd);
@@ -537,7 +535,7 @@ namespace juice {
             return node;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseLogicalOrPrecedenceExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseLogicalOrPrecedenceExpression() {
             auto node = parseLogicalAndPrecedenceExpression();
             if (auto error = node.takeError()) return error;
 
@@ -545,13 +543,12 @@ namespace juice {
             if (auto error = matched.takeError()) return error;
 
             while (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto right = parseLogicalAndPrecedenceExpression();
                 if (auto error = right.takeError()) return error;
 
-                node = std::make_unique<ast::BinaryOperatorExpressionAST>(std::move(token), std::move(*node),
-                                                                          std::move(*right));
+                node = new (_context) ast::BinaryOperatorExpressionAST(token, *node, *right);
                 if (auto error = node.takeError()) return error;
 
                 matched = match(LexerToken::Type::operatorPipePipe);
@@ -561,7 +558,7 @@ namespace juice {
             return node;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseAssignmentPrecedenceExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseAssignmentPrecedenceExpression() {
             auto node = parseLogicalOrPrecedenceExpression();
             if (auto error = node.takeError()) return error;
 
@@ -571,13 +568,12 @@ namespace juice {
             if (auto error = matched.takeError()) return error;
 
             while (*matched) {
-                auto token = std::move(_matchedToken);
+                size_t token = _matchedToken;
 
                 auto right = parseAssignmentPrecedenceExpression();
                 if (auto error = right.takeError()) return error;
 
-                node = std::make_unique<ast::BinaryOperatorExpressionAST>(std::move(token), std::move(*node),
-                                                                          std::move(*right));
+                node = new (_context) ast::BinaryOperatorExpressionAST(token, *node, *right);
                 if (auto error = node.takeError()) return error;
 
                 matched = match(LexerToken::Type::operatorEqual, LexerToken::Type::operatorPlusEqual,
@@ -589,11 +585,11 @@ namespace juice {
             return node;
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionAST>> Parser::parseExpression() {
+        llvm::Expected<ast::ExpressionAST *> Parser::parseExpression() {
             return parseAssignmentPrecedenceExpression();
         }
 
-        llvm::Expected<std::unique_ptr<ast::ExpressionStatementAST>> Parser::parseExpressionStatement() {
+        llvm::Expected<ast::ExpressionStatementAST *> Parser::parseExpressionStatement() {
             auto expression = parseExpression();
             if (auto error = expression.takeError()) return error;
 
@@ -603,40 +599,40 @@ namespace juice {
                     return error;
             }
 
-            return std::make_unique<ast::ExpressionStatementAST>(std::move(*expression));
+            return new (_context) ast::ExpressionStatementAST(*expression);
         }
 
-        llvm::Expected<std::unique_ptr<ast::WhileStatementAST>> Parser::parseWhileStatement() {
-            auto keyword = std::move(_matchedToken);
+        llvm::Expected<ast::WhileStatementAST *> Parser::parseWhileStatement() {
+            size_t keyword = _matchedToken;
 
             auto condition = parseExpression();
             if (auto error = condition.takeError()) return error;
 
-            auto body = parseControlFlowBody(std::move(keyword));
+            auto body = parseControlFlowBody(keyword);
             if (auto error = body.takeError()) return error;
 
-            return std::make_unique<ast::WhileStatementAST>(std::move(*condition), std::move(*body));
+            return new (_context) ast::WhileStatementAST(*condition, *body);
         }
 
-        llvm::Expected<std::unique_ptr<ast::IfStatementAST>> Parser::parseIfStatement() {
+        llvm::Expected<ast::IfStatementAST *> Parser::parseIfStatement() {
             auto ifExpression = parseIfExpression(true);
             if (auto error = ifExpression.takeError()) return error;
 
-            return std::make_unique<ast::IfStatementAST>(std::move(*ifExpression));
+            return new (_context) ast::IfStatementAST(*ifExpression);
         }
 
-        llvm::Expected<std::unique_ptr<ast::BlockStatementAST>> Parser::parseBlockStatement() {
+        llvm::Expected<ast::BlockStatementAST *> Parser::parseBlockStatement() {
             auto block = parseBlock("do");
             if (auto error = block.takeError()) return error;
 
-            return std::make_unique<ast::BlockStatementAST>(std::move(*block));
+            return new (_context) ast::BlockStatementAST(*block);
         }
 
-        llvm::Expected<std::unique_ptr<ast::TypeRepr>> Parser::parseIdentifierType() {
-            return std::make_unique<ast::IdentifierTypeRepr>(std::move(_matchedToken));
+        llvm::Expected<ast::TypeRepr *> Parser::parseIdentifierType() {
+            return new (_context) ast::IdentifierTypeRepr(_matchedToken);
         }
 
-        llvm::Expected<std::unique_ptr<ast::TypeRepr>> Parser::parseType() {
+        llvm::Expected<ast::TypeRepr *> Parser::parseType() {
             auto matchedIdentifier = match(LexerToken::Type::identifier);
             if (auto error = matchedIdentifier.takeError()) return error;
 
@@ -647,29 +643,29 @@ namespace juice {
             return createError(diag::DiagnosticID::expected_type);
         }
 
-        llvm::Expected<std::unique_ptr<ast::TypeRepr>> Parser::parseTypeAnnotation() {
+        llvm::Expected<ast::TypeRepr *> Parser::parseTypeAnnotation() {
             return parseType();
         }
 
-        llvm::Expected<std::unique_ptr<ast::VariableDeclarationAST>> Parser::parseVariableDeclaration() {
-            auto keyword = std::move(_matchedToken);
+        llvm::Expected<ast::VariableDeclarationAST *> Parser::parseVariableDeclaration() {
+            size_t keyword = _matchedToken;
 
-            bool isMutable = keyword->type == LexerToken::Type::keywordVar;
+            bool isMutable = _tokens.getType(keyword) == LexerToken::Type::keywordVar;
 
             if (auto error = consume(LexerToken::Type::identifier, diag::DiagnosticID::expected_variable_name))
                 return error;
 
-            auto name = std::move(_matchedToken);
+            size_t name = _matchedToken;
 
             auto matchedColon = match(LexerToken::Type::delimiterColon);
             if (auto error = matchedColon.takeError()) return error;
 
-            std::unique_ptr<ast::TypeRepr> typeAnnotation;
+            ast::TypeRepr * typeAnnotation = nullptr;
             if (*matchedColon) {
                 auto type = parseTypeAnnotation();
                 if (auto error = type.takeError()) return error;
 
-                typeAnnotation = std::move(*type);
+                typeAnnotation = *type;
             }
 
             if (auto error = consume(LexerToken::Type::operatorEqual,
@@ -685,12 +681,11 @@ namespace juice {
                     return error;
             }
 
-            return std::make_unique<ast::VariableDeclarationAST>(std::move(keyword), std::move(name),
-                                                                 std::move(typeAnnotation), isMutable,
-                                                                 std::move(*initialization));
+            return new (_context) ast::VariableDeclarationAST(keyword, name, typeAnnotation, isMutable,
+                                                              *initialization);
         }
 
-        llvm::Expected<std::unique_ptr<ast::StatementAST>> Parser::parseStatement() {
+        llvm::Expected<ast::StatementAST *> Parser::parseStatement() {
             auto matchedVar = match(LexerToken::Type::keywordLet, LexerToken::Type::keywordVar);
             if (auto error = matchedVar.takeError()) return error;
 
@@ -718,37 +713,100 @@ namespace juice {
             return parseExpressionStatement();
         }
 
-        llvm::Error Parser::parseContainer(ast::ContainerAST & container,
-                                           const std::function<bool(Parser *)> & endCondition) {
-            if (auto error = skipNewlines()) return error;
+        void Parser::diagnoseError(llvm::Error error) {
+            basic::handleAllErrors(std::move(error), [this](const diag::DiagnosticError & error) {
+                // The statement failed on a token that skipNewlines stopped at, which hasn't been diagnosed yet and is
+                // the actual cause of the error.
+                if (_hasPendingLexerError) {
+                    _tokens.diagnoseInto(_currentToken, *_diagnostics);
+                    _hasPendingLexerError = false;
+                } else {
+                    error.diagnoseInto(*_diagnostics);
+                }
+            }, [this](const LexerError &) {
+                _tokens.diagnoseInto(_currentToken, *_diagnostics);
+            });
+        }
+
+        void Parser::skipNewlinesAndErrors() {
+            // advanceOne returns an error for every token that the lexer couldn't scan when it reaches it, and
+            // diagnoses a pending one before it advances past it.
+            while (check(LexerToken::Type::delimiterNewline, LexerToken::Type::error)) {
+                if (auto error = advanceOne()) diagnoseError(std::move(error));
+            }
+        }
+
+        void Parser::synchronize(const std::function<bool(Parser *)> & endCondition, size_t statementStart) {
+            // Blocks that start in the skipped tokens are skipped as a whole, so that their statements aren't parsed
+            // (and diagnosed) as part of the container.
+            unsigned int braceDepth = 0;
+
+            while (!isAtEnd()) {
+                if (braceDepth == 0) {
+                    if (endCondition(this)) return;
+
+                    // If the statement failed on its first token, that token has to be skipped, because it would
+                    // fail again otherwise.
+                    if (_currentToken != statementStart
+                        && check(LexerToken::Type::keywordLet, LexerToken::Type::keywordVar,
+                                 LexerToken::Type::keywordDo, LexerToken::Type::keywordIf,
+                                 LexerToken::Type::keywordWhile))
+                        return;
+                }
+
+                LexerToken::Type type = _tokens.getType(_currentToken);
+
+                if (type == LexerToken::Type::delimiterLeftBrace) {
+                    ++braceDepth;
+                } else if (type == LexerToken::Type::delimiterRightBrace && braceDepth > 0) {
+                    --braceDepth;
+                }
+
+                if (auto error = advanceOne()) diagnoseError(std::move(error));
+
+                if (braceDepth == 0
+                    && (type == LexerToken::Type::delimiterNewline || type == LexerToken::Type::delimiterSemicolon))
+                    break;
+            }
+
+            skipNewlinesAndErrors();
+        }
+
+        void Parser::parseContainer(ast::ContainerAST & container,
+                                    const std::function<bool(Parser *)> & endCondition) {
+            skipNewlinesAndErrors();
+
+            llvm::SmallVector<ast::StatementAST *, 16> statements;
 
             while (!endCondition(this)) {
+                size_t statementStart = _currentToken;
+
                 auto statement = parseStatement();
-                if (auto error = statement.takeError()) return error;
+                if (auto error = statement.takeError()) {
+                    diagnoseError(std::move(error));
+                    synchronize(endCondition, statementStart);
+
+                    continue;
+                }
 
-                container.appendStatement(std::move(*statement));
+                statements.push_back(*statement);
             }
 
-            return llvm::Error::success();
+            container.setStatements(_context.copy(statements));
         }
 
-        Parser::Parser(std::shared_ptr<diag::DiagnosticEngine> diagnostics):
-            _diagnostics(std::move(diagnostics)), _previousToken(nullptr), _matchedToken(nullptr), _inBlock(false),
-            _wasNewline(false) {
-            _lexer = std::make_unique<Lexer>(_diagnostics->getBuffer());
-            _currentToken = _lexer->nextToken();
-        }
+        Parser::Parser(ast::ASTContext & context, std::shared_ptr<diag::DiagnosticEngine> diagnostics):
+            _context(context), _diagnostics(std::move(diagnostics)), _tokens(context.getTokens()),
+            _currentToken(0), _matchedToken(0), _lookaheadToken(0), _inBlock(false), _wasNewline(false),
+            _hasPendingLexerError(false) {}
 
-        std::unique_ptr<ast::ModuleAST> Parser::parseModule() {
-            auto module = std::make_unique<ast::ModuleAST>();
+        ast::ModuleAST * Parser::parseModule() {
+            auto module = new (_context) ast::ModuleAST();
 
-            if (basic::handleAllErrors(parseContainer(*module), [this](const diag::DiagnosticError & error) {
-                error.diagnoseInto(*_diagnostics);
-            }, [this](const LexerError &) {
-                _currentToken->diagnoseInto(*_diagnostics);
-            })) {
-                return nullptr;
-            }
+            // advanceOne only checks the tokens it advances to, not the first one.
+            _hasPendingLexerError = check(LexerToken::Type::error);
+
+            parseContainer(*module);
 
             return module;
         }
@@ -0,0 +1,64 @@
+// src/juice/Parser/TokenBuffer.cpp - TokenBuffer class, contiguous storage for lexed tokens
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "juice/Parser/TokenBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+#include "juice/Basic/SourceLocation.h"
+
+namespace juice {
+    namespace parser {
+        uint32_t TokenBuffer::getOffset(const char * position) const {
+            auto offset = position - _sourceBuffer->getStart();
+            assert(offset >= 0 && (size_t)offset <= std::numeric_limits<uint32_t>::max()
+                   && "Source buffers larger than 4 GiB are not supported");
+
+            return (uint32_t)offset;
+        }
+
+        TokenBuffer::TokenBuffer(std::shared_ptr<basic::SourceBuffer> sourceBuffer):
+            _sourceBuffer(std::move(sourceBuffer)) {}
+
+        void TokenBuffer::append(LexerToken::Type type, const char * start, const char * end) {
+            _tokens.push_back({type, getOffset(start), (uint32_t)(end - start)});
+        }
+
+        void TokenBuffer::appendError(const char * start, const char * end, diag::DiagnosticID id,
+                                      const char * errorPosition) {
+            _errors.push_back({_tokens.size(), id, getOffset(errorPosition)});
+            append(LexerToken::Type::error, start, end);
+        }
+
+        const TokenBuffer::Error * TokenBuffer::getError(size_t index) const {
+            auto iterator = std::lower_bound(_errors.begin(), _errors.end(), index,
+                                             [](const Error & error, size_t index) {
+                return error.tokenIndex < index;
+            });
+
+            if (iterator == _errors.end() || iterator->tokenIndex != index) return nullptr;
+            return &*iterator;
+        }
+
+        void TokenBuffer::diagnoseInto(size_t index, diag::DiagnosticEngine & diagnostics) const {
+            if (const Error * error = getError(index)) {
+                basic::SourceLocation location(_sourceBuffer->getStart() + error->errorOffset);
+                diagnostics.diagnose(location, error->id);
+                return;
+            }
+
+            getToken(index).diagnoseInto(diagnostics);
+        }
+    }
+}
@@ -27,26 +27,10 @@ namespace juice {
             }
         }
 
-        int64_t BuiltinIntegerType::getMinimumValue() const {
-            switch (_width) {
-                case Width::_1: return 0;
-                case Width::_8: return INT8_MIN;
-                case Width::_16: return INT16_MIN;
-                case Width::_32: return INT32_MIN;
-                case Width::_64: return INT64_MIN;
-                case Width::_128: return INT64_MIN; // TODO: Proper 128 bit integer support
-            }
-        }
+        bool BuiltinIntegerType::canRepresentLiteral(const llvm::APInt & value) const {
+            if (isBool()) return value.getActiveBits() <= 1;
 
-        int64_t BuiltinIntegerType::getMaximumValue() const {
-            switch (_width) {
-                case Width::_1: return 1;
-                case Width::_8: return INT8_MAX;
-                case Width::_16: return INT16_MAX;
-                case Width::_32: return INT32_MAX;
-                case Width::_64: return INT64_MAX;
-                case Width::_128: return INT64_MAX; // TODO: Proper 128 bit integer support
-            }
+            return value.getActiveBits() < getBitWidth();
         }
 
         bool BuiltinIntegerType::equals(const TypeBase * other) const {
@@ -65,6 +49,15 @@ namespace juice {
             }
         }
 
+        const llvm::fltSemantics & BuiltinFloatingPointType::getSemantics() const {
+            switch (_fpKind) {
+                case FPKind::ieee16: return llvm::APFloat::IEEEhalf();
+                case FPKind::ieee32: return llvm::APFloat::IEEEsingle();
+                case FPKind::ieee64: return llvm::APFloat::IEEEdouble();
+                case FPKind::ieee128: return llvm::APFloat::IEEEquad();
+            }
+        }
+
         bool BuiltinFloatingPointType::equals(const TypeBase * other) const {
             if (auto otherFloat = llvm::dyn_cast<BuiltinFloatingPointType>(other)) {
                 return this->_fpKind == otherFloat->_fpKind;
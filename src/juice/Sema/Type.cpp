@@ -18,7 +18,7 @@
 namespace juice {
     namespace sema {
         bool Type::isBuiltinInteger() const {
-            return llvm::isa<BuiltinIntegerType>(_pointer);
+            return llvm::isa_and_nonnull<BuiltinIntegerType>(_pointer);
         }
 
         bool Type::isBuiltinBool() const {
@@ -26,7 +26,7 @@ namespace juice {
         }
 
         bool Type::isBuiltinFloatingPoint() const {
-            return llvm::isa<BuiltinFloatingPointType>(_pointer);
+            return llvm::isa_and_nonnull<BuiltinFloatingPointType>(_pointer);
         }
 
         bool Type::isBuiltinFloat() const {
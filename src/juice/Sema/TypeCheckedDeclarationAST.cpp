@@ -18,54 +18,49 @@
 
 namespace juice {
     namespace sema {
-        std::unique_ptr<TypeCheckedDeclarationAST>
-        TypeCheckedDeclarationAST::createByTypeChecking(std::unique_ptr<ast::DeclarationAST> ast, const TypeHint & hint,
+        TypeCheckedDeclarationAST *
+        TypeCheckedDeclarationAST::createByTypeChecking(ast::DeclarationAST * ast, const TypeHint & hint,
                                                         TypeChecker::State & state,
                                                         diag::DiagnosticEngine & diagnostics) {
             switch (ast->getKind()) {
-                case ast::StatementAST::Kind::variableDeclaration: {
-                    auto variableDeclaration = std::unique_ptr<ast::VariableDeclarationAST>(
-                        llvm::cast<ast::VariableDeclarationAST>(ast.release()));
-                    return TypeCheckedVariableDeclarationAST::createByTypeChecking(std::move(variableDeclaration), hint,
-                                                                                   state, diagnostics);
-                }
+                case ast::StatementAST::Kind::variableDeclaration:
+                    return TypeCheckedVariableDeclarationAST
+                        ::createByTypeChecking(llvm::cast<ast::VariableDeclarationAST>(ast), hint, state, diagnostics);
                 default:
                     llvm_unreachable("All possible DeclarationStatement kinds should be handled here");
             }
         }
 
         TypeCheckedVariableDeclarationAST
-            ::TypeCheckedVariableDeclarationAST(std::unique_ptr<parser::LexerToken> keyword,
-                                                std::unique_ptr<parser::LexerToken> name,
-                                                std::unique_ptr<TypeCheckedExpressionAST> initialization,
+            ::TypeCheckedVariableDeclarationAST(size_t keyword, size_t name, TypeCheckedExpressionAST * initialization,
                                                 Type variableType, size_t index, bool isMutable):
-            TypeCheckedDeclarationAST(Kind::variableDeclaration, NothingType::get()), _keyword(std::move(keyword)),
-            _name(std::move(name)), _initialization(std::move(initialization)), _variableType(variableType),
-            _index(index), _isMutable(isMutable) {}
+            TypeCheckedDeclarationAST(Kind::variableDeclaration, NothingType::get()), _keyword(keyword), _name(name),
+            _initialization(initialization), _variableType(variableType), _index(index), _isMutable(isMutable) {}
 
-        void TypeCheckedVariableDeclarationAST::diagnoseInto(diag::DiagnosticEngine & diagnostics,
+        void TypeCheckedVariableDeclarationAST::diagnoseInto(const ast::ASTContext & context,
+                                                             diag::DiagnosticEngine & diagnostics,
                                                              unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken name = context.getToken(_name);
 
             diagnostics.diagnose(location, diag::DiagnosticID::type_checked_variable_declaration_ast, getColor(level),
-                                 (unsigned int)_index, level, _name.get(), _variableType, _isMutable);
-            _initialization->diagnoseInto(diagnostics, level + 1);
+                                 (unsigned int)_index, level, &name, _variableType, _isMutable);
+            _initialization->diagnoseInto(context, diagnostics, level + 1);
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
         }
 
-        std::unique_ptr<TypeCheckedVariableDeclarationAST>
-        TypeCheckedVariableDeclarationAST::createByTypeChecking(std::unique_ptr<ast::VariableDeclarationAST> ast,
+        TypeCheckedVariableDeclarationAST *
+        TypeCheckedVariableDeclarationAST::createByTypeChecking(ast::VariableDeclarationAST * ast,
                                                                 const TypeHint & hint, TypeChecker::State & state,
                                                                 diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
-            auto name = std::move(ast->_name);
+            ast::ASTContext & context = state.getContext();
+            basic::SourceLocation location(ast->getLocation(context));
+            llvm::StringRef name = context.getString(ast->_name);
             bool isMutable = ast->_isMutable;
 
             Type annotatedType;
             if (ast->_typeAnnotation) {
-                auto annotation = std::move(ast->_typeAnnotation);
-
-                auto type = annotation->resolve(state);
+                auto type = ast->_typeAnnotation->resolve(state);
                 if (!basic::handleAllErrors(type.takeError(), [&](const diag::DiagnosticError & error) {
                     error.diagnoseInto(diagnostics);
                 })) {
@@ -78,15 +73,14 @@ namespace juice {
             const TypeHint & initializationHint = annotatedType ? expectedHint : unknownHint;
 
             auto initialization = TypeCheckedExpressionAST
-                ::createByTypeChecking(std::move(ast->_initialization), initializationHint, state, diagnostics);
+                ::createByTypeChecking(ast->_initialization, initializationHint, state, diagnostics);
 
             Type variableType = annotatedType ? annotatedType : initialization->getType();
 
-            auto index = state.addVariableDeclaration(name->string, variableType, isMutable);
+            auto index = state.addVariableDeclaration(name, variableType, isMutable);
 
             if (!index) {
-                diagnostics.diagnose(location, diag::DiagnosticID::variable_declaration_ast_redeclaration,
-                                     name->string);
+                diagnostics.diagnose(location, diag::DiagnosticID::variable_declaration_ast_redeclaration, name);
             }
 
             switch (hint.getKind()) {
@@ -107,10 +101,8 @@ namespace juice {
                 }
             }
 
-            return std::unique_ptr<TypeCheckedVariableDeclarationAST>(
-                new TypeCheckedVariableDeclarationAST(std::move(ast->_keyword), std::move(name),
-                                                      std::move(initialization), variableType, index.getValueOr(0),
-                                                      isMutable));
+            return new (context) TypeCheckedVariableDeclarationAST(ast->_keyword, ast->_name, initialization,
+                                                                   variableType, index.getValueOr(0), isMutable);
         }
     }
 }
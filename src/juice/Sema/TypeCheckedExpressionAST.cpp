@@ -11,21 +11,23 @@
 
 #include "juice/Sema/TypeCheckedExpressionAST.h"
 
-#include <algorithm>
-#include <iterator>
+#include <cmath>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "juice/Parser/LiteralDecoder.h"
 #include "juice/Sema/BuiltinType.h"
+#include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
 
 namespace juice {
     namespace sema {
-        TypeCheckedExpressionAST::TypeCheckedExpressionAST(Kind kind, Type type,
-                                                           std::unique_ptr<parser::LexerToken> token):
-            TypeCheckedAST(kind, type), _token(std::move(token)) {}
+        TypeCheckedExpressionAST::TypeCheckedExpressionAST(Kind kind, Type type, size_t token):
+            TypeCheckedAST(kind, type), _token(token) {}
 
         void TypeCheckedExpressionAST::checkLValue(const TypeHint & hint, basic::SourceLocation location,
                                                    diag::DiagnosticEngine & diagnostics, llvm::StringRef name) {
@@ -55,10 +57,13 @@ namespace juice {
 
         void TypeCheckedExpressionAST::checkType(Type type, const TypeHint & hint, basic::SourceLocation location,
                                                  diag::DiagnosticEngine & diagnostics) {
+            // A missing type stems from an error that has already been diagnosed.
+            if (!type) return;
+
             if (llvm::isa<ExpectedTypeHint>(hint)) {
                 Type expectedType = llvm::cast<ExpectedTypeHint>(hint).getType();
 
-                if (expectedType != type) diagnostics.diagnose(location,
+                if (expectedType && expectedType != type) diagnostics.diagnose(location,
                                                                diag::DiagnosticID::expression_ast_expected_type,
                                                                expectedType, type);
             } else if (llvm::isa<ExpectedEitherTypeHint>(hint)) {
@@ -70,83 +75,70 @@ namespace juice {
             }
         }
 
-        std::unique_ptr<TypeCheckedExpressionAST>
-        TypeCheckedExpressionAST::createByTypeChecking(std::unique_ptr<ast::ExpressionAST> ast, const TypeHint & hint,
+        TypeCheckedExpressionAST *
+        TypeCheckedExpressionAST::createByTypeChecking(ast::ExpressionAST * ast, const TypeHint & hint,
                                                        TypeChecker::State & state,
                                                        diag::DiagnosticEngine & diagnostics) {
             switch (ast->getKind()) {
-                case ast::ExpressionAST::Kind::binaryOperator: {
-                    auto binaryOperator = std::unique_ptr<ast::BinaryOperatorExpressionAST>(
-                        llvm::cast<ast::BinaryOperatorExpressionAST>(ast.release()));
-                    return TypeCheckedBinaryOperatorExpressionAST::createByTypeChecking(std::move(binaryOperator), hint,
-                                                                                        state, diagnostics);
-                }
-                case ast::ExpressionAST::Kind::integerLiteral: {
-                    auto literal = std::unique_ptr<ast::IntegerLiteralExpressionAST>(
-                        llvm::cast<ast::IntegerLiteralExpressionAST>(ast.release()));
-                    return TypeCheckedIntegerLiteralExpressionAST::createByTypeChecking(std::move(literal), hint, state,
-                                                                                        diagnostics);
-                }
-                case ast::ExpressionAST::Kind::floatingPointLiteral: {
-                    auto literal = std::unique_ptr<ast::FloatingPointLiteralExpressionAST>(
-                        llvm::cast<ast::FloatingPointLiteralExpressionAST>(ast.release()));
-                    return TypeCheckedFloatingPointLiteralExpressionAST::createByTypeChecking(std::move(literal), hint,
-                                                                                              state, diagnostics);
-                }
-                case ast::ExpressionAST::Kind::booleanLiteral: {
-                    auto literal = std::unique_ptr<ast::BooleanLiteralExpressionAST>(
-                        llvm::cast<ast::BooleanLiteralExpressionAST>(ast.release()));
-                    return TypeCheckedBooleanLiteralExpressionAST::createByTypeChecking(std::move(literal), hint, state,
-                                                                                        diagnostics);
-                }
-                case ast::ExpressionAST::Kind::variable: {
-                    auto variable = std::unique_ptr<ast::VariableExpressionAST>(
-                        llvm::cast<ast::VariableExpressionAST>(ast.release()));
-                    return TypeCheckedVariableExpressionAST::createByTypeChecking(std::move(variable), hint, state,
-                                                                                  diagnostics);
-                }
-                case ast::ExpressionAST::Kind::grouping: {
-                    auto grouping = std::unique_ptr<ast::GroupingExpressionAST>(
-                        llvm::cast<ast::GroupingExpressionAST>(ast.release()));
-                    return TypeCheckedGroupingExpressionAST::createByTypeChecking(std::move(grouping), hint, state,
-                                                                                  diagnostics);
-                }
-                case ast::ExpressionAST::Kind::_if: {
-                    auto _if = std::unique_ptr<ast::IfExpressionAST>(llvm::cast<ast::IfExpressionAST>(ast.release()));
-                    return TypeCheckedIfExpressionAST::createByTypeChecking(std::move(_if), hint, state, diagnostics);
-                }
+                case ast::ExpressionAST::Kind::binaryOperator:
+                    return TypeCheckedBinaryOperatorExpressionAST
+                        ::createByTypeChecking(llvm::cast<ast::BinaryOperatorExpressionAST>(ast), hint, state,
+                                               diagnostics);
+                case ast::ExpressionAST::Kind::integerLiteral:
+                    return TypeCheckedIntegerLiteralExpressionAST
+                        ::createByTypeChecking(llvm::cast<ast::IntegerLiteralExpressionAST>(ast), hint, state,
+                                               diagnostics);
+                case ast::ExpressionAST::Kind::floatingPointLiteral:
+                    return TypeCheckedFloatingPointLiteralExpressionAST
+                        ::createByTypeChecking(llvm::cast<ast::FloatingPointLiteralExpressionAST>(ast), hint, state,
+                                               diagnostics);
+                case ast::ExpressionAST::Kind::booleanLiteral:
+                    return TypeCheckedBooleanLiteralExpressionAST
+                        ::createByTypeChecking(llvm::cast<ast::BooleanLiteralExpressionAST>(ast), hint, state,
+                                               diagnostics);
+                case ast::ExpressionAST::Kind::variable:
+                    return TypeCheckedVariableExpressionAST
+                        ::createByTypeChecking(llvm::cast<ast::VariableExpressionAST>(ast), hint, state, diagnostics);
+                case ast::ExpressionAST::Kind::grouping:
+                    return TypeCheckedGroupingExpressionAST
+                        ::createByTypeChecking(llvm::cast<ast::GroupingExpressionAST>(ast), hint, state, diagnostics);
+                case ast::ExpressionAST::Kind::_if:
+                    return TypeCheckedIfExpressionAST::createByTypeChecking(llvm::cast<ast::IfExpressionAST>(ast), hint,
+                                                                            state, diagnostics);
             }
         }
 
         TypeCheckedBinaryOperatorExpressionAST
-            ::TypeCheckedBinaryOperatorExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token,
-                                                     std::unique_ptr<TypeCheckedExpressionAST> left,
-                                                     std::unique_ptr<TypeCheckedExpressionAST> right):
-            TypeCheckedExpressionAST(Kind::binaryOperatorExpression, type, std::move(token)), _left(std::move(left)),
-            _right(std::move(right)) {}
+            ::TypeCheckedBinaryOperatorExpressionAST(Type type, size_t token, TypeCheckedExpressionAST * left,
+                                                     TypeCheckedExpressionAST * right):
+            TypeCheckedExpressionAST(Kind::binaryOperatorExpression, type, token), _left(left), _right(right) {}
 
-        void TypeCheckedBinaryOperatorExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics,
+        void TypeCheckedBinaryOperatorExpressionAST::diagnoseInto(const ast::ASTContext & context,
+                                                                  diag::DiagnosticEngine & diagnostics,
                                                                   unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken token = context.getToken(_token);
 
             diagnostics.diagnose(location, diag::DiagnosticID::type_checked_binary_operator_expression_ast_0,
-                                 getColor(level), getType(), level, _token.get());
-            _left->diagnoseInto(diagnostics, level + 1);
+                                 getColor(level), getType(), level, &token);
+            _left->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics
                 .diagnose(location, diag::DiagnosticID::binary_operator_expression_ast_1, getColor(level), level);
-            _right->diagnoseInto(diagnostics, level + 1);
+            _right->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
         }
 
-        std::unique_ptr<TypeCheckedBinaryOperatorExpressionAST>
+        TypeCheckedBinaryOperatorExpressionAST *
         TypeCheckedBinaryOperatorExpressionAST
-            ::createByTypeChecking(std::unique_ptr<ast::BinaryOperatorExpressionAST> ast, const TypeHint & hint,
+            ::createByTypeChecking(ast::BinaryOperatorExpressionAST * ast, const TypeHint & hint,
                                    TypeChecker::State & state, diag::DiagnosticEngine & diagnostics) {
             using TokenType = parser::LexerToken::Type;
 
-            basic::SourceLocation location(ast->getLocation());
+            ast::ASTContext & context = state.getContext();
+            basic::SourceLocation location(ast->getLocation(context));
+            TokenType operatorType = context.getTokens().getType(ast->_token);
 
             checkLValue(hint, location, diagnostics, "binary operator expression");
 
@@ -157,7 +149,7 @@ namespace juice {
                 #include "juice/Sema/BuiltinTypes.def"
             };
 
-            switch (ast->_token->type) {
+            switch (operatorType) {
                 case TokenType::operatorEqual:
                 case TokenType::operatorPlusEqual:
                 case TokenType::operatorMinusEqual:
@@ -165,69 +157,63 @@ namespace juice {
                 case TokenType::operatorSlashEqual: {
                     const TypeHint & unknownHint = UnknownTypeHint(TypeHint::Flags::lValue);
                     const TypeHint & expectedHint = ExpectedEitherTypeHint(arithmeticTypes, TypeHint::Flags::lValue);
-                    const TypeHint & leftHint = (ast->_token->type == parser::LexerToken::Type::operatorEqual)
+                    const TypeHint & leftHint = (operatorType == TokenType::operatorEqual)
                                               ? unknownHint : expectedHint;
 
-                    auto left = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_left), leftHint, state,
+                    auto left = TypeCheckedExpressionAST::createByTypeChecking(ast->_left, leftHint, state,
                                                                                diagnostics);
 
                     Type type = left->getType();
 
-                    auto right = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_right),
+                    auto right = TypeCheckedExpressionAST::createByTypeChecking(ast->_right,
                                                                                 ExpectedTypeHint(type), state,
                                                                                 diagnostics);
 
                     checkType(type, hint, location, diagnostics);
 
-                    return std::unique_ptr<TypeCheckedBinaryOperatorExpressionAST>(
-                        new TypeCheckedBinaryOperatorExpressionAST(type, std::move(ast->_token), std::move(left),
-                                                                   std::move(right)));
+                    return new (context) TypeCheckedBinaryOperatorExpressionAST(type, ast->_token, left, right);
                 }
                 case TokenType::operatorAndAnd:
                 case TokenType::operatorPipePipe: {
                     auto left = TypeCheckedExpressionAST
-                        ::createByTypeChecking(std::move(ast->_left),
+                        ::createByTypeChecking(ast->_left,
                                                ExpectedTypeHint(BuiltinIntegerType::getBool()), state, diagnostics);
 
                     auto right = TypeCheckedExpressionAST
-                        ::createByTypeChecking(std::move(ast->_right),
+                        ::createByTypeChecking(ast->_right,
                                                ExpectedTypeHint(BuiltinIntegerType::getBool()), state, diagnostics);
 
                     Type type = BuiltinIntegerType::getBool();
                     checkType(type, hint, location, diagnostics);
 
-                    return std::unique_ptr<TypeCheckedBinaryOperatorExpressionAST>(
-                        new TypeCheckedBinaryOperatorExpressionAST(type, std::move(ast->_token), std::move(left),
-                                                                   std::move(right)));
+                    return new (context) TypeCheckedBinaryOperatorExpressionAST(type, ast->_token, left, right);
                 }
                 case TokenType::operatorPlus:
                 case TokenType::operatorMinus:
                 case TokenType::operatorAsterisk:
                 case TokenType::operatorSlash: {
-                    auto left = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_left),
+                    auto left = TypeCheckedExpressionAST::createByTypeChecking(ast->_left,
                                                                                ExpectedEitherTypeHint(arithmeticTypes),
                                                                                state, diagnostics);
 
                     Type type = left->getType();
 
-                    auto right = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_right),
+                    auto right = TypeCheckedExpressionAST::createByTypeChecking(ast->_right,
                                                                                 ExpectedTypeHint(type), state,
                                                                                 diagnostics);
 
                     checkType(type, hint, location, diagnostics);
 
-                    return std::unique_ptr<TypeCheckedBinaryOperatorExpressionAST>(
-                        new TypeCheckedBinaryOperatorExpressionAST(type, std::move(ast->_token), std::move(left),
-                                                                   std::move(right)));
+                    return new (context) TypeCheckedBinaryOperatorExpressionAST(type, ast->_token, left, right);
                 }
                 case TokenType::operatorEqualEqual:
                 case TokenType::operatorBangEqual: {
-                    auto left = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_left), UnknownTypeHint(),
+                    auto left = TypeCheckedExpressionAST::createByTypeChecking(ast->_left, UnknownTypeHint(),
                                                                                state, diagnostics);
 
                     Type leftType = left->getType();
 
-                    auto right = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_right),
+                    auto right = TypeCheckedExpressionAST::createByTypeChecking(ast->_right,
                                                                                 ExpectedTypeHint(leftType), state,
                                                                                 diagnostics);
 
@@ -235,30 +221,26 @@ namespace juice {
                     Type type = BuiltinIntegerType::getBool();
                     checkType(type, hint, location, diagnostics);
 
-                    return std::unique_ptr<TypeCheckedBinaryOperatorExpressionAST>(
-                        new TypeCheckedBinaryOperatorExpressionAST(type, std::move(ast->_token), std::move(left),
-                                                                   std::move(right)));
+                    return new (context) TypeCheckedBinaryOperatorExpressionAST(type, ast->_token, left, right);
                 }
                 case TokenType::operatorLower:
                 case TokenType::operatorLowerEqual:
                 case TokenType::operatorGreater:
                 case TokenType::operatorGreaterEqual: {
-                    auto left = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_left),
+                    auto left = TypeCheckedExpressionAST::createByTypeChecking(ast->_left,
                                                                                ExpectedEitherTypeHint(arithmeticTypes),
                                                                                state, diagnostics);
 
                     Type leftType = left->getType();
 
-                    auto right = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_right),
+                    auto right = TypeCheckedExpressionAST::createByTypeChecking(ast->_right,
                                                                                 ExpectedTypeHint(leftType), state,
                                                                                 diagnostics);
 
                     Type type = BuiltinIntegerType::getBool();
                     checkType(type, hint, location, diagnostics);
 
-                    return std::unique_ptr<TypeCheckedBinaryOperatorExpressionAST>(
-                        new TypeCheckedBinaryOperatorExpressionAST(type, std::move(ast->_token), std::move(left),
-                                                                   std::move(right)));
+                    return new (context) TypeCheckedBinaryOperatorExpressionAST(type, ast->_token, left, right);
                 }
                 default:
                     llvm_unreachable("All possible binary operators should be handled here");
@@ -266,21 +248,27 @@ namespace juice {
         }
 
         TypeCheckedIntegerLiteralExpressionAST
-            ::TypeCheckedIntegerLiteralExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token,
-                                                     int64_t value):
-            TypeCheckedExpressionAST(Kind::integerLiteralExpression, type, std::move(token)), _value(value) {}
+            ::TypeCheckedIntegerLiteralExpressionAST(Type type, size_t token, llvm::APInt value):
+            TypeCheckedExpressionAST(Kind::integerLiteralExpression, type, token), _value(std::move(value)) {}
 
-        void TypeCheckedIntegerLiteralExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics,
+        void TypeCheckedIntegerLiteralExpressionAST::diagnoseInto(const ast::ASTContext & context,
+                                                                  diag::DiagnosticEngine & diagnostics,
                                                                   unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::type_checked_integer_literal_expression_ast,
-                                 getColor(level), getType(), level, _token.get(), _value);
+            parser::LexerToken token = context.getToken(_token);
+
+            llvm::SmallString<40> value;
+            _value.toStringUnsigned(value);
+
+            diagnostics.diagnose(getLocation(context), diag::DiagnosticID::type_checked_integer_literal_expression_ast,
+                                 getColor(level), getType(), level, &token, value.str());
         }
 
-        std::unique_ptr<TypeCheckedIntegerLiteralExpressionAST>
+        TypeCheckedIntegerLiteralExpressionAST *
         TypeCheckedIntegerLiteralExpressionAST
-            ::createByTypeChecking(std::unique_ptr<ast::IntegerLiteralExpressionAST> ast, const TypeHint & hint,
+            ::createByTypeChecking(ast::IntegerLiteralExpressionAST * ast, const TypeHint & hint,
                                    TypeChecker::State & state, diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
+            ast::ASTContext & context = state.getContext();
+            basic::SourceLocation location(ast->getLocation(context));
 
             checkLValue(hint, location, diagnostics, "integer literal");
 
@@ -294,7 +282,7 @@ namespace juice {
                     if ((expectedType.isBuiltinInteger() && !expectedType.isBuiltinBool())
                         || expectedType.isBuiltinFloatingPoint()) {
                         type = expectedType;
-                    } else {
+                    } else if (expectedType) {
                         diagnostics.diagnose(location, diag::DiagnosticID::integer_literal_expected_type, expectedType);
                     }
 
@@ -334,32 +322,48 @@ namespace juice {
             if (type && type.isBuiltinInteger()) {
                 const auto * integerType = llvm::cast<BuiltinIntegerType>(type.getPointer());
 
-                if (ast->_value < integerType->getMinimumValue() || ast->_value > integerType->getMaximumValue()) {
-                    diagnostics.diagnose(location, diag::DiagnosticID::integer_literal_overflow, ast->_token->string,
-                                         type);
+                if (!integerType->canRepresentLiteral(ast->_value)) {
+                    diagnostics.diagnose(location, diag::DiagnosticID::integer_literal_overflow,
+                                         context.getString(ast->_token), type);
+                }
+            } else if (type && type.isBuiltinFloatingPoint()) {
+                const auto * floatingPointType = llvm::cast<BuiltinFloatingPointType>(type.getPointer());
+
+                llvm::APFloat value(floatingPointType->getSemantics());
+                auto status = value.convertFromAPInt(ast->_value, false, llvm::APFloat::rmNearestTiesToEven);
+
+                if (status & llvm::APFloat::opOverflow) {
+                    diagnostics.diagnose(location, diag::DiagnosticID::integer_literal_overflow,
+                                         context.getString(ast->_token), type);
                 }
             }
 
-            return std::unique_ptr<TypeCheckedIntegerLiteralExpressionAST>(
-                new TypeCheckedIntegerLiteralExpressionAST(type, std::move(ast->_token), ast->_value));
+            auto literal = new (context) TypeCheckedIntegerLiteralExpressionAST(type, ast->_token, ast->_value);
+            if (ast->_value.needsCleanup()) context.addDestruction(literal);
+
+            return literal;
         }
 
         TypeCheckedFloatingPointLiteralExpressionAST
-        ::TypeCheckedFloatingPointLiteralExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token,
-                                                       double value):
-            TypeCheckedExpressionAST(Kind::floatingPointLiteralExpression, type, std::move(token)), _value(value) {}
+        ::TypeCheckedFloatingPointLiteralExpressionAST(Type type, size_t token, double value):
+            TypeCheckedExpressionAST(Kind::floatingPointLiteralExpression, type, token), _value(value) {}
 
-        void TypeCheckedFloatingPointLiteralExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics,
+        void TypeCheckedFloatingPointLiteralExpressionAST::diagnoseInto(const ast::ASTContext & context,
+                                                                        diag::DiagnosticEngine & diagnostics,
                                                                         unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::type_checked_floating_point_literal_expression_ast,
-                                 getColor(level), getType(), level, _token.get(), _value);
+            parser::LexerToken token = context.getToken(_token);
+
+            diagnostics.diagnose(getLocation(context),
+                                 diag::DiagnosticID::type_checked_floating_point_literal_expression_ast,
+                                 getColor(level), getType(), level, &token, _value);
         }
 
-        std::unique_ptr<TypeCheckedFloatingPointLiteralExpressionAST>
+        TypeCheckedFloatingPointLiteralExpressionAST *
         TypeCheckedFloatingPointLiteralExpressionAST
-        ::createByTypeChecking(std::unique_ptr<ast::FloatingPointLiteralExpressionAST> ast, const TypeHint & hint,
+        ::createByTypeChecking(ast::FloatingPointLiteralExpressionAST * ast, const TypeHint & hint,
                                TypeChecker::State & state, diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
+            ast::ASTContext & context = state.getContext();
+            basic::SourceLocation location(ast->getLocation(context));
 
             checkLValue(hint, location, diagnostics, "floating-point literal");
 
@@ -372,7 +376,7 @@ namespace juice {
 
                     if (expectedType.isBuiltinFloatingPoint()) {
                         type = expectedType;
-                    } else {
+                    } else if (expectedType) {
                         diagnostics.diagnose(location, diag::DiagnosticID::floating_point_literal_expected_type,
                                              expectedType);
                     }
@@ -395,54 +399,78 @@ namespace juice {
                 }
             }
 
-            return std::unique_ptr<TypeCheckedFloatingPointLiteralExpressionAST>(
-                new TypeCheckedFloatingPointLiteralExpressionAST(type, std::move(ast->_token), ast->_value));
+            double value = ast->_value;
+
+            if (type) {
+                const auto * floatingPointType = llvm::cast<BuiltinFloatingPointType>(type.getPointer());
+
+                if (!floatingPointType->isDouble()) {
+                    llvm::APFloat decoded = parser::decodeFloatingPointLiteral(context.getString(ast->_token),
+                                                                               floatingPointType->getSemantics());
+                    bool losesInfo;
+                    decoded.convert(llvm::APFloat::IEEEdouble(), llvm::APFloat::rmNearestTiesToEven, &losesInfo);
+                    value = decoded.convertToDouble();
+                }
+
+                if (std::isinf(value)) {
+                    diagnostics.diagnose(location, diag::DiagnosticID::floating_point_literal_overflow,
+                                         context.getString(ast->_token), type);
+                }
+            }
+
+            return new (context) TypeCheckedFloatingPointLiteralExpressionAST(type, ast->_token, value);
         }
 
         TypeCheckedBooleanLiteralExpressionAST
-            ::TypeCheckedBooleanLiteralExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token, bool value):
-            TypeCheckedExpressionAST(Kind::booleanLiteralExpression, type, std::move(token)), _value(value) {}
+            ::TypeCheckedBooleanLiteralExpressionAST(Type type, size_t token, bool value):
+            TypeCheckedExpressionAST(Kind::booleanLiteralExpression, type, token), _value(value) {}
 
-        void TypeCheckedBooleanLiteralExpressionAST ::diagnoseInto(diag::DiagnosticEngine & diagnostics,
-                                                                   unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::type_checked_boolean_literal_expression_ast,
-                                 getColor(level), getType(), level, _token.get(), _value);
+        void TypeCheckedBooleanLiteralExpressionAST::diagnoseInto(const ast::ASTContext & context,
+                                                                  diag::DiagnosticEngine & diagnostics,
+                                                                  unsigned int level) const {
+            parser::LexerToken token = context.getToken(_token);
+
+            diagnostics.diagnose(getLocation(context), diag::DiagnosticID::type_checked_boolean_literal_expression_ast,
+                                 getColor(level), getType(), level, &token, _value);
         }
 
-        std::unique_ptr<TypeCheckedBooleanLiteralExpressionAST>
+        TypeCheckedBooleanLiteralExpressionAST *
         TypeCheckedBooleanLiteralExpressionAST
-            ::createByTypeChecking(std::unique_ptr<ast::BooleanLiteralExpressionAST> ast, const TypeHint & hint,
+            ::createByTypeChecking(ast::BooleanLiteralExpressionAST * ast, const TypeHint & hint,
                                    TypeChecker::State & state, diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
+            basic::SourceLocation location(ast->getLocation(state.getContext()));
 
             checkLValue(hint, location, diagnostics, "boolean literal");
 
             Type type = BuiltinIntegerType::getBool();
             checkType(type, hint, location, diagnostics);
 
-            return std::unique_ptr<TypeCheckedBooleanLiteralExpressionAST>(
-                new TypeCheckedBooleanLiteralExpressionAST(type, std::move(ast->_token), ast->_value));
+            return new (state.getContext()) TypeCheckedBooleanLiteralExpressionAST(type, ast->_token, ast->_value);
         }
 
-        TypeCheckedVariableExpressionAST::TypeCheckedVariableExpressionAST(std::unique_ptr<parser::LexerToken> token,
+        TypeCheckedVariableExpressionAST::TypeCheckedVariableExpressionAST(size_t token,
                                                                            VariableDeclaration declaration):
-            TypeCheckedExpressionAST(Kind::variableExpression, declaration.type, std::move(token)),
-            _index(declaration.index), _isMutable(declaration.isMutable) {}
+            TypeCheckedExpressionAST(Kind::variableExpression, declaration.type, token), _index(declaration.index),
+            _isMutable(declaration.isMutable) {}
 
-        void
-        TypeCheckedVariableExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            diagnostics.diagnose(getLocation(), diag::DiagnosticID::type_checked_variable_expression_ast,
-                                 getColor(level), getType(), (unsigned int)_index, level, _token.get(), _isMutable);
+        void TypeCheckedVariableExpressionAST::diagnoseInto(const ast::ASTContext & context,
+                                                            diag::DiagnosticEngine & diagnostics,
+                                                            unsigned int level) const {
+            parser::LexerToken token = context.getToken(_token);
+
+            diagnostics.diagnose(getLocation(context), diag::DiagnosticID::type_checked_variable_expression_ast,
+                                 getColor(level), getType(), (unsigned int)_index, level, &token, _isMutable);
         }
 
-        std::unique_ptr<TypeCheckedVariableExpressionAST>
-        TypeCheckedVariableExpressionAST::createByTypeChecking(std::unique_ptr<ast::VariableExpressionAST> ast,
+        TypeCheckedVariableExpressionAST *
+        TypeCheckedVariableExpressionAST::createByTypeChecking(ast::VariableExpressionAST * ast,
                                                                const TypeHint & hint, TypeChecker::State & state,
                                                                diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
-            auto token = std::move(ast->_token);
+            ast::ASTContext & context = state.getContext();
+            basic::SourceLocation location(ast->getLocation(context));
+            llvm::StringRef name = ast->name(context);
 
-            auto optionalDeclaration = state.getVariableDeclaration(token->string);
+            auto optionalDeclaration = state.getVariableDeclaration(name);
 
             VariableDeclaration declaration;
             if (optionalDeclaration) {
@@ -476,82 +504,82 @@ namespace juice {
 
                 checkType(declaration.type, hint, location, diagnostics);
             } else {
-                diagnostics.diagnose(location, diag::DiagnosticID::expression_ast_unresolved_identifier, token->string);
+                diagnostics.diagnose(location, diag::DiagnosticID::expression_ast_unresolved_identifier, name);
             }
 
-            return std::unique_ptr<TypeCheckedVariableExpressionAST>(
-                new TypeCheckedVariableExpressionAST(std::move(token), declaration));
+            return new (context) TypeCheckedVariableExpressionAST(ast->_token, declaration);
         }
 
         TypeCheckedGroupingExpressionAST
-            ::TypeCheckedGroupingExpressionAST(Type type, std::unique_ptr<parser::LexerToken> token,
-                                               std::unique_ptr<TypeCheckedExpressionAST> expression):
-            TypeCheckedExpressionAST(Kind::groupingExpression, type, std::move(token)),
-            _expression(std::move(expression)) {}
-
-        void
-        TypeCheckedGroupingExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            _expression->diagnoseInto(diagnostics, level);
+            ::TypeCheckedGroupingExpressionAST(Type type, size_t token, TypeCheckedExpressionAST * expression):
+            TypeCheckedExpressionAST(Kind::groupingExpression, type, token), _expression(expression) {}
+
+        void TypeCheckedGroupingExpressionAST::diagnoseInto(const ast::ASTContext & context,
+                                                            diag::DiagnosticEngine & diagnostics,
+                                                            unsigned int level) const {
+            _expression->diagnoseInto(context, diagnostics, level);
         }
 
-        std::unique_ptr<TypeCheckedGroupingExpressionAST>
-        TypeCheckedGroupingExpressionAST::createByTypeChecking(std::unique_ptr<ast::GroupingExpressionAST> ast,
+        TypeCheckedGroupingExpressionAST *
+        TypeCheckedGroupingExpressionAST::createByTypeChecking(ast::GroupingExpressionAST * ast,
                                                                const TypeHint & hint, TypeChecker::State & state,
                                                                diag::DiagnosticEngine & diagnostics) {
-            auto expression = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_expression), hint, state,
+            auto expression = TypeCheckedExpressionAST::createByTypeChecking(ast->_expression, hint, state,
                                                                              diagnostics);
 
             Type type = expression->getType();
 
-            return std::unique_ptr<TypeCheckedGroupingExpressionAST>(
-                new TypeCheckedGroupingExpressionAST(type, std::move(ast->_token), std::move(expression)));
+            return new (state.getContext()) TypeCheckedGroupingExpressionAST(type, ast->_token, expression);
         }
 
         TypeCheckedIfExpressionAST
-            ::TypeCheckedIfExpressionAST(Type type, std::unique_ptr<TypeCheckedExpressionAST> ifCondition,
-                                         std::unique_ptr<TypeCheckedControlFlowBodyAST> ifBody,
-                                         ElifVector && elifConditionsAndBodies,
-                                         std::unique_ptr<TypeCheckedControlFlowBodyAST> elseBody, bool isStatement):
-            TypeCheckedExpressionAST(Kind::ifExpression, type, nullptr), _ifCondition(std::move(ifCondition)),
-            _ifBody(std::move(ifBody)), _elifConditionsAndBodies(std::move(elifConditionsAndBodies)),
-            _elseBody(std::move(elseBody)), _isStatement(isStatement) {}
-
-        void TypeCheckedIfExpressionAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+            ::TypeCheckedIfExpressionAST(Type type, TypeCheckedExpressionAST * ifCondition,
+                                         TypeCheckedControlFlowBodyAST * ifBody,
+                                         llvm::ArrayRef<ElifConditionAndBody> elifConditionsAndBodies,
+                                         TypeCheckedControlFlowBodyAST * elseBody, bool isStatement):
+            TypeCheckedExpressionAST(Kind::ifExpression, type, ifBody->getKeyword()), _ifCondition(ifCondition),
+            _ifBody(ifBody), _elifConditionsAndBodies(elifConditionsAndBodies), _elseBody(elseBody),
+            _isStatement(isStatement) {}
+
+        void TypeCheckedIfExpressionAST::diagnoseInto(const ast::ASTContext & context,
+                                                      diag::DiagnosticEngine & diagnostics, unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken keyword = context.getToken(_ifBody->getKeyword());
 
             if (_isStatement) diagnostics.diagnose(location, diag::DiagnosticID::type_checked_if_statement_ast_0,
-                                                   getColor(level), getType(), level, _ifBody->getKeyword().get());
+                                                   getColor(level), getType(), level, &keyword);
             else diagnostics.diagnose(location, diag::DiagnosticID::type_checked_if_expression_ast_0, getColor(level),
-                                      getType(), level, _ifBody->getKeyword().get());
-            _ifCondition->diagnoseInto(diagnostics, level + 1);
+                                      getType(), level, &keyword);
+            _ifCondition->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::if_ast_1, getColor(level), level);
-            _ifBody->diagnoseInto(diagnostics, level + 1);
+            _ifBody->diagnoseInto(context, diagnostics, level + 1);
 
             for (const auto & conditionAndBody: _elifConditionsAndBodies) {
-                const auto & condition = std::get<0>(conditionAndBody);
-                const auto & body = std::get<1>(conditionAndBody);
+                const auto * condition = std::get<0>(conditionAndBody);
+                const auto * body = std::get<1>(conditionAndBody);
 
                 diagnostics.diagnose(location, diag::DiagnosticID::if_ast_2, getColor(level), level);
-                condition->diagnoseInto(diagnostics, level + 1);
+                condition->diagnoseInto(context, diagnostics, level + 1);
 
                 diagnostics.diagnose(location, diag::DiagnosticID::if_ast_3, getColor(level), level);
-                body->diagnoseInto(diagnostics, level + 1);
+                body->diagnoseInto(context, diagnostics, level + 1);
             }
 
             if (!_isStatement || _elseBody) {
                 diagnostics.diagnose(location, diag::DiagnosticID::if_ast_4, getColor(level), level);
-                _elseBody->diagnoseInto(diagnostics, level + 1);
+                _elseBody->diagnoseInto(context, diagnostics, level + 1);
             }
 
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
         }
 
-        std::unique_ptr<TypeCheckedIfExpressionAST>
-        TypeCheckedIfExpressionAST::createByTypeChecking(std::unique_ptr<ast::IfExpressionAST> ast,
-                                                         const TypeHint & hint, TypeChecker::State & state,
+        TypeCheckedIfExpressionAST *
+        TypeCheckedIfExpressionAST::createByTypeChecking(ast::IfExpressionAST * ast, const TypeHint & hint,
+                                                         TypeChecker::State & state,
                                                          diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
+            ast::ASTContext & context = state.getContext();
+            basic::SourceLocation location(ast->getLocation(context));
 
             checkLValue(hint, location, diagnostics, ast->_isStatement ? "if statement" : "if expression");
 
@@ -559,48 +587,44 @@ namespace juice {
             const TypeHint & ifHint = ast->_isStatement ? noneTypeHint : hint;
 
             auto ifCondition =
-                TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_ifCondition),
+                TypeCheckedExpressionAST::createByTypeChecking(ast->_ifCondition,
                                                                ExpectedTypeHint(BuiltinIntegerType::getBool()),
                                                                state, diagnostics);
 
-            auto ifBody = TypeCheckedControlFlowBodyAST::createByTypeChecking(std::move(ast->_ifBody), ifHint,
-                                                                              state, diagnostics);
+            auto ifBody = TypeCheckedControlFlowBodyAST::createByTypeChecking(ast->_ifBody, ifHint, state,
+                                                                              diagnostics);
 
             Type type = ast->_isStatement ? NothingType::get() : ifBody->getType();
 
-            ElifVector elifConditionsAndBodies;
+            llvm::SmallVector<ElifConditionAndBody, 4> elifConditionsAndBodies;
+            elifConditionsAndBodies.reserve(ast->_elifConditionsAndBodies.size());
 
-            std::transform(std::make_move_iterator(ast->_elifConditionsAndBodies.begin()),
-                           std::make_move_iterator(ast->_elifConditionsAndBodies.end()),
-                           std::back_inserter(elifConditionsAndBodies),
-                           [&](std::pair<std::unique_ptr<ast::ExpressionAST>,
-                                         std::unique_ptr<ast::ControlFlowBodyAST>> conditionAndBody) {
-                std::unique_ptr<ast::ExpressionAST> condition;
-                std::unique_ptr<ast::ControlFlowBodyAST> body;
-                std::tie(condition, body) = std::move(conditionAndBody);
+            for (const auto & conditionAndBody: ast->_elifConditionsAndBodies) {
+                ast::ExpressionAST * condition;
+                ast::ControlFlowBodyAST * body;
+                std::tie(condition, body) = conditionAndBody;
 
                 auto checkedCondition =
-                    TypeCheckedExpressionAST::createByTypeChecking(std::move(condition),
+                    TypeCheckedExpressionAST::createByTypeChecking(condition,
                                                                    ExpectedTypeHint(BuiltinIntegerType::getBool()),
                                                                    state, diagnostics);
 
-                auto checkedBody = TypeCheckedControlFlowBodyAST::createByTypeChecking(std::move(body), ifHint,
-                                                                                       state, diagnostics);
+                auto checkedBody = TypeCheckedControlFlowBodyAST::createByTypeChecking(body, ifHint, state,
+                                                                                       diagnostics);
 
-                return std::make_pair(std::move(checkedCondition), std::move(checkedBody));
-            });
+                elifConditionsAndBodies.emplace_back(checkedCondition, checkedBody);
+            }
 
-            std::unique_ptr<TypeCheckedControlFlowBodyAST> elseBody;
+            TypeCheckedControlFlowBodyAST * elseBody = nullptr;
 
             if (!ast->_isStatement || ast->_elseBody) {
-                elseBody = TypeCheckedControlFlowBodyAST::createByTypeChecking(std::move(ast->_elseBody), ifHint,
-                                                                               state, diagnostics);
+                elseBody = TypeCheckedControlFlowBodyAST::createByTypeChecking(ast->_elseBody, ifHint, state,
+                                                                               diagnostics);
             }
 
-            return std::unique_ptr<TypeCheckedIfExpressionAST>(
-                new TypeCheckedIfExpressionAST(type, std::move(ifCondition), std::move(ifBody),
-                                               std::move(elifConditionsAndBodies), std::move(elseBody),
-                                               ast->_isStatement));
+            return new (context) TypeCheckedIfExpressionAST(type, ifCondition, ifBody,
+                                                            context.copy(elifConditionsAndBodies), elseBody,
+                                                            ast->_isStatement);
         }
     }
 }
@@ -19,106 +19,90 @@
 
 namespace juice {
     namespace sema {
-        std::unique_ptr<TypeCheckedStatementAST>
-        TypeCheckedStatementAST::createByTypeChecking(std::unique_ptr<ast::StatementAST> ast,
-                                                      const TypeHint & hint, TypeChecker::State & state,
+        TypeCheckedStatementAST *
+        TypeCheckedStatementAST::createByTypeChecking(ast::StatementAST * ast, const TypeHint & hint,
+                                                      TypeChecker::State & state,
                                                       diag::DiagnosticEngine & diagnostics) {
-            if (llvm::isa<ast::DeclarationAST>(ast.get())) {
-                auto declaration = std::unique_ptr<ast::DeclarationAST>(
-                    llvm::cast<ast::DeclarationAST>(ast.release()));
-                return TypeCheckedDeclarationAST::createByTypeChecking(std::move(declaration), hint, state,
-                                                                       diagnostics);
+            if (auto declaration = llvm::dyn_cast<ast::DeclarationAST>(ast)) {
+                return TypeCheckedDeclarationAST::createByTypeChecking(declaration, hint, state, diagnostics);
             }
 
             switch (ast->getKind()) {
-                case ast::StatementAST::Kind::block: {
-                    auto block = std::unique_ptr<ast::BlockStatementAST>(
-                        llvm::cast<ast::BlockStatementAST>(ast.release()));
-                    return TypeCheckedBlockStatementAST::createByTypeChecking(std::move(block), hint, state,
-                                                                              diagnostics);
-                }
-                case ast::StatementAST::Kind::expression: {
-                    auto block = std::unique_ptr<ast::ExpressionStatementAST>(
-                        llvm::cast<ast::ExpressionStatementAST>(ast.release()));
-                    return TypeCheckedExpressionStatementAST::createByTypeChecking(std::move(block), hint, state,
-                                                                                   diagnostics);
-                }
-                case ast::StatementAST::Kind::_if: {
-                    auto block = std::unique_ptr<ast::IfStatementAST>(
-                        llvm::cast<ast::IfStatementAST>(ast.release()));
-                    return TypeCheckedIfStatementAST::createByTypeChecking(std::move(block), hint, state, diagnostics);
-                }
-                case ast::StatementAST::Kind::_while: {
-                    auto block = std::unique_ptr<ast::WhileStatementAST>(
-                        llvm::cast<ast::WhileStatementAST>(ast.release()));
-                    return TypeCheckedWhileStatementAST::createByTypeChecking(std::move(block), hint, state,
-                                                                              diagnostics);
-                }
+                case ast::StatementAST::Kind::block:
+                    return TypeCheckedBlockStatementAST::createByTypeChecking(llvm::cast<ast::BlockStatementAST>(ast),
+                                                                              hint, state, diagnostics);
+                case ast::StatementAST::Kind::expression:
+                    return TypeCheckedExpressionStatementAST
+                        ::createByTypeChecking(llvm::cast<ast::ExpressionStatementAST>(ast), hint, state, diagnostics);
+                case ast::StatementAST::Kind::_if:
+                    return TypeCheckedIfStatementAST::createByTypeChecking(llvm::cast<ast::IfStatementAST>(ast), hint,
+                                                                           state, diagnostics);
+                case ast::StatementAST::Kind::_while:
+                    return TypeCheckedWhileStatementAST::createByTypeChecking(llvm::cast<ast::WhileStatementAST>(ast),
+                                                                              hint, state, diagnostics);
                 default:
                     llvm_unreachable("All possible Statement kinds should be handled here");
             }
         }
 
-        TypeCheckedBlockStatementAST::TypeCheckedBlockStatementAST(Type type,
-                                                                   std::unique_ptr<TypeCheckedBlockAST> block):
-            TypeCheckedStatementAST(Kind::blockStatement, type), _block(std::move(block)) {}
+        TypeCheckedBlockStatementAST::TypeCheckedBlockStatementAST(Type type, TypeCheckedBlockAST * block):
+            TypeCheckedStatementAST(Kind::blockStatement, type), _block(block) {}
 
-        void
-        TypeCheckedBlockStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            _block->diagnoseInto(diagnostics, level);
+        void TypeCheckedBlockStatementAST::diagnoseInto(const ast::ASTContext & context,
+                                                        diag::DiagnosticEngine & diagnostics,
+                                                        unsigned int level) const {
+            _block->diagnoseInto(context, diagnostics, level);
         }
 
-        std::unique_ptr<TypeCheckedBlockStatementAST>
-        TypeCheckedBlockStatementAST::createByTypeChecking(std::unique_ptr<ast::BlockStatementAST> ast,
-                                                           const TypeHint & hint, TypeChecker::State & state,
+        TypeCheckedBlockStatementAST *
+        TypeCheckedBlockStatementAST::createByTypeChecking(ast::BlockStatementAST * ast, const TypeHint & hint,
+                                                           TypeChecker::State & state,
                                                            diag::DiagnosticEngine & diagnostics) {
-            auto block = TypeCheckedBlockAST::createByTypeChecking(std::move(ast->_block), hint, state, diagnostics);
+            auto block = TypeCheckedBlockAST::createByTypeChecking(ast->_block, hint, state, diagnostics);
 
             Type type = block->getType();
 
-            return std::unique_ptr<TypeCheckedBlockStatementAST>(new TypeCheckedBlockStatementAST(type,
-                                                                                                  std::move(block)));
+            return new (state.getContext()) TypeCheckedBlockStatementAST(type, block);
         }
 
-        TypeCheckedExpressionStatementAST
-            ::TypeCheckedExpressionStatementAST(Type type,
-                                                std::unique_ptr<TypeCheckedExpressionAST> expression):
-            TypeCheckedStatementAST(Kind::expressionStatement, type), _expression(std::move(expression)) {}
+        TypeCheckedExpressionStatementAST::TypeCheckedExpressionStatementAST(Type type,
+                                                                             TypeCheckedExpressionAST * expression):
+            TypeCheckedStatementAST(Kind::expressionStatement, type), _expression(expression) {}
 
-        void TypeCheckedExpressionStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics,
+        void TypeCheckedExpressionStatementAST::diagnoseInto(const ast::ASTContext & context,
+                                                             diag::DiagnosticEngine & diagnostics,
                                                              unsigned int level) const {
-            _expression->diagnoseInto(diagnostics, level);
+            _expression->diagnoseInto(context, diagnostics, level);
         }
 
-        std::unique_ptr<TypeCheckedExpressionStatementAST>
-        TypeCheckedExpressionStatementAST::createByTypeChecking(std::unique_ptr<ast::ExpressionStatementAST> ast,
+        TypeCheckedExpressionStatementAST *
+        TypeCheckedExpressionStatementAST::createByTypeChecking(ast::ExpressionStatementAST * ast,
                                                                 const TypeHint & hint, TypeChecker::State & state,
                                                                 diag::DiagnosticEngine & diagnostics) {
-            auto expression = TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_expression), hint, state,
+            auto expression = TypeCheckedExpressionAST::createByTypeChecking(ast->_expression, hint, state,
                                                                              diagnostics);
 
             Type type = expression->getType();
 
-            return std::unique_ptr<TypeCheckedExpressionStatementAST>(
-                new TypeCheckedExpressionStatementAST(type, std::move(expression)));
+            return new (state.getContext()) TypeCheckedExpressionStatementAST(type, expression);
         }
 
-        TypeCheckedIfStatementAST::TypeCheckedIfStatementAST(Type type,
-                                                             std::unique_ptr<TypeCheckedIfExpressionAST> ifExpression):
-            TypeCheckedStatementAST(Kind::ifStatement, type), _ifExpression(std::move(ifExpression)) {}
+        TypeCheckedIfStatementAST::TypeCheckedIfStatementAST(Type type, TypeCheckedIfExpressionAST * ifExpression):
+            TypeCheckedStatementAST(Kind::ifStatement, type), _ifExpression(ifExpression) {}
 
-        void TypeCheckedIfStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            _ifExpression->diagnoseInto(diagnostics, level);
+        void TypeCheckedIfStatementAST::diagnoseInto(const ast::ASTContext & context,
+                                                     diag::DiagnosticEngine & diagnostics, unsigned int level) const {
+            _ifExpression->diagnoseInto(context, diagnostics, level);
         }
 
-        std::unique_ptr<TypeCheckedIfStatementAST>
-        TypeCheckedIfStatementAST::createByTypeChecking(std::unique_ptr<ast::IfStatementAST> ast,
-                                                        const TypeHint & hint, TypeChecker::State & state,
+        TypeCheckedIfStatementAST *
+        TypeCheckedIfStatementAST::createByTypeChecking(ast::IfStatementAST * ast, const TypeHint & hint,
+                                                        TypeChecker::State & state,
                                                         diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
+            basic::SourceLocation location(ast->getLocation(state.getContext()));
 
-            auto ifExpression = TypeCheckedIfExpressionAST::createByTypeChecking(std::move(ast->_ifExpression), hint,
-                                                                                 state, diagnostics);
+            auto ifExpression = TypeCheckedIfExpressionAST::createByTypeChecking(ast->_ifExpression, hint, state,
+                                                                                 diagnostics);
 
             switch (hint.getKind()) {
                 case TypeHint::Kind::none: break;
@@ -137,43 +121,42 @@ namespace juice {
                 }
             }
 
-            return std::unique_ptr<TypeCheckedIfStatementAST>(new TypeCheckedIfStatementAST(NothingType::get(),
-                                                                                            std::move(ifExpression)));
+            return new (state.getContext()) TypeCheckedIfStatementAST(NothingType::get(), ifExpression);
         }
 
-        TypeCheckedWhileStatementAST::TypeCheckedWhileStatementAST(Type type,
-                                                                   std::unique_ptr<TypeCheckedExpressionAST> condition,
-                                                                   std::unique_ptr<TypeCheckedControlFlowBodyAST> body):
-            TypeCheckedStatementAST(Kind::whileStatement, type), _condition(std::move(condition)),
-            _body(std::move(body)) {}
+        TypeCheckedWhileStatementAST::TypeCheckedWhileStatementAST(Type type, TypeCheckedExpressionAST * condition,
+                                                                   TypeCheckedControlFlowBodyAST * body):
+            TypeCheckedStatementAST(Kind::whileStatement, type), _condition(condition), _body(body) {}
 
-        void
-        TypeCheckedWhileStatementAST::diagnoseInto(diag::DiagnosticEngine & diagnostics, unsigned int level) const {
-            basic::SourceLocation location(getLocation());
+        void TypeCheckedWhileStatementAST::diagnoseInto(const ast::ASTContext & context,
+                                                        diag::DiagnosticEngine & diagnostics,
+                                                        unsigned int level) const {
+            basic::SourceLocation location(getLocation(context));
+            parser::LexerToken keyword = context.getToken(_body->getKeyword());
 
             diagnostics.diagnose(location, diag::DiagnosticID::type_checked_while_statement_ast_0, getColor(level),
-                                 getType(), level, _body->getKeyword().get());
-            _condition->diagnoseInto(diagnostics, level + 1);
+                                 getType(), level, &keyword);
+            _condition->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::while_statement_ast_1, getColor(level), level);
-            _body->diagnoseInto(diagnostics, level + 1);
+            _body->diagnoseInto(context, diagnostics, level + 1);
 
             diagnostics.diagnose(location, diag::DiagnosticID::ast_end, getColor(level), level);
         }
 
-        std::unique_ptr<TypeCheckedWhileStatementAST>
-        TypeCheckedWhileStatementAST::createByTypeChecking(std::unique_ptr<ast::WhileStatementAST> ast,
-                                                           const TypeHint & hint, TypeChecker::State & state,
+        TypeCheckedWhileStatementAST *
+        TypeCheckedWhileStatementAST::createByTypeChecking(ast::WhileStatementAST * ast, const TypeHint & hint,
+                                                           TypeChecker::State & state,
                                                            diag::DiagnosticEngine & diagnostics) {
-            basic::SourceLocation location(ast->getLocation());
+            basic::SourceLocation location(ast->getLocation(state.getContext()));
 
             auto condition =
-                TypeCheckedExpressionAST::createByTypeChecking(std::move(ast->_condition),
+                TypeCheckedExpressionAST::createByTypeChecking(ast->_condition,
                                                                ExpectedTypeHint(BuiltinIntegerType::getBool()),
                                                                state, diagnostics);
 
-            auto body = TypeCheckedControlFlowBodyAST::createByTypeChecking(std::move(ast->_body), NoneTypeHint(),
-                                                                            state, diagnostics);
+            auto body = TypeCheckedControlFlowBodyAST::createByTypeChecking(ast->_body, NoneTypeHint(), state,
+                                                                            diagnostics);
 
             switch (hint.getKind()) {
                 case TypeHint::Kind::none: break;
@@ -192,8 +175,7 @@ namespace juice {
                 }
             }
 
-            return std::unique_ptr<TypeCheckedWhileStatementAST>(
-                new TypeCheckedWhileStatementAST(NothingType::get(), std::move(condition), std::move(body)));
+            return new (state.getContext()) TypeCheckedWhileStatementAST(NothingType::get(), condition, body);
         }
     }
 }
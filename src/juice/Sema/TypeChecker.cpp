@@ -11,6 +11,9 @@
 
 #include "juice/Sema/TypeChecker.h"
 
+#include <algorithm>
+#include <cassert>
+
 #include "juice/Sema/BuiltinType.h"
 #include "juice/Sema/TypeCheckedAST.h"
 #include "juice/Sema/TypeCheckedStatementAST.h"
@@ -18,118 +21,92 @@
 
 namespace juice {
     namespace sema {
-        bool TypeChecker::State::Scope::hasTypeDeclaration(llvm::StringRef name) const {
-            auto result = typeDeclarations.find(name);
-
-            if (result == typeDeclarations.end()) {
-                return parent && parent->hasTypeDeclaration(name);
-            }
+        TypeChecker::State::State(ast::ASTContext & context): _context(&context), _allocaVectorSize(0) {}
 
-            return true;
+        void TypeChecker::State::newScope() {
+            _scopes.push_back({_typeDeclarationNames.size(), _variableDeclarationNames.size()});
         }
 
-        llvm::Optional<Type> TypeChecker::State::Scope::getTypeDeclaration(llvm::StringRef name) const {
-            auto result = typeDeclarations.find(name);
+        void TypeChecker::State::endScope() {
+            assert(!_scopes.empty() && "endScope() called without matching newScope()");
 
-            if (result == typeDeclarations.end()) {
-                if (parent) return parent->getTypeDeclaration(name);
+            const Scope & scope = _scopes.back();
 
-                return llvm::None;
+            while (_typeDeclarationNames.size() > scope.typeDeclarationCount) {
+                _typeDeclarations.erase(_typeDeclarationNames.back());
+                _typeDeclarationNames.pop_back();
             }
 
-            return result->getValue();
-        }
-
-        bool TypeChecker::State::Scope::addTypeDeclaration(llvm::StringRef name, Type type) {
-            if (!(hasVariableDeclaration(name) || (parent && parent->hasTypeDeclaration(name)))) {
-                return typeDeclarations.try_emplace(name, type).second;
+            while (_variableDeclarationNames.size() > scope.variableDeclarationCount) {
+                _variableDeclarations.erase(_variableDeclarationNames.back());
+                _variableDeclarationNames.pop_back();
             }
 
-            return false;
+            _scopes.pop_back();
         }
 
-        bool TypeChecker::State::Scope::hasVariableDeclaration(llvm::StringRef name) const {
-            auto begin = variableDeclarations.begin();
-            auto result = std::find_if(begin, begin + currentVariableIndex, [&](const auto & declaration) {
-                return declaration.name.equals(name);
-            });
+        void TypeChecker::State::commitScope() {
+            assert(!_scopes.empty() && "commitScope() called without matching newScope()");
 
-            return result != begin + currentVariableIndex;
+            _scopes.pop_back();
         }
 
-        llvm::Optional<VariableDeclaration>
-        TypeChecker::State::Scope::getVariableDeclaration(llvm::StringRef name) const {
-            auto begin = variableDeclarations.begin();
-            auto result = std::find_if(begin, begin + currentVariableIndex, [&](const auto & declaration) {
-                return declaration.name.equals(name);
-            });
-
-            if (result == begin + currentVariableIndex) return llvm::None;
-
-            return *result;
-        }
-
-        llvm::Optional<size_t>
-        TypeChecker::State::Scope::addVariableDeclaration(llvm::StringRef name, Type type, bool isMutable) {
-            if (!(hasVariableDeclaration(name) || hasTypeDeclaration(name))) {
-                auto begin = variableDeclarations.begin();
-                auto currentIter = begin + currentVariableIndex;
-                if (currentIter == variableDeclarations.end()) {
-                    variableDeclarations.emplace_back(name, type, currentVariableIndex, isMutable);
-                } else variableDeclarations.emplace(currentIter, name, type, currentVariableIndex, isMutable);
-
-                return currentVariableIndex++;
-            }
-
-            return llvm::None;
+        bool TypeChecker::State::hasTypeDeclaration(llvm::StringRef name) const {
+            return _typeDeclarations.count(name);
         }
 
-        TypeChecker::State::State():
-            _currentScope(std::make_unique<Scope>(_variableDeclarations, 0, nullptr)) {}
+        llvm::Optional<Type> TypeChecker::State::getTypeDeclaration(llvm::StringRef name) const {
+            auto result = _typeDeclarations.find(name);
 
-        void TypeChecker::State::newScope() {
-            _currentScope = std::make_unique<Scope>(_variableDeclarations, _currentScope->currentVariableIndex,
-                                                    std::move(_currentScope));
-        }
+            if (result == _typeDeclarations.end()) return llvm::None;
 
-        void TypeChecker::State::endScope() {
-            _currentScope = std::move(_currentScope->parent);
+            return result->second;
         }
 
-        bool TypeChecker::State::hasTypeDeclaration(llvm::StringRef name) const {
-            return _currentScope->hasTypeDeclaration(name);
-        }
+        bool TypeChecker::State::addTypeDeclaration(llvm::StringRef name, Type type) {
+            if (hasVariableDeclaration(name) || !_typeDeclarations.try_emplace(name, type).second) return false;
 
-        llvm::Optional<Type> TypeChecker::State::getTypeDeclaration(llvm::StringRef name) const {
-            return _currentScope->getTypeDeclaration(name);
-        }
+            _typeDeclarationNames.push_back(name);
 
-        bool TypeChecker::State::addTypeDeclaration(llvm::StringRef name, Type type) {
-            return _currentScope->addTypeDeclaration(name, type);
+            return true;
         }
 
         bool TypeChecker::State::hasVariableDeclaration(llvm::StringRef name) const {
-            return _currentScope->hasVariableDeclaration(name);
+            return _variableDeclarations.count(name);
         }
 
         llvm::Optional<VariableDeclaration> TypeChecker::State::getVariableDeclaration(llvm::StringRef name) const {
-            return _currentScope->getVariableDeclaration(name);
+            auto result = _variableDeclarations.find(name);
+
+            if (result == _variableDeclarations.end()) return llvm::None;
+
+            return result->second;
         }
 
         llvm::Optional<size_t>
         TypeChecker::State::addVariableDeclaration(llvm::StringRef name, Type type, bool isMutable) {
-            return _currentScope->addVariableDeclaration(name, type, isMutable);
+            if (hasTypeDeclaration(name)) return llvm::None;
+
+            // Variables of sibling scopes are never alive at the same time, so they can share alloca indices.
+            size_t index = _variableDeclarationNames.size();
+
+            if (!_variableDeclarations.try_emplace(name, name, type, index, isMutable).second) return llvm::None;
+
+            _variableDeclarationNames.push_back(name);
+            _allocaVectorSize = std::max(_allocaVectorSize, index + 1);
+
+            return index;
         }
 
-        TypeChecker::Result::Result(std::unique_ptr<TypeCheckedModuleAST> ast, size_t allocaVectorSize):
-            ast(std::move(ast)), allocaVectorSize(allocaVectorSize) {}
+        TypeChecker::Result::Result(TypeCheckedModuleAST * ast, size_t allocaVectorSize):
+            ast(ast), allocaVectorSize(allocaVectorSize) {}
 
-        TypeChecker::TypeChecker(std::unique_ptr<ast::ModuleAST> ast,
+        TypeChecker::TypeChecker(ast::ASTContext & context, ast::ModuleAST * ast,
                                  std::shared_ptr<diag::DiagnosticEngine> diagnostics):
-            _ast(std::move(ast)), _diagnostics(std::move(diagnostics)) {}
+            _context(context), _ast(ast), _diagnostics(std::move(diagnostics)) {}
 
         TypeChecker::Result TypeChecker::typeCheck() {
-            State state;
+            State state(_context);
 
             declareBuiltinTypes(state);
 
@@ -138,9 +115,15 @@ namespace juice {
                 #include "juice/Sema/BuiltinTypes.def"
             });
 
-            auto ast = TypeCheckedModuleAST::createByTypeChecking(std::move(_ast), hint, state, *_diagnostics);
+            return typeCheck(state, hint);
+        }
+
+        TypeChecker::Result TypeChecker::typeCheck(State & state, const TypeHint & hint) {
+            state.setContext(_context);
+
+            auto ast = TypeCheckedModuleAST::createByTypeChecking(_ast, hint, state, *_diagnostics);
 
-            return { std::move(ast), state.getAllocaVectorSize() };
+            return { ast, state.getAllocaVectorSize() };
         }
 
         void TypeChecker::declareBuiltinTypes(State & state) {
@@ -0,0 +1,34 @@
+# test/CheckOutput.cmake - Compares the output of the juice driver or frontend with the expected output
+#
+# This file is part of the juice open source project
+#
+# Copyright (c) 2019 - 2020 juice project authors
+# Licensed under MIT License
+#
+# See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+# See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+separate_arguments(options UNIX_COMMAND "${OPTIONS}")
+
+# Without an action, the main driver is run with the options alone.
+if(DEFINED ACTION)
+    set(command ${JUICE} frontend --${ACTION} ${options} --input-file=${INPUT} --output-file=-)
+else()
+    set(command ${JUICE} ${options})
+endif()
+
+# Diagnostics go to stderr and dumps to stdout, which are compared together, with the exit code at the end.
+execute_process(COMMAND ${command}
+                OUTPUT_VARIABLE output
+                ERROR_VARIABLE output
+                RESULT_VARIABLE result)
+
+string(APPEND output "exit code: ${result}\n")
+
+file(READ ${EXPECTED} expected)
+string(REPLACE "{target-triple}" "${TARGET_TRIPLE}" expected "${expected}")
+
+if(NOT output STREQUAL expected)
+    message(FATAL_ERROR "Output of ${INPUT} differs from ${EXPECTED}:\n${output}")
+endif()
@@ -0,0 +1,345 @@
+// tools/juice-bench/SourceGenerator.cpp - Deterministic generator of large juice programs
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include "SourceGenerator.h"
+
+#include <utility>
+
+#include "llvm/Support/ErrorHandling.h"
+
+namespace juice {
+    namespace bench {
+        const SourceGenerator::Workload SourceGenerator::allWorkloads[4] = {
+            Workload::expressions,
+            Workload::declarations,
+            Workload::controlFlow,
+            Workload::literals
+        };
+
+        SourceGenerator::SourceGenerator(Workload workload, uint64_t seed):
+            _workload(workload), _engine(seed), _os(_source) {}
+
+        std::string SourceGenerator::generate(size_t statementCount) {
+            _source.clear();
+            _scopes = {{{"v0", Type::integer, true}}};
+            _nextVariable = 1;
+            _blockDepth = 0;
+
+            _os << "var v0 = 0\n";
+
+            for (size_t i = 0; i < statementCount; ++i) {
+                generateStatement();
+            }
+
+            // The module has to end in an expression to have a value.
+            _os << "v0\n";
+
+            return std::move(_os.str());
+        }
+
+        llvm::StringRef SourceGenerator::getName(Workload workload) {
+            switch (workload) {
+                case Workload::expressions:
+                    return "expressions";
+                case Workload::declarations:
+                    return "declarations";
+                case Workload::controlFlow:
+                    return "control-flow";
+                case Workload::literals:
+                    return "literals";
+            }
+
+            llvm_unreachable("All workloads should be handled here");
+        }
+
+        void SourceGenerator::indent() {
+            _os.indent(_blockDepth * 4);
+        }
+
+        void SourceGenerator::generateStatement() {
+            switch (_workload) {
+                case Workload::expressions:
+                    if (chance(90)) {
+                        generateDeclaration(true);
+                    } else {
+                        generateAssignment();
+                    }
+                    break;
+                case Workload::declarations:
+                case Workload::literals:
+                    if (chance(85)) {
+                        generateDeclaration(false);
+                    } else {
+                        generateAssignment();
+                    }
+                    break;
+                case Workload::controlFlow: {
+                    // Nested blocks rarely contain control flow themselves, so that the program grows linearly with
+                    // the number of statements.
+                    uint64_t kind = _blockDepth == 0 || (_blockDepth < 3 && chance(10)) ? random(8) : 8 + random(2);
+                    if (kind < 4) {
+                        generateIf();
+                    } else if (kind < 6) {
+                        generateWhile();
+                    } else if (kind < 7) {
+                        indent();
+                        _os << "do ";
+                        generateBlock(random(3));
+                        _os << "\n";
+                    } else if (kind < 8 || chance(50)) {
+                        generateDeclaration(false);
+                    } else {
+                        generateAssignment();
+                    }
+                    break;
+                }
+            }
+        }
+
+        void SourceGenerator::generateDeclaration(bool isDeeplyNested) {
+            Type type = pickType();
+            bool isMutable = chance(70);
+
+            std::string name = "v" + std::to_string(_nextVariable++);
+
+            indent();
+            _os << (isMutable ? "var " : "let ") << name;
+
+            if (_workload == Workload::declarations && chance(50))
+                _os << ": " << getTypeName(type);
+
+            _os << " = ";
+
+            unsigned int depth;
+            switch (_workload) {
+                case Workload::expressions:
+                    depth = isDeeplyNested ? 14 + random(6) : 2;
+                    break;
+                case Workload::declarations:
+                    depth = random(2);
+                    break;
+                case Workload::controlFlow:
+                    depth = 2;
+                    break;
+                case Workload::literals:
+                    depth = 3 + random(3);
+                    break;
+            }
+
+            generateExpression(type, depth);
+            _os << "\n";
+
+            // The variable can't be used in its own initialization, so it becomes visible only now.
+            _scopes.back().push_back({std::move(name), type, isMutable});
+        }
+
+        void SourceGenerator::generateAssignment() {
+            Type type = pickType();
+
+            const Variable * variable = pickVariable(type, true);
+            if (!variable) {
+                type = Type::integer;
+                variable = pickVariable(type, true);
+            }
+
+            indent();
+            _os << variable->name;
+
+            if (type == Type::boolean) {
+                _os << " = ";
+            } else {
+                static const char * const operators[] = {" = ", " += ", " -= ", " *= "};
+                _os << operators[random(4)];
+            }
+
+            generateExpression(type, _workload == Workload::expressions ? 8 : 2);
+            _os << "\n";
+        }
+
+        void SourceGenerator::generateIf() {
+            indent();
+            _os << "if ";
+            generateComparison(2);
+            _os << " ";
+            generateBlock(random(3));
+
+            uint64_t elifCount = _workload == Workload::controlFlow ? random(8) : random(2);
+            for (uint64_t i = 0; i < elifCount; ++i) {
+                _os << " elif ";
+                generateComparison(2);
+                _os << " ";
+                generateBlock(random(3));
+            }
+
+            if (chance(60)) {
+                _os << " else ";
+                generateBlock(random(3));
+            }
+
+            _os << "\n";
+        }
+
+        void SourceGenerator::generateWhile() {
+            indent();
+            _os << "while ";
+            generateComparison(2);
+            _os << " ";
+            generateBlock(random(4));
+            _os << "\n";
+        }
+
+        void SourceGenerator::generateBlock(size_t statementCount) {
+            _os << "{\n";
+
+            _scopes.emplace_back();
+            ++_blockDepth;
+
+            for (size_t i = 0; i < statementCount; ++i) {
+                generateStatement();
+            }
+
+            // IRGen can only generate blocks that end in a yielding statement, even if their value is never used.
+            generateAssignment();
+
+            --_blockDepth;
+            _scopes.pop_back();
+
+            indent();
+            _os << "}";
+        }
+
+        void SourceGenerator::generateExpression(Type type, unsigned int depth) {
+            if (depth == 0) {
+                unsigned int variablePercent = _workload == Workload::literals ? 10 : 50;
+
+                const Variable * variable = chance(variablePercent) ? pickVariable(type, false) : nullptr;
+                if (variable) {
+                    _os << variable->name;
+                } else if (type == Type::boolean && chance(50)) {
+                    generateComparison(0);
+                } else {
+                    generateLiteral(type);
+                }
+
+                return;
+            }
+
+            // Only one operand is as deep as the whole expression, so that its size grows linearly with its depth.
+            unsigned int shallowDepth = chance(15) ? depth - 1 : 0;
+
+            uint64_t kind = random(10);
+
+            if (type == Type::boolean) {
+                if (kind < 6) {
+                    generateComparison(depth - 1);
+                } else if (kind < 9) {
+                    generateExpression(Type::boolean, depth - 1);
+                    _os << (chance(50) ? " && " : " || ");
+                    generateExpression(Type::boolean, shallowDepth);
+                } else {
+                    _os << "(";
+                    generateExpression(Type::boolean, depth - 1);
+                    _os << ")";
+                }
+
+                return;
+            }
+
+            if (kind < 6) {
+                static const char * const operators[] = {" + ", " - ", " * ", " / "};
+                uint64_t operatorIndex = random(4);
+
+                generateExpression(type, depth - 1);
+                _os << operators[operatorIndex];
+
+                // Dividing by zero would be undefined behavior.
+                if (operatorIndex == 3) {
+                    generateLiteral(type);
+                } else {
+                    generateExpression(type, shallowDepth);
+                }
+            } else if (kind < 8) {
+                _os << "(";
+                generateExpression(type, depth - 1);
+                _os << ")";
+            } else {
+                // Without the parentheses, an operator following the expression would become part of its else body.
+                _os << "(if ";
+                generateComparison(depth / 2);
+                _os << ": ";
+                generateExpression(type, depth - 1);
+                _os << " else: ";
+                generateExpression(type, shallowDepth);
+                _os << ")";
+            }
+        }
+
+        void SourceGenerator::generateLiteral(Type type) {
+            switch (type) {
+                case Type::integer:
+                    _os << 1 + random(999);
+                    break;
+                case Type::floatingPoint:
+                    _os << random(1000) << "." << 1 + random(99);
+                    break;
+                case Type::boolean:
+                    _os << (chance(50) ? "true" : "false");
+                    break;
+            }
+        }
+
+        void SourceGenerator::generateComparison(unsigned int depth) {
+            static const char * const operators[] = {" < ", " <= ", " > ", " >= ", " == ", " != "};
+
+            generateExpression(Type::integer, depth);
+            _os << operators[random(6)];
+            generateExpression(Type::integer, 0);
+        }
+
+        const SourceGenerator::Variable * SourceGenerator::pickVariable(Type type, bool mustBeMutable) {
+            // Probing a few random variables instead of searching all of them keeps the generation linear in the
+            // size of the program.
+            for (unsigned int attempt = 0; attempt < 8; ++attempt) {
+                const auto & scope = _scopes[random(_scopes.size())];
+                if (scope.empty()) continue;
+
+                const Variable & variable = scope[random(scope.size())];
+                if (variable.type == type && (variable.isMutable || !mustBeMutable)) return &variable;
+            }
+
+            // v0 is always visible.
+            if (type == Type::integer) return &_scopes.front().front();
+
+            return nullptr;
+        }
+
+        SourceGenerator::Type SourceGenerator::pickType() {
+            uint64_t value = random(10);
+
+            if (value < 6) return Type::integer;
+            if (value < 8) return Type::floatingPoint;
+            return Type::boolean;
+        }
+
+        llvm::StringRef SourceGenerator::getTypeName(Type type) {
+            switch (type) {
+                case Type::integer:
+                    return "_BuiltinInt64";
+                case Type::floatingPoint:
+                    return "_BuiltinDouble";
+                case Type::boolean:
+                    return "_BuiltinBool";
+            }
+
+            llvm_unreachable("All types should be handled here");
+        }
+    }
+}
@@ -0,0 +1,106 @@
+// tools/juice-bench/SourceGenerator.h - Deterministic generator of large juice programs
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#ifndef JUICE_BENCH_SOURCEGENERATOR_H
+#define JUICE_BENCH_SOURCEGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace juice {
+    namespace bench {
+        // Generates valid programs that stress one part of the compiler each. The output only depends on the
+        // workload, the number of statements and the seed, so results of different compiler versions stay comparable.
+        class SourceGenerator {
+        public:
+            enum class Workload: uint8_t {
+                // Few declarations with very deeply nested arithmetic and logical expressions.
+                expressions,
+                // Many variable and constant declarations with short initializations and type annotations.
+                declarations,
+                // Long if/elif/else chains and while loops, with nested blocks.
+                controlFlow,
+                // Expressions that consist mostly of integer, floating-point and boolean literals.
+                literals
+            };
+
+            static const Workload allWorkloads[4];
+
+        private:
+            enum class Type: uint8_t {
+                integer,
+                floatingPoint,
+                boolean
+            };
+
+            struct Variable {
+                std::string name;
+                Type type;
+                bool isMutable;
+            };
+
+            Workload _workload;
+            // std::mt19937_64 produces the same sequence on every platform, unlike the standard distributions, so
+            // random numbers are only ever derived from its raw output.
+            std::mt19937_64 _engine;
+
+            std::string _source;
+            llvm::raw_string_ostream _os;
+
+            // The variables visible in each open block, the outermost first.
+            std::vector<std::vector<Variable>> _scopes;
+            size_t _nextVariable = 0;
+            unsigned int _blockDepth = 0;
+
+        public:
+            SourceGenerator() = delete;
+            SourceGenerator(const SourceGenerator &) = delete;
+            SourceGenerator & operator=(const SourceGenerator &) = delete;
+
+            SourceGenerator(Workload workload, uint64_t seed);
+
+            // Returns a program with `statementCount` top-level statements, which yields an integer.
+            std::string generate(size_t statementCount);
+
+            static llvm::StringRef getName(Workload workload);
+
+        private:
+            uint64_t random(uint64_t bound) { return _engine() % bound; }
+            bool chance(unsigned int percent) { return random(100) < percent; }
+
+            void indent();
+
+            void generateStatement();
+            void generateDeclaration(bool isDeeplyNested);
+            void generateAssignment();
+            void generateIf();
+            void generateWhile();
+            // Generates a block with `statementCount` statements, followed by an assignment.
+            void generateBlock(size_t statementCount);
+
+            void generateExpression(Type type, unsigned int depth);
+            void generateLiteral(Type type);
+            void generateComparison(unsigned int depth);
+
+            const Variable * pickVariable(Type type, bool mustBeMutable);
+            Type pickType();
+            static llvm::StringRef getTypeName(Type type);
+        };
+    }
+}
+
+#endif //JUICE_BENCH_SOURCEGENERATOR_H
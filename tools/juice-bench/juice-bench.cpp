@@ -0,0 +1,466 @@
+// tools/juice-bench/juice-bench.cpp - Compiler throughput benchmarks on generated programs
+//
+// This source file is part of the juice open source project
+//
+// Copyright (c) 2019 - 2020 juice project authors
+// Licensed under MIT License
+//
+// See https://github.com/juice-lang/juice/blob/master/LICENSE for license information
+// See https://github.com/juice-lang/juice/blob/master/CONTRIBUTORS.txt for the list of juice project authors
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SourceGenerator.h"
+#include "juice/AST/ASTContext.h"
+#include "juice/Basic/SourceManager.h"
+#include "juice/Basic/Version.h"
+#include "juice/Diagnostics/Diagnostics.h"
+#include "juice/IRGen/IRGen.h"
+#include "juice/Parser/CharacterScanner.h"
+#include "juice/Parser/Lexer.h"
+#include "juice/Parser/LiteralDecoder.h"
+#include "juice/Parser/Parser.h"
+#include "juice/Parser/TokenBuffer.h"
+#include "juice/Sema/BuiltinType.h"
+#include "juice/Sema/TypeCheckedStatementAST.h"
+#include "juice/Sema/TypeChecker.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace juice;
+using bench::SourceGenerator;
+
+namespace {
+    enum class OutputFormat {
+        text,
+        json
+    };
+
+    llvm::cl::list<SourceGenerator::Workload> workloads(
+        "workload",
+        llvm::cl::desc("Only run the given workloads (default: all)"),
+        llvm::cl::CommaSeparated,
+        llvm::cl::values(
+            clEnumValN(SourceGenerator::Workload::expressions, "expressions", "Deeply nested expressions"),
+            clEnumValN(SourceGenerator::Workload::declarations, "declarations", "Many variable declarations"),
+            clEnumValN(SourceGenerator::Workload::controlFlow, "control-flow", "Long if/elif and while chains"),
+            clEnumValN(SourceGenerator::Workload::literals, "literals", "Literal-heavy expressions")
+        )
+    );
+
+    llvm::cl::list<unsigned int> scopeSizes(
+        "scope-sizes",
+        llvm::cl::desc("Measure declaring and looking up <N> variables in one scope for every given N "
+                       "(default: 1000,10000,100000,1000000, unless --workload is given)"),
+        llvm::cl::value_desc("N"),
+        llvm::cl::CommaSeparated
+    );
+
+    llvm::cl::opt<unsigned int> statementCount(
+        "statements",
+        llvm::cl::desc("Generate <N> top-level statements per workload"),
+        llvm::cl::value_desc("N"),
+        llvm::cl::init(5000)
+    );
+
+    llvm::cl::opt<unsigned int> iterationCount(
+        "iterations",
+        llvm::cl::desc("Report the best of <N> runs of every phase"),
+        llvm::cl::value_desc("N"),
+        llvm::cl::init(5)
+    );
+
+    llvm::cl::opt<unsigned int> seed(
+        "seed",
+        llvm::cl::desc("Seed of the program generator"),
+        llvm::cl::init(0)
+    );
+
+    llvm::cl::opt<OutputFormat> outputFormat(
+        "format",
+        llvm::cl::desc("Choose output format"),
+        llvm::cl::values(
+            clEnumValN(OutputFormat::text, "text", "Human-readable table"),
+            clEnumValN(OutputFormat::json, "json", "JSON object")
+        ),
+        llvm::cl::init(OutputFormat::text)
+    );
+
+    llvm::cl::opt<bool> printSource(
+        "print-source",
+        llvm::cl::desc("Print the generated program of every selected workload instead of running benchmarks")
+    );
+
+
+    struct Result {
+        std::string workload;
+        llvm::StringRef phase;
+        size_t itemCount;
+        llvm::StringRef unit;
+        double seconds;
+        // The size of the source text that was processed, 0 if the phase doesn't work on the source directly.
+        size_t byteCount = 0;
+    };
+
+    // Runs `prepare` and then `run` on its result for every iteration and returns the shortest duration of `run` in
+    // seconds.
+    template <typename Prepare, typename Run>
+    double measure(Prepare prepare, Run run) {
+        double best = std::numeric_limits<double>::infinity();
+
+        for (unsigned int i = 0; i < iterationCount; ++i) {
+            auto prepared = prepare();
+
+            auto start = std::chrono::steady_clock::now();
+            run(prepared);
+            std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+            best = std::min(best, duration.count());
+        }
+
+        return best;
+    }
+
+    // Keeps the compiler from optimizing away a computation whose result is otherwise unused.
+    volatile size_t checksum;
+
+    // One run of the pipeline, up to the phase that is measured.
+    struct Compilation {
+        std::shared_ptr<diag::DiagnosticEngine> diagnostics;
+        std::unique_ptr<ast::ASTContext> context;
+        ast::ModuleAST * ast = nullptr;
+        llvm::Optional<sema::TypeChecker::Result> typeCheckResult;
+        size_t parsedNodeCount = 0;
+        std::unique_ptr<irgen::IRGen> codegen;
+    };
+
+    class Benchmark {
+        std::string _workload;
+        std::string _source;
+
+    public:
+        Benchmark(llvm::StringRef workload, std::string source): _workload(workload), _source(std::move(source)) {}
+
+        // Returns false if the generated program has errors, which have been diagnosed.
+        bool run(std::vector<Result> & results) {
+            Compilation compilation = typeCheck();
+            if (compilation.diagnostics->hadError()) return false;
+
+            size_t tokenCount = compilation.context->getTokens().size();
+            size_t parsedNodeCount = compilation.parsedNodeCount;
+            size_t typeCheckedNodeCount = compilation.context->getNodeCount() - parsedNodeCount;
+
+            results.push_back({_workload, "lex", tokenCount, "tokens", measure([this] {
+                return Compilation{createDiagnostics()};
+            }, [](Compilation & compilation) {
+                parser::Lexer(compilation.diagnostics->getBuffer()).tokenize();
+            }), _source.size()});
+
+            // The same with the scalar fallback of the character scanner, as a baseline for its vectorized loops.
+            parser::setVectorizedScanning(false);
+            results.push_back({_workload, "lex-scalar", tokenCount, "tokens", measure([this] {
+                return Compilation{createDiagnostics()};
+            }, [](Compilation & compilation) {
+                parser::Lexer(compilation.diagnostics->getBuffer()).tokenize();
+            }), _source.size()});
+            parser::setVectorizedScanning(true);
+
+            measureTokens(compilation.context->getTokens(), results);
+
+            results.push_back({_workload, "parse", parsedNodeCount, "nodes", measure([this] {
+                return lex();
+            }, [](Compilation & compilation) {
+                parse(compilation);
+            })});
+
+            results.push_back({_workload, "type-check", typeCheckedNodeCount, "nodes", measure([this] {
+                Compilation compilation = lex();
+                parse(compilation);
+
+                return compilation;
+            }, [](Compilation & compilation) {
+                typeCheck(compilation);
+            })});
+
+            results.push_back({_workload, "irgen", typeCheckedNodeCount, "nodes", measure([this] {
+                Compilation compilation = typeCheck();
+                compilation.codegen = std::make_unique<irgen::IRGen>(*compilation.context,
+                                                                     *compilation.typeCheckResult,
+                                                                     compilation.diagnostics);
+
+                return compilation;
+            }, [](Compilation & compilation) {
+                compilation.codegen->generate();
+            })});
+
+            results.push_back({_workload, "end-to-end", tokenCount, "tokens", measure([] {
+                return Compilation();
+            }, [this](Compilation & compilation) {
+                compilation = typeCheck();
+
+                irgen::IRGen codegen(*compilation.context, *compilation.typeCheckResult, compilation.diagnostics);
+
+                llvm::SmallVector<char, 0> object;
+                llvm::raw_svector_ostream os(object);
+                if (codegen.generate() && codegen.optimize())
+                    codegen.emitObject(os);
+            })});
+
+            return true;
+        }
+
+    private:
+        // Measures the keyword lookup on the program's identifiers and keywords, and the decoding of its numeric
+        // literals, without the rest of the lexer and parser.
+        void measureTokens(const parser::TokenBuffer & tokens, std::vector<Result> & results) const {
+            std::vector<llvm::StringRef> words;
+            std::vector<llvm::StringRef> integerLiterals;
+            std::vector<llvm::StringRef> floatingPointLiterals;
+
+            for (size_t i = 0, n = tokens.size(); i < n; ++i) {
+                parser::LexerToken::Type type = tokens.getType(i);
+                llvm::StringRef string = tokens.getString(i);
+
+                if (type == parser::LexerToken::Type::integerLiteral) {
+                    integerLiterals.push_back(string);
+                } else if (type == parser::LexerToken::Type::floatingPointLiteral) {
+                    floatingPointLiterals.push_back(string);
+                } else if (type == parser::LexerToken::Type::identifier
+                           || parser::Lexer::identifierType(string) == type) {
+                    words.push_back(string);
+                }
+            }
+
+            size_t wordBytes = 0;
+            for (llvm::StringRef word: words) wordBytes += word.size();
+
+            results.push_back({_workload, "keywords", words.size(), "words", measure([] {
+                return 0;
+            }, [&](int) {
+                size_t keywordCount = 0;
+                for (llvm::StringRef word: words) {
+                    if (parser::Lexer::identifierType(word) != parser::LexerToken::Type::identifier) ++keywordCount;
+                }
+
+                checksum = keywordCount;
+            }), wordBytes});
+
+            size_t literalCount = integerLiterals.size() + floatingPointLiterals.size();
+            size_t literalBytes = 0;
+            for (llvm::StringRef literal: integerLiterals) literalBytes += literal.size();
+            for (llvm::StringRef literal: floatingPointLiterals) literalBytes += literal.size();
+
+            if (literalCount == 0) return;
+
+            results.push_back({_workload, "literals", literalCount, "literals", measure([] {
+                return 0;
+            }, [&](int) {
+                size_t bits = 0;
+                for (llvm::StringRef literal: integerLiterals) {
+                    bits += parser::decodeIntegerLiteral(literal).countPopulation();
+                }
+                for (llvm::StringRef literal: floatingPointLiterals) {
+                    bits += parser::decodeFloatingPointLiteral(literal).bitcastToAPInt().countPopulation();
+                }
+
+                checksum = bits;
+            }), literalBytes});
+        }
+
+        std::shared_ptr<diag::DiagnosticEngine> createDiagnostics() const {
+            auto manager = basic::SourceManager::mainString(_source, "<" + _workload + ">");
+            return std::make_shared<diag::DiagnosticEngine>(std::move(manager), llvm::errs());
+        }
+
+        Compilation lex() const {
+            Compilation compilation{createDiagnostics()};
+            compilation.context = std::make_unique<ast::ASTContext>(
+                parser::Lexer(compilation.diagnostics->getBuffer()).tokenize());
+
+            return compilation;
+        }
+
+        static void parse(Compilation & compilation) {
+            parser::Parser juiceParser(*compilation.context, compilation.diagnostics);
+            compilation.ast = juiceParser.parseModule();
+            compilation.parsedNodeCount = compilation.context->getNodeCount();
+        }
+
+        Compilation typeCheck() const {
+            Compilation compilation = lex();
+            parse(compilation);
+            typeCheck(compilation);
+
+            return compilation;
+        }
+
+        static void typeCheck(Compilation & compilation) {
+            if (compilation.diagnostics->hadError()) return;
+
+            sema::TypeChecker typeChecker(*compilation.context, compilation.ast, compilation.diagnostics);
+            compilation.typeCheckResult.emplace(typeChecker.typeCheck());
+        }
+    };
+
+
+    // Declares `count` variables in a single scope of the type checker's state, looks all of them up and ends the
+    // scope again, to show how the symbol table scales with the number of declarations.
+    void runScopeBenchmark(size_t count, std::vector<Result> & results) {
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; ++i) names.push_back("v" + std::to_string(i));
+
+        auto manager = basic::SourceManager::mainString("", "<scopes>");
+        ast::ASTContext context(parser::TokenBuffer(manager->getMainBuffer()));
+        sema::Type type = sema::BuiltinIntegerType::getInt64();
+
+        auto createState = [&] {
+            sema::TypeChecker::State state(context);
+            sema::TypeChecker::declareBuiltinTypes(state);
+            state.newScope();
+
+            return state;
+        };
+
+        auto declare = [&](sema::TypeChecker::State & state) {
+            for (const std::string & name: names) state.addVariableDeclaration(name, type, false);
+        };
+
+        std::string workload = "scope-" + std::to_string(count);
+
+        results.push_back({workload, "declare", count, "names", measure(createState, declare)});
+
+        results.push_back({workload, "lookup", count, "names", measure([&] {
+            sema::TypeChecker::State state = createState();
+            declare(state);
+
+            return state;
+        }, [&](sema::TypeChecker::State & state) {
+            size_t foundCount = 0;
+            for (const std::string & name: names) {
+                if (state.getVariableDeclaration(name)) ++foundCount;
+            }
+
+            checksum = foundCount;
+        })});
+
+        results.push_back({workload, "end-scope", count, "names", measure([&] {
+            sema::TypeChecker::State state = createState();
+            declare(state);
+
+            return state;
+        }, [](sema::TypeChecker::State & state) {
+            state.endScope();
+        })});
+    }
+
+
+    void printText(llvm::raw_ostream & os, const std::vector<Result> & results) {
+        os << "juice-bench " << basic::Version::getCurrentString();
+        if (auto llvmVersion = basic::Version::getLLVM())
+            os << " (LLVM " << llvmVersion->getString() << ")";
+        os << ", " << statementCount << " statements, seed " << seed << ", best of " << iterationCount << "\n\n";
+
+        os << "workload       phase             items unit         seconds        items/s       MB/s\n";
+
+        for (const Result & result: results) {
+            os << llvm::format("%-14s %-12s %10zu %-8s %11.6f %14.4e", result.workload.c_str(),
+                               result.phase.str().c_str(), result.itemCount, result.unit.str().c_str(),
+                               result.seconds, result.itemCount / result.seconds);
+
+            if (result.byteCount != 0)
+                os << llvm::format(" %10.2f", result.byteCount / result.seconds / 1e6);
+
+            os << "\n";
+        }
+    }
+
+    void printJSON(llvm::raw_ostream & os, const std::vector<Result> & results) {
+        llvm::json::OStream json(os, 2);
+
+        json.object([&] {
+            json.attribute("version", basic::Version::getCurrentString());
+            if (auto llvmVersion = basic::Version::getLLVM())
+                json.attribute("llvmVersion", llvmVersion->getString());
+            json.attribute("statements", (int64_t)statementCount);
+            json.attribute("seed", (int64_t)seed);
+            json.attribute("iterations", (int64_t)iterationCount);
+
+            json.attributeArray("results", [&] {
+                for (const Result & result: results) {
+                    json.object([&] {
+                        json.attribute("workload", result.workload);
+                        json.attribute("phase", result.phase);
+                        json.attribute("items", (int64_t)result.itemCount);
+                        json.attribute("unit", result.unit);
+                        json.attribute("seconds", result.seconds);
+                        json.attribute("itemsPerSecond", result.itemCount / result.seconds);
+                        if (result.byteCount != 0) {
+                            json.attribute("bytes", (int64_t)result.byteCount);
+                            json.attribute("megabytesPerSecond", result.byteCount / result.seconds / 1e6);
+                        }
+                    });
+                }
+            });
+        });
+
+        os << "\n";
+    }
+}
+
+int main(int argc, const char * const * argv) {
+    llvm::cl::ParseCommandLineOptions(argc, argv, "Throughput benchmarks of the juice-lang compiler");
+
+    std::vector<SourceGenerator::Workload> selectedWorkloads(workloads.begin(), workloads.end());
+    if (selectedWorkloads.empty())
+        selectedWorkloads.assign(std::begin(SourceGenerator::allWorkloads), std::end(SourceGenerator::allWorkloads));
+
+    if (iterationCount == 0) iterationCount = 1;
+
+    std::vector<Result> results;
+
+    for (SourceGenerator::Workload workload: selectedWorkloads) {
+        std::string source = SourceGenerator(workload, seed).generate(statementCount);
+
+        if (printSource) {
+            llvm::outs() << source;
+            continue;
+        }
+
+        if (!Benchmark(SourceGenerator::getName(workload), std::move(source)).run(results)) {
+            llvm::errs() << "juice-bench: the generated program of workload '" << SourceGenerator::getName(workload)
+                         << "' is invalid\n";
+            return 1;
+        }
+    }
+
+    if (printSource) return 0;
+
+    std::vector<unsigned int> selectedScopeSizes(scopeSizes.begin(), scopeSizes.end());
+    if (selectedScopeSizes.empty() && workloads.empty())
+        selectedScopeSizes = {1000, 10000, 100000, 1000000};
+
+    for (unsigned int size: selectedScopeSizes)
+        runScopeBenchmark(size, results);
+
+    if (outputFormat == OutputFormat::json) {
+        printJSON(llvm::outs(), results);
+    } else {
+        printText(llvm::outs(), results);
+    }
+
+    return 0;
+}